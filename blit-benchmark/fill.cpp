@@ -0,0 +1,163 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <cstdint>
+
+#include "../draw2d/draw.hpp"
+#include "../draw2d/draw-ex.hpp"
+#include "../draw2d/surface-ex.hpp"
+
+#include "../support/hwcounters.hpp"
+
+// Fill bandwidth: Surface::fill() against draw_rectangle_solid() and the
+// rectangle batches. Bytes are the bytes of pixel data written (4 per pixel),
+// so bytes_per_second is the achieved write bandwidth. Where hardware counters
+// are available, instructions and cache misses per pixel and the IPC are
+// reported as well.
+namespace
+{
+	void fill_surface_( benchmark::State& aState )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		SurfaceEx surface( width, height );
+
+		HwCounters hw;
+		hw.start();
+
+		for( auto _ : aState )
+		{
+			surface.fill( { 32, 64, 128 } );
+			benchmark::ClobberMemory();
+		}
+
+		hw.stop();
+
+		aState.SetBytesProcessed( std::int64_t(width) * height * 4 * aState.iterations() );
+		add_hw_counters( aState, hw, double(width) * height * aState.iterations() );
+	}
+
+	void fill_rectangle_( benchmark::State& aState )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+
+		SurfaceEx surface( width, height );
+
+		HwCounters hw;
+		hw.start();
+
+		for( auto _ : aState )
+		{
+			draw_rectangle_solid( surface, { 0.f, 0.f }, { float(width), float(height) }, { 32, 64, 128 } );
+			benchmark::ClobberMemory();
+		}
+
+		hw.stop();
+
+		aState.SetBytesProcessed( std::int64_t(width) * height * 4 * aState.iterations() );
+		add_hw_counters( aState, hw, double(width) * height * aState.iterations() );
+	}
+
+
+	// UI overlay: aState.range(2) rectangles of 48x24 to 320x80 pixels at
+	// random positions, drawn as one batch.
+	std::vector<ColoredRectangle> make_overlay_( std::uint32_t aWidth, std::uint32_t aHeight, std::size_t aCount )
+	{
+		std::minstd_rand rng( 1234 );
+		std::uniform_real_distribution<float> xdist( 0.f, float(aWidth) );
+		std::uniform_real_distribution<float> ydist( 0.f, float(aHeight) );
+		std::uniform_real_distribution<float> wdist( 48.f, 320.f );
+		std::uniform_real_distribution<float> hdist( 24.f, 80.f );
+
+		std::vector<ColoredRectangle> ret( aCount );
+		for( auto& r : ret )
+		{
+			r.minCorner = Vec2f{ xdist( rng ), ydist( rng ) };
+			r.maxCorner = r.minCorner + Vec2f{ wdist( rng ), hdist( rng ) };
+			r.color = ColorU8_sRGB{ 200, 200, std::uint8_t(rng() % 256) };
+		}
+		return ret;
+	}
+
+	// Pixels written by drawing the batch (including overdraw)
+	template< typename tDraw >
+	std::int64_t count_written_( std::uint32_t aWidth, std::uint32_t aHeight, std::vector<ColoredRectangle> const& aRects, tDraw&& aDraw )
+	{
+		std::int64_t ret = 0;
+
+		SurfaceEx surface( aWidth, aHeight );
+		for( auto const& r : aRects )
+		{
+			surface.clear();
+			aDraw( surface, std::span( &r, 1 ) );
+
+			auto const* ptr = surface.get_surface_ptr();
+			for( std::size_t i = 0; i < std::size_t(aWidth)*aHeight; ++i )
+				ret += (0 != ptr[i*4+0]);
+		}
+
+		return ret;
+	}
+
+	template< typename tDraw >
+	void overlay_( benchmark::State& aState, tDraw&& aDraw )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const rects = make_overlay_( width, height, std::size_t(aState.range(2)) );
+
+		SurfaceEx surface( width, height );
+		surface.clear();
+
+		HwCounters hw;
+		hw.start();
+
+		for( auto _ : aState )
+		{
+			aDraw( surface, rects );
+			benchmark::ClobberMemory();
+		}
+
+		hw.stop();
+
+		auto const pixels = count_written_( width, height, rects, aDraw );
+		aState.SetBytesProcessed( pixels * 4 * aState.iterations() );
+		aState.SetItemsProcessed( rects.size() * aState.iterations() );
+		add_hw_counters( aState, hw, double(pixels) * aState.iterations() );
+	}
+
+	void overlay_solid_( benchmark::State& aState )
+	{
+		overlay_( aState, []( Surface& aSurface, std::span<ColoredRectangle const> aRects ) {
+			draw_rectangles_solid( aSurface, aRects );
+		} );
+	}
+	void overlay_outline_( benchmark::State& aState )
+	{
+		overlay_( aState, []( Surface& aSurface, std::span<ColoredRectangle const> aRects ) {
+			draw_rectangles_outline( aSurface, aRects );
+		} );
+	}
+}
+
+BENCHMARK( fill_surface_ )
+	->Args( { 320, 240 } )
+	->Args( { 1920, 1080 } )
+	->Args( { 7680, 4320 } )
+;
+BENCHMARK( fill_rectangle_ )
+	->Args( { 320, 240 } )
+	->Args( { 1920, 1080 } )
+	->Args( { 7680, 4320 } )
+;
+
+BENCHMARK( overlay_solid_ )
+	->Args( { 1920, 1080, 64 } )
+;
+BENCHMARK( overlay_outline_ )
+	->Args( { 1920, 1080, 64 } )
+;
@@ -0,0 +1,129 @@
+#include <benchmark/benchmark.h>
+
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#include "../draw2d/kernels.hpp"
+#include "../draw2d/surface-ex.hpp"
+
+#include "../support/hwcounters.hpp"
+
+// The span kernels of draw2d (see draw2d/kernels.hpp), once for each
+// instruction set that the CPU supports: kernel_fill/avx2/1920 etc. Each
+// iteration writes every row of a 1920x1080 surface in spans of
+// aState.range(0) pixels, so that short spans (small triangles) show the
+// per-call overhead and long ones the throughput.
+namespace
+{
+	constexpr std::uint32_t kWidth = 1920;
+	constexpr std::uint32_t kHeight = 1080;
+
+	// Selects the kernels of aIsa for the duration of one benchmark
+	struct KernelScope_
+	{
+		explicit KernelScope_( KernelIsa aIsa )
+			: previous( kernels().isa )
+		{
+			select_kernels( aIsa );
+		}
+		~KernelScope_()
+		{
+			select_kernels( previous );
+		}
+
+		KernelIsa previous;
+	};
+
+	template< typename tSpan >
+	void spans_( benchmark::State& aState, KernelIsa aIsa, tSpan&& aSpan )
+	{
+		KernelScope_ scope( aIsa );
+
+		auto const span = std::uint32_t(aState.range(0));
+		auto const spansPerRow = kWidth / span;
+
+		SurfaceEx surface( kWidth, kHeight );
+		surface.clear();
+
+		HwCounters hw;
+		hw.start();
+
+		for( auto _ : aState )
+		{
+			for( std::uint32_t y = 0; y < kHeight; ++y )
+			{
+				for( std::uint32_t i = 0; i < spansPerRow; ++i )
+					aSpan( surface, i * span, y, span );
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		hw.stop();
+
+		auto const pixels = double(spansPerRow) * span * kHeight * aState.iterations();
+		aState.SetItemsProcessed( std::int64_t(pixels) );
+		aState.SetBytesProcessed( std::int64_t(pixels) * 4 );
+		add_hw_counters( aState, hw, pixels );
+	}
+
+	void fill_( benchmark::State& aState, KernelIsa aIsa )
+	{
+		spans_( aState, aIsa, [] ( Surface& aSurface, std::uint32_t aX, std::uint32_t aY, std::uint32_t aCount ) {
+			aSurface.fill_row_srgb( aX, aY, aCount, { 32, 64, 128 } );
+		} );
+	}
+
+	void blit_masked_( benchmark::State& aState, KernelIsa aIsa )
+	{
+		// Source row with every other group of 3 pixels transparent
+		std::vector<std::uint8_t> rgba( kWidth * 4 );
+		for( std::size_t i = 0; i < kWidth; ++i )
+		{
+			rgba[i*4+0] = std::uint8_t(i);
+			rgba[i*4+1] = 128;
+			rgba[i*4+2] = 255;
+			rgba[i*4+3] = (i / 3) % 2 ? 255 : 0;
+		}
+
+		spans_( aState, aIsa, [&rgba] ( Surface& aSurface, std::uint32_t aX, std::uint32_t aY, std::uint32_t aCount ) {
+			aSurface.set_row_srgba_masked( aX, aY, aCount, rgba.data() + std::size_t(aX)*4 );
+		} );
+	}
+
+	void linear_( benchmark::State& aState, KernelIsa aIsa )
+	{
+		// A gradient across the whole row, as in a large interpolated
+		// triangle.
+		ColorF const step{ 1.f / kWidth, 0.5f / kWidth, -1.f / kWidth };
+
+		spans_( aState, aIsa, [&step] ( Surface& aSurface, std::uint32_t aX, std::uint32_t aY, std::uint32_t aCount ) {
+			float const x = float(aX);
+			aSurface.set_row_linear( aX, aY, aCount, ColorF{ x * step.r, 0.25f + x * step.g, 1.f + x * step.b }, step );
+		} );
+	}
+
+	bool register_kernels_()
+	{
+		for( auto const isa : { KernelIsa::generic, KernelIsa::sse2, KernelIsa::avx2, KernelIsa::avx512, KernelIsa::neon } )
+		{
+			if( !kernel_isa_supported( isa ) )
+				continue;
+
+			std::string const suffix = std::string("/") + kernel_isa_name( isa );
+
+			benchmark::RegisterBenchmark( ("kernel_fill" + suffix).c_str(), fill_, isa )
+				->Arg( 8 )->Arg( 64 )->Arg( kWidth );
+			benchmark::RegisterBenchmark( ("kernel_blit_masked" + suffix).c_str(), blit_masked_, isa )
+				->Arg( 8 )->Arg( 64 )->Arg( kWidth );
+			benchmark::RegisterBenchmark( ("kernel_linear" + suffix).c_str(), linear_, isa )
+				->Arg( 8 )->Arg( 64 )->Arg( kWidth );
+		}
+
+		return true;
+	}
+
+	[[maybe_unused]] bool const kRegistered_ = register_kernels_();
+}
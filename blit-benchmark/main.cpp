@@ -2,14 +2,52 @@
 
 #include <algorithm>
 
+#include <cstring>
 #include <cassert>
 
 #include "../draw2d/image.hpp"
 #include "../draw2d/draw-ex.hpp"
 #include "../draw2d/surface-ex.hpp"
 
+#include "../support/hwcounters.hpp"
+
 namespace
 {
+	// Pixels written per iteration, reported as items (in addition to the
+	// approximate bytes). With those, add_hw_counters() gives instructions
+	// and cache misses per pixel, which separate memory-bound blits from
+	// compute-bound ones.
+	//
+	// Pixels [aStart, aStart+aLength) of a row or column that fall into
+	// [0, aSize):
+	std::int64_t blit_span_(std::uint32_t aSize, int aStart, std::uint32_t aLength)
+	{
+		auto const first = std::max(std::int64_t(aStart), std::int64_t(0));
+		auto const last = std::min(std::int64_t(aStart) + aLength, std::int64_t(aSize));
+		return std::max(last - first, std::int64_t(0));
+	}
+
+	std::int64_t blit_pixels_(std::uint32_t aWidth, std::uint32_t aHeight, int aX, int aY, std::uint32_t aImageWidth, std::uint32_t aImageHeight)
+	{
+		return blit_span_(aWidth, aX, aImageWidth) * blit_span_(aHeight, aY, aImageHeight);
+	}
+
+	// blit_masked() skips transparent pixels; count the ones it writes with
+	// the padding byte, which set_pixel_srgb() clears.
+	std::int64_t count_masked_(std::uint32_t aWidth, std::uint32_t aHeight, ImageRGBA const& aImage, Vec2f aPosition)
+	{
+		SurfaceEx surface(aWidth, aHeight);
+		std::memset(surface.get_surface_ptr(), 0xff, std::size_t(aWidth) * aHeight * 4);
+
+		blit_masked(surface, aImage, aPosition);
+
+		std::int64_t ret = 0;
+		auto const *ptr = surface.get_surface_ptr();
+		for (std::size_t i = 0; i < std::size_t(aWidth) * aHeight; ++i)
+			ret += (0 == ptr[i * 4 + 3]);
+		return ret;
+	}
+
 	void default_blit_earth_(benchmark::State &aState)
 	{
 		auto const width = std::uint32_t(aState.range(0));
@@ -21,6 +59,9 @@ namespace
 		auto source = load_image("assets/earth.png");
 		assert(source);
 
+		HwCounters hw;
+		hw.start();
+
 		for (auto _ : aState)
 		{
 			// Make sure as much as possible of the image is visible. The
@@ -34,6 +75,8 @@ namespace
 			benchmark::ClobberMemory();
 		}
 
+		hw.stop();
+
 		// The following enables the benchmarking library to print information
 		// about the memory bandwidth. The total number of bytes processed is
 		// *approximatively* two times the total number of bytes in the blit,
@@ -43,6 +86,10 @@ namespace
 		auto const maxBlitY = std::min(height, source->get_height());
 
 		aState.SetBytesProcessed(2 * maxBlitX * maxBlitY * 4 * aState.iterations());
+
+		auto const pixels = count_masked_(width, height, *source, {500.f, 500.f});
+		aState.SetItemsProcessed(pixels * aState.iterations());
+		add_hw_counters(aState, hw, double(pixels) * aState.iterations());
 	}
 
 	void blit_earth_without_alpha_(benchmark::State &aState)
@@ -61,6 +108,9 @@ namespace
 		int startX = 500;
 		int startY = 500;
 
+		HwCounters hw;
+		hw.start();
+
 		for (auto _ : aState)
 		{
 			for (int y = 0; y < source->get_height(); ++y)
@@ -82,10 +132,16 @@ namespace
 			benchmark::ClobberMemory(); // 防止编译器优化掉 `blit` 操作
 		}
 
+		hw.stop();
+
 		// 计算总处理字节数，忽略 Alpha 通道（只计算 RGB）
 		auto const maxBlitX = std::min(width, source->get_width());
 		auto const maxBlitY = std::min(height, source->get_height());
 		aState.SetBytesProcessed(3 * maxBlitX * maxBlitY * aState.iterations()); // 仅 RGB 通道
+
+		auto const pixels = blit_pixels_(width, height, startX, startY, source->get_width(), source->get_height());
+		aState.SetItemsProcessed(pixels * aState.iterations());
+		add_hw_counters(aState, hw, double(pixels) * aState.iterations());
 	}
 
 	void blit_earth_with_memcpy_(benchmark::State &aState)
@@ -108,6 +164,9 @@ namespace
 		std::uint32_t imageWidth = source->get_width();
 		std::uint32_t imageHeight = source->get_height();
 
+		HwCounters hw;
+		hw.start();
+
 		for (auto _ : aState)
 		{
 			for (std::uint32_t y = 0; y < imageHeight; ++y)
@@ -125,10 +184,17 @@ namespace
 			benchmark::ClobberMemory(); // 防止编译器优化
 		}
 
+		hw.stop();
+
 		// 计算总处理字节数
 		auto const maxBlitX = std::min(width, imageWidth);
 		auto const maxBlitY = std::min(height, imageHeight);
 		aState.SetBytesProcessed(2 * maxBlitX * maxBlitY * 4 * aState.iterations()); // 计入 RGBx (32-bit) 数据
+
+		// memcpy() copies whole rows, without clipping in x
+		auto const pixels = std::int64_t(imageWidth) * blit_span_(height, startY, imageHeight);
+		aState.SetItemsProcessed(pixels * aState.iterations());
+		add_hw_counters(aState, hw, double(pixels) * aState.iterations());
 	}
 
 	void blit_without_alpha_(benchmark::State &aState, std::uint32_t imageWidth, std::uint32_t imageHeight)
@@ -150,6 +216,9 @@ namespace
 		int startX = 500;
 		int startY = 500;
 
+		HwCounters hw;
+		hw.start();
+
 		for (auto _ : aState)
 		{
 			for (std::uint32_t y = 0; y < imageHeight; ++y)
@@ -175,9 +244,15 @@ namespace
 			benchmark::ClobberMemory(); // 防止编译器优化
 		}
 
+		hw.stop();
+
 		auto const maxBlitX = std::min(width, imageWidth);
 		auto const maxBlitY = std::min(height, imageHeight);
 		aState.SetBytesProcessed(3 * maxBlitX * maxBlitY * aState.iterations()); // 仅 RGB 通道
+
+		auto const pixels = blit_pixels_(width, height, startX, startY, imageWidth, imageHeight);
+		aState.SetItemsProcessed(pixels * aState.iterations());
+		add_hw_counters(aState, hw, double(pixels) * aState.iterations());
 	}
 
 	void blit_with_memcpy_(benchmark::State &aState, std::uint32_t imageWidth, std::uint32_t imageHeight)
@@ -200,6 +275,9 @@ namespace
 		int startX = 500;
 		int startY = 500;
 
+		HwCounters hw;
+		hw.start();
+
 		for (auto _ : aState)
 		{
 			// 每次迭代执行 blit 操作
@@ -216,10 +294,17 @@ namespace
 			benchmark::ClobberMemory(); // 防止编译器优化
 		}
 
+		hw.stop();
+
 		// 设置处理的字节数
 		auto const maxBlitX = std::min(width, imageWidth);
 		auto const maxBlitY = std::min(height, imageHeight);
 		aState.SetBytesProcessed(2 * maxBlitX * maxBlitY * 4 * aState.iterations());
+
+		// memcpy() copies whole rows, without clipping in x
+		auto const pixels = std::int64_t(imageWidth) * blit_span_(height, startY, imageHeight);
+		aState.SetItemsProcessed(pixels * aState.iterations());
+		add_hw_counters(aState, hw, double(pixels) * aState.iterations());
 	}
 }
 
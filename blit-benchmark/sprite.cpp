@@ -0,0 +1,200 @@
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <vector>
+#include <numbers>
+#include <algorithm>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../draw2d/shape.hpp"
+#include "../draw2d/sprite.hpp"
+#include "../draw2d/surface-ex.hpp"
+
+#include "../support/random.hpp"
+
+// Compares drawing asteroid-like triangle fans exactly (TriangleFan::draw())
+// with drawing them from a SpriteCache with K pre-rendered rotations.
+//
+// Besides the throughput, the cached benchmarks report how much the result
+// differs from the exact one (at random, non-integer positions and random
+// rotations):
+//  - "mismatch%": percentage of pixels that differ, out of all pixels that
+//    are covered by either result
+//  - "meanerr": mean absolute difference per color channel (0...255) over
+//    the same pixels
+//  - "cacheKiB": memory used by the sprite caches
+namespace
+{
+	constexpr std::size_t kShapeCount = 16;
+
+	// Similar to make_asteroid() in the main program (which isn't part of a
+	// library that the benchmark can link against).
+	TriangleFan make_rock_( Xoshiro128& aRNG, std::size_t aPoints = 18, float aRadius = 30.f )
+	{
+		float const radius = aRNG.normal( aRadius, 5.f );
+		float const squish = aRNG.normal( 1.f, 0.2f );
+		float const base = std::clamp( 0.3f + aRNG.normal( 0.f, 0.2f ), 0.1f, 1.f );
+
+		std::vector<Vec2f> verts{ Vec2f{ 0.f, 0.f } };
+		std::vector<ColorF> colors{ ColorF{ base, base, base } };
+
+		float const step = 2.f*std::numbers::pi_v<float> / aPoints;
+		for( std::size_t i = 0; i < aPoints; ++i )
+		{
+			float const r = radius + aRNG.normal( 0.f, 2.5f );
+			verts.emplace_back( Vec2f{ squish * r * std::cos( i*step ), r * std::sin( i*step ) } );
+
+			float const c = std::clamp( base + aRNG.uniform( -0.05f, 0.05f ), 0.f, 1.f );
+			colors.emplace_back( ColorF{ c, c, c } );
+		}
+
+		return TriangleFan( verts.size(), verts.data(), colors.data() );
+	}
+
+	struct Placement_
+	{
+		Vec2f pos;
+		Mat22f rot;
+	};
+
+	struct Scene_
+	{
+		std::vector<TriangleFan> shapes;
+		std::vector<Placement_> placements;
+	};
+
+	Scene_ make_scene_( std::size_t aCount, std::uint32_t aWidth, std::uint32_t aHeight )
+	{
+		Xoshiro128 rng( 1234 );
+
+		Scene_ ret;
+		for( std::size_t i = 0; i < kShapeCount; ++i )
+			ret.shapes.emplace_back( make_rock_( rng ) );
+
+		for( std::size_t i = 0; i < aCount; ++i )
+		{
+			ret.placements.emplace_back( Placement_{
+				Vec2f{ rng.uniform( 0.f, float(aWidth) ), rng.uniform( 0.f, float(aHeight) ) },
+				make_rotation_2d( rng.uniform( 0.f, 2.f*std::numbers::pi_v<float> ) )
+			} );
+		}
+
+		return ret;
+	}
+
+	void draw_exact_( Surface& aSurface, Scene_ const& aScene )
+	{
+		for( std::size_t i = 0; i < aScene.placements.size(); ++i )
+		{
+			auto const& pl = aScene.placements[i];
+			aScene.shapes[i % kShapeCount].draw( aSurface, pl.rot, pl.pos );
+		}
+	}
+
+	void draw_cached_( Surface& aSurface, Scene_ const& aScene, std::vector<SpriteCache> const& aCaches )
+	{
+		for( std::size_t i = 0; i < aScene.placements.size(); ++i )
+		{
+			auto const& pl = aScene.placements[i];
+			aCaches[i % kShapeCount].draw( aSurface, pl.rot, pl.pos );
+		}
+	}
+
+	void asteroids_exact_( benchmark::State& aState )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const count = std::size_t(aState.range(2));
+
+		SurfaceEx surface( width, height );
+		surface.clear();
+
+		auto const scene = make_scene_( count, width, height );
+
+		for( auto _ : aState )
+		{
+			draw_exact_( surface, scene );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( count * aState.iterations() );
+	}
+
+	void asteroids_sprites_( benchmark::State& aState )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const count = std::size_t(aState.range(2));
+		auto const rotations = std::size_t(aState.range(3));
+
+		auto const scene = make_scene_( count, width, height );
+
+		std::vector<SpriteCache> caches;
+		std::size_t cacheBytes = 0;
+		for( auto const& shape : scene.shapes )
+		{
+			caches.emplace_back( shape, rotations );
+			cacheBytes += caches.back().byte_size();
+		}
+
+		// Quality compared to the exact path
+		SurfaceEx exact( width, height ), cached( width, height );
+		exact.clear();
+		cached.clear();
+
+		draw_exact_( exact, scene );
+		draw_cached_( cached, scene, caches );
+
+		std::size_t covered = 0, mismatched = 0;
+		std::uint64_t errorSum = 0;
+
+		auto const* ep = exact.get_surface_ptr();
+		auto const* cp = cached.get_surface_ptr();
+		for( std::size_t i = 0; i < std::size_t(width)*height; ++i )
+		{
+			auto const* e = ep + i*4;
+			auto const* c = cp + i*4;
+
+			if( !(e[0] | e[1] | e[2] | c[0] | c[1] | c[2]) )
+				continue;
+
+			++covered;
+
+			unsigned const err = unsigned(std::abs( e[0]-c[0] )) + unsigned(std::abs( e[1]-c[1] )) + unsigned(std::abs( e[2]-c[2] ));
+			mismatched += (0 != err);
+			errorSum += err;
+		}
+
+		// Throughput
+		SurfaceEx surface( width, height );
+		surface.clear();
+
+		for( auto _ : aState )
+		{
+			draw_cached_( surface, scene, caches );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( count * aState.iterations() );
+
+		aState.counters["mismatch%"] = covered ? 100.0 * double(mismatched) / double(covered) : 0.0;
+		aState.counters["meanerr"] = covered ? double(errorSum) / double(3*covered) : 0.0;
+		aState.counters["cacheKiB"] = double(cacheBytes) / 1024.0;
+	}
+}
+
+BENCHMARK( asteroids_exact_ )
+	->Args( { 1280, 720, 256 } )
+	->Args( { 7680, 4320, 4096 } )
+;
+
+BENCHMARK( asteroids_sprites_ )
+	->Args( { 1280, 720, 256, 16 } )
+	->Args( { 1280, 720, 256, 32 } )
+	->Args( { 1280, 720, 256, 64 } )
+	->Args( { 1280, 720, 256, 256 } )
+	->Args( { 7680, 4320, 4096, 32 } )
+;
@@ -6,7 +6,10 @@
 // This file is only used in the two benchmarking tasks. Other tasks should not
 // attempt to utilize it or its contents.
 
+#include <span>
+
 #include "forward.hpp"
+#include "color.hpp"
 
 #include "../vmlib/vec2.hpp"
 
@@ -19,4 +22,22 @@ void draw_ex_line_solid(
 void blit_ex_solid( SurfaceEx&, ImageRGBA const&, Vec2f aPosition );
 void blit_ex_memcpy( SurfaceEx&, ImageRGBA const&, Vec2f aPosition );
 
+// Batches of rectangles, e.g., for UI overlays. Each rectangle is drawn
+// exactly as by draw_rectangle_solid() or draw_rectangle_outline(); where
+// rectangles overlap, later ones are drawn over earlier ones.
+struct ColoredRectangle
+{
+	Vec2f minCorner, maxCorner;
+	ColorU8_sRGB color;
+};
+
+void draw_rectangles_solid(
+	Surface&,
+	std::span<ColoredRectangle const>
+);
+void draw_rectangles_outline(
+	Surface&,
+	std::span<ColoredRectangle const>
+);
+
 #endif // DRAW_EX_HPP_ADF54F6D_BF79_48F4_BB63_DACB47B0B960
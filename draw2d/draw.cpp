@@ -1,19 +1,126 @@
 #include "draw.hpp"
 
+#include <vector>
+#include <utility>
 #include <algorithm>
 
 #include <cmath>
+#include <cstdint>
 
+#include "draw-ex.hpp"
+#include "fan.hpp"
+#include "raster.hpp"
 #include "surface.hpp"
 
+#include "../support/profiler.hpp"
+
+namespace
+{
+	// Pixels [x0,x1) x [y0,y1). A rectangle covers the pixels whose centers
+	// lie inside of it, with the min edges inclusive and the max edges
+	// exclusive; this matches the top-left rule of the triangle rasterizers.
+	struct PixelRect_
+	{
+		std::int32_t x0, y0, x1, y1;
+	};
+
+	std::int32_t pixel_bound_(float aValue, std::int32_t aSize) noexcept
+	{
+		// First pixel whose center is at or after aValue, limited to
+		// [-1, aSize+1]. Written such that NaNs end up at the lower limit.
+		float const v = std::ceil(aValue - .5f);
+		if (!(v >= -1.f)) return -1;
+		if (!(v <= float(aSize) + 1.f)) return aSize + 1;
+		return std::int32_t(v);
+	}
+
+	// Not clipped to the surface: bounds of -1 or size+1 mean that that edge
+	// of the rectangle lies outside of the surface.
+	PixelRect_ pixel_rect_(Surface const& aSurface, Vec2f aCornerA, Vec2f aCornerB) noexcept
+	{
+		auto const width = std::int32_t(aSurface.get_width());
+		auto const height = std::int32_t(aSurface.get_height());
+
+		return PixelRect_{
+			pixel_bound_(std::min(aCornerA.x, aCornerB.x), width),
+			pixel_bound_(std::min(aCornerA.y, aCornerB.y), height),
+			pixel_bound_(std::max(aCornerA.x, aCornerB.x), width),
+			pixel_bound_(std::max(aCornerA.y, aCornerB.y), height)
+		};
+	}
+
+	void fill_rect_(Surface& aSurface, PixelRect_ const& aRect, ColorU8_sRGB aColor)
+	{
+		auto const x0 = std::max(aRect.x0, 0);
+		auto const y0 = std::max(aRect.y0, 0);
+		auto const x1 = std::min(aRect.x1, std::int32_t(aSurface.get_width()));
+		auto const y1 = std::min(aRect.y1, std::int32_t(aSurface.get_height()));
+
+		if (x0 >= x1)
+			return;
+
+		for (std::int32_t y = y0; y < y1; ++y)
+			aSurface.fill_row_srgb(x0, y, x1 - x0, aColor);
+	}
+
+	// The outermost pixels of the rectangle: the top and bottom rows as spans,
+	// and the left and right columns in between. Edges that lie outside of
+	// the surface are not drawn.
+	void outline_rect_(Surface& aSurface, PixelRect_ const& aRect, ColorU8_sRGB aColor)
+	{
+		if (aRect.x0 >= aRect.x1 || aRect.y0 >= aRect.y1)
+			return;
+
+		auto const width = std::int32_t(aSurface.get_width());
+		auto const height = std::int32_t(aSurface.get_height());
+
+		auto const top = aRect.y0, bottom = aRect.y1 - 1;
+		auto const left = aRect.x0, right = aRect.x1 - 1;
+
+		auto const x0 = std::max(left, 0), x1 = std::min(right + 1, width);
+		if (x0 < x1)
+		{
+			if (top >= 0 && top < height)
+				aSurface.fill_row_srgb(x0, top, x1 - x0, aColor);
+			if (bottom != top && bottom >= 0 && bottom < height)
+				aSurface.fill_row_srgb(x0, bottom, x1 - x0, aColor);
+		}
+
+		auto const y0 = std::max(top + 1, 0), y1 = std::min(bottom, height);
+		bool const drawLeft = left >= 0 && left < width;
+		bool const drawRight = right != left && right >= 0 && right < width;
+
+		for (std::int32_t y = y0; y < y1; ++y)
+		{
+			if (drawLeft)
+				aSurface.set_pixel_srgb(left, y, aColor);
+			if (drawRight)
+				aSurface.set_pixel_srgb(right, y, aColor);
+		}
+	}
+}
+
 void draw_line_solid(Surface &aSurface, Vec2f aBegin, Vec2f aEnd, ColorU8_sRGB aColor)
 {
+	PROFILE_ZONE("draw_line_solid");
+
 	// Extract integer coordinates of start and end points
 	int x0 = static_cast<int>(aBegin.x);
 	int y0 = static_cast<int>(aBegin.y);
 	int x1 = static_cast<int>(aEnd.x);
 	int y1 = static_cast<int>(aEnd.y);
 
+	// Always draw from the lower to the higher endpoint (by x, then y), so
+	// that a line covers the same pixels in either direction. (Bresenham's
+	// algorithm rounds ties towards the start.) Edges that are shared by
+	// several shapes may then be drawn once, in either direction; see
+	// TriangleFan::draw_wireframe().
+	if (x1 < x0 || (x1 == x0 && y1 < y0))
+	{
+		std::swap(x0, x1);
+		std::swap(y0, y1);
+	}
+
 	// Get screen boundaries
 	int width = aSurface.get_width();
 	int height = aSurface.get_height();
@@ -25,190 +132,400 @@ void draw_line_solid(Surface &aSurface, Vec2f aBegin, Vec2f aEnd, ColorU8_sRGB a
 		return; // Entire line is out of bounds, no need to draw
 	}
 
-	// Bresenham's algorithm variables
-	int dx = std::abs(x1 - x0);
-	int dy = std::abs(y1 - y0);
-	int sx = (x0 < x1) ? 1 : -1;
-	int sy = (y0 < y1) ? 1 : -1;
-	int err = dx - dy;
+	// Bresenham's algorithm. Pixel k (k = 0...dMaj) of the line is k steps
+	// along the major axis, and
+	//
+	//   m(k) = ceil( (2*k*dMin - dMaj) / (2*dMaj) )
+	//
+	// steps along the minor axis. The line is clipped by computing the range
+	// of k for which both coordinates are on the surface; the loop then only
+	// visits those pixels, without any per-pixel bounds checks. Long lines
+	// that mostly lie outside of the surface thus cost only as much as their
+	// visible part.
+	std::int64_t const dx = std::abs(std::int64_t(x1) - x0);
+	std::int64_t const dy = std::abs(std::int64_t(y1) - y0);
+
+	bool const xMajor = dx >= dy;
+	std::int64_t const dMaj = xMajor ? dx : dy;
+	std::int64_t const dMin = xMajor ? dy : dx;
+
+	int const maj0 = xMajor ? x0 : y0, min0 = xMajor ? y0 : x0;
+	int const majStep = xMajor ? (x0 < x1 ? 1 : -1) : (y0 < y1 ? 1 : -1);
+	int const minStep = xMajor ? (y0 < y1 ? 1 : -1) : (x0 < x1 ? 1 : -1);
+	int const majSize = xMajor ? width : height;
+	int const minSize = xMajor ? height : width;
+
+	// Steps along an axis that keep the coordinate in [0, aSize)
+	auto const steps_inside = [](int aStart, int aStep, int aSize) {
+		return aStep > 0
+			? std::pair<std::int64_t, std::int64_t>(-std::int64_t(aStart), std::int64_t(aSize) - 1 - aStart)
+			: std::pair<std::int64_t, std::int64_t>(std::int64_t(aStart) - (aSize - 1), aStart);
+	};
+
+	auto [kBegin, kEnd] = steps_inside(maj0, majStep, majSize);
+	kBegin = std::max(kBegin, std::int64_t(0));
+	kEnd = std::min(kEnd, dMaj);
+
+	auto const [mLo, mHi] = steps_inside(min0, minStep, minSize);
+	if (mLo > dMin || mHi < 0)
+		return;
+
+	if (dMin > 0)
+	{
+		// Floor division; the numerators may be negative.
+		auto const floor_div = [](std::int64_t aNum, std::int64_t aDen) {
+			return aNum / aDen - ((aNum % aDen) < 0 ? 1 : 0);
+		};
+
+		// m(k) >= mLo and m(k) <= mHi, solved for k
+		if (mLo > 0)
+			kBegin = std::max(kBegin, floor_div(2*dMaj*(mLo-1) + dMaj, 2*dMin) + 1);
+		if (mHi < dMin)
+			kEnd = std::min(kEnd, floor_div(2*dMaj*mHi + dMaj, 2*dMin));
+	}
+
+	if (kBegin > kEnd)
+		return;
 
-	// Drawing loop with clipping
-	while (true)
+	// Minor steps before pixel kBegin, and the decision variable
+	//   d = 2*k*dMin - dMaj - 2*dMaj*m(k), which stays in (-2*dMaj, 0].
+	std::int64_t m = 0, d = -dMaj;
+	if (dMin > 0)
 	{
-		// Draw current pixel only if it's within bounds
-		if (x0 >= 0 && x0 < width && y0 >= 0 && y0 < height)
-		{
-			aSurface.set_pixel_srgb(x0, y0, aColor);
-		}
+		std::int64_t const num = 2*kBegin*dMin - dMaj;
+		m = num / (2*dMaj) + ((num % (2*dMaj)) > 0 ? 1 : 0);
+		d = num - 2*dMaj*m;
+	}
 
-		// Check if we've reached the endpoint
-		if (x0 == x1 && y0 == y1)
-			break;
+	for (std::int64_t k = kBegin; k <= kEnd; ++k)
+	{
+		auto const maj = maj0 + majStep * k;
+		auto const min = min0 + minStep * m;
 
-		// Update errors and coordinates
-		int e2 = err * 2;
-		if (e2 > -dy)
-		{
-			err -= dy;
-			x0 += sx;
-		}
-		if (e2 < dx)
+		if (xMajor)
+			aSurface.set_pixel_srgb(Surface::Index(maj), Surface::Index(min), aColor);
+		else
+			aSurface.set_pixel_srgb(Surface::Index(min), Surface::Index(maj), aColor);
+
+		d += 2*dMin;
+		if (d > 0)
 		{
-			err += dx;
-			y0 += sy;
+			++m;
+			d -= 2*dMaj;
 		}
 	}
 }
 
 void draw_triangle_wireframe(Surface &aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aColor)
 {
-	// TODO: your implementation goes here
-	// TODO: your implementation goes here
-	// TODO: your implementation goes here
-
-	// TODO: remove the following when you start your implementation
-	(void)aSurface; // Avoid warnings about unused arguments until the function
-	(void)aP0;		// is properly implemented.
-	(void)aP1;
-	(void)aP2;
-	(void)aColor;
+	// The three edges, each clipped to the surface by draw_line_solid().
+	draw_line_solid(aSurface, aP0, aP1, aColor);
+	draw_line_solid(aSurface, aP1, aP2, aColor);
+	draw_line_solid(aSurface, aP2, aP0, aColor);
 }
 
 void draw_triangle_solid(Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorU8_sRGB aColor)
 {
-    // Step 1: Sort vertices by y-coordinate (ascending order)
-    if (aP0.y > aP1.y) std::swap(aP0, aP1);
-    if (aP0.y > aP2.y) std::swap(aP0, aP2);
-    if (aP1.y > aP2.y) std::swap(aP1, aP2);
-
-    // Step 2: Check for degenerate triangles
-    if ((aP0.y == aP1.y && aP1.y == aP2.y) || (aP0.x == aP1.x && aP1.x == aP2.x)) {
-        // All vertices are collinear, nothing to draw
-        return;
-    }
-
-    // Step 3: Check for zero-area triangles
-    int area = (aP1.x - aP0.x) * (aP2.y - aP0.y) - (aP2.x - aP0.x) * (aP1.y - aP0.y);
-    if (std::abs(area) < 100) {
-        return; // Area is too close to zero, skip drawing
-    }
-
-    int height = aSurface.get_height();
-    int width = aSurface.get_width();
-
-    // Step 4: Define a lambda function for drawing a scanline within bounds
-    auto draw_scanline = [&](int y, int x_start, int x_end) {
-        if (y < 0 || y >= height) return; // Skip out-of-bounds rows
-        x_start = std::max(0, std::min(x_start, width - 1));
-        x_end = std::max(0, std::min(x_end, width - 1));
-        for (int x = x_start; x <= x_end; ++x) {
-            aSurface.set_pixel_srgb(x, y, aColor);
-        }
-    };
-
-    // Step 5: Define a lambda function for linear interpolation of x based on y (using integer arithmetic)
-    auto interpolate_x = [](int y, Vec2f p0, Vec2f p1) -> int {
-        if (p0.y == p1.y) return static_cast<int>(p0.x); // Avoid division by zero for horizontal lines
-        return static_cast<int>(p0.x + (y - p0.y) * (p1.x - p0.x) / (p1.y - p0.y));
-    };
-
-    // Step 6: Handle the whole triangle with a single loop
-    int y_start = static_cast<int>(aP0.y);
-    int y_end = static_cast<int>(aP2.y);
-    
-    for (int y = y_start; y <= y_end; ++y) {
-        int x_start, x_end;
-
-        if (y < static_cast<int>(aP1.y)) {
-            // Lower part (from aP0 to aP1)
-            x_start = interpolate_x(y, aP0, aP2);
-            x_end = interpolate_x(y, aP0, aP1);
-        } else {
-            // Upper part (from aP1 to aP2)
-            x_start = interpolate_x(y, aP0, aP2);
-            x_end = interpolate_x(y, aP1, aP2);
-        }
-
-        // Ensure x_start <= x_end
-        if (x_start > x_end) std::swap(x_start, x_end);
-
-        draw_scanline(y, x_start, x_end);
-    }
+	// The setup snaps the vertices to fixed point (see raster.hpp). Zero-area
+	// triangles and triangles outside of the surface are rejected there; all
+	// others, however thin, are drawn with exact coverage.
+	detail::TriangleSetup tri;
+	if (!detail::setup_triangle(tri, aP0, aP1, aP2, aSurface.get_width(), aSurface.get_height()))
+		return;
+
+	// Rows are filled span by span: row_span() finds the covered pixels of
+	// the row from the edge values at its start, and fill_row_srgb() writes
+	// them with wide stores. No per-pixel tests are needed.
+	std::int64_t row[3] = { tri.edges[0].start, tri.edges[1].start, tri.edges[2].start };
+	for (std::int32_t y = tri.minY; y <= tri.maxY; ++y)
+	{
+		std::int32_t begin, end;
+		if (detail::row_span(tri, row, begin, end))
+			aSurface.fill_row_srgb(begin, y, end - begin + 1, aColor);
+
+		for (int i = 0; i < 3; ++i)
+			row[i] += tri.edges[i].stepY;
+	}
 }
 
 
 void draw_triangle_interp(Surface &aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2, ColorF aC0, ColorF aC1, ColorF aC2)
 {
-    if (aP0.y > aP1.y) std::swap(aP0, aP1);
-    if (aP0.y > aP2.y) std::swap(aP0, aP2);
-    if (aP1.y > aP2.y) std::swap(aP1, aP2);
-
-    int height = aSurface.get_height();
-    int width = aSurface.get_width();
-
-    auto linear_to_srgb = [](float linear) -> uint8_t {
-        return (linear <= 0.0031308f) ? 
-            static_cast<uint8_t>(std::round(linear * 12.92f * 255.f)) : 
-            static_cast<uint8_t>(std::round((1.055f * std::pow(linear, 1.f / 2.4f) - 0.055f) * 255.f));
-    };
-
-    auto barycentric_weights = [&](Vec2f p) -> Vec2f {
-        float denom = (aP1.y - aP2.y) * (aP0.x - aP2.x) + (aP2.x - aP1.x) * (aP0.y - aP2.y);
-        Vec2f weights;
-        weights.x = ((aP1.y - aP2.y) * (p.x - aP2.x) + (aP2.x - aP1.x) * (p.y - aP2.y)) / denom;
-        weights.y = ((aP2.y - aP0.y) * (p.x - aP2.x) + (aP0.x - aP2.x) * (p.y - aP2.y)) / denom;
-        return weights;
-    };
-
-    for (int y = static_cast<int>(std::floor(aP0.y)); y <= static_cast<int>(std::ceil(aP2.y)); ++y) {
-        for (int x = static_cast<int>(std::floor(std::min({aP0.x, aP1.x, aP2.x}))); x <= static_cast<int>(std::ceil(std::max({aP0.x, aP1.x, aP2.x}))); ++x) {
-            if (x < 0 || x >= width || y < 0 || y >= height) continue;
-
-            Vec2f weights = barycentric_weights(Vec2f{ static_cast<float>(x), static_cast<float>(y) });
-            float w2 = 1.0f - weights.x - weights.y;
-
-            if (weights.x >= 0 && weights.y >= 0 && w2 >= 0) {
-                ColorF interpolatedColor = {
-                    weights.x * aC0.r + weights.y * aC1.r + w2 * aC2.r,
-                    weights.x * aC0.g + weights.y * aC1.g + w2 * aC2.g,
-                    weights.x * aC0.b + weights.y * aC1.b + w2 * aC2.b
-                };
-
-                ColorU8_sRGB finalColor{
-                    linear_to_srgb(interpolatedColor.r),
-                    linear_to_srgb(interpolatedColor.g),
-                    linear_to_srgb(interpolatedColor.b)
-                };
-
-                aSurface.set_pixel_srgb(x, y, finalColor);
-            }
-        }
-    }
+	PROFILE_ZONE("draw_triangle_interp");
+
+	// Same setup and coverage as draw_triangle_solid(), so that solid and
+	// interpolated triangles cover exactly the same pixels.
+	detail::TriangleSetup tri;
+	if (!detail::setup_triangle(tri, aP0, aP1, aP2, aSurface.get_width(), aSurface.get_height()))
+		return;
+
+	if (tri.swapped)
+		std::swap(aC1, aC2);
+
+	auto const& e0 = tri.edges[0];
+	auto const& e1 = tri.edges[1];
+	auto const& e2 = tri.edges[2];
+
+	// The barycentric weight of vertex i is (edge value i) / area2. Colors
+	// are interpolated as C2 + l0*(C0-C2) + l1*(C1-C2). The colors at the
+	// start of each row are computed from the exact edge values; along the
+	// row, they are a linear function of x.
+	float const inv = 1.f / float(tri.area2);
+
+	ColorF const d0{ aC0.r - aC2.r, aC0.g - aC2.g, aC0.b - aC2.b };
+	ColorF const d1{ aC1.r - aC2.r, aC1.g - aC2.g, aC1.b - aC2.b };
+
+	float const sx0 = float(e0.stepX) * inv, sx1 = float(e1.stepX) * inv;
+	ColorF const dcdx{
+		sx0 * d0.r + sx1 * d1.r,
+		sx0 * d0.g + sx1 * d1.g,
+		sx0 * d0.b + sx1 * d1.b
+	};
+
+	// Coverage is found span by span, as in draw_triangle_solid(). The
+	// covered pixels of each row are then shaded and converted to sRGB in a
+	// single call to set_row_linear() (see kernels.hpp).
+	std::int64_t row[3] = { e0.start, e1.start, e2.start };
+	for (std::int32_t y = tri.minY; y <= tri.maxY; ++y)
+	{
+		std::int32_t begin, end;
+		if (detail::row_span(tri, row, begin, end))
+		{
+			float const l0 = float(row[0]) * inv, l1 = float(row[1]) * inv;
+			float const dx = float(begin - tri.minX);
+
+			ColorF const first{
+				aC2.r + l0 * d0.r + l1 * d1.r + dx * dcdx.r,
+				aC2.g + l0 * d0.g + l1 * d1.g + dx * dcdx.g,
+				aC2.b + l0 * d0.b + l1 * d1.b + dx * dcdx.b
+			};
+
+			aSurface.set_row_linear(begin, y, end - begin + 1, first, dcdx);
+		}
+
+		for (int i = 0; i < 3; ++i)
+			row[i] += tri.edges[i].stepY;
+	}
 }
 
 
+void draw_triangle_fan_interp(Surface& aSurface, std::size_t aCount, Vec2f const* aVerts, ColorF const* aColors)
+{
+	if (aCount < 3)
+		return;
+
+	// Per-triangle fallback, in the same order as TriangleFan::draw().
+	auto const draw_triangles = [&] {
+		for (std::size_t i = 2; i < aCount; ++i)
+			draw_triangle_interp(aSurface, aVerts[0], aVerts[i-1], aVerts[i], aColors[0], aColors[i-1], aColors[i]);
+
+		auto const last = aCount-1;
+		draw_triangle_interp(aSurface, aVerts[0], aVerts[last], aVerts[1], aColors[0], aColors[last], aColors[1]);
+	};
+
+	// Snap all vertices once. The outer vertices are stored in the order
+	// that makes all triangles clockwise (the winding of setup_triangle()).
+	std::size_t const n = aCount - 1;
+
+	thread_local std::vector<detail::FixedVec> outer;
+	thread_local std::vector<std::size_t> order;
+	outer.resize(n + 1);
+	order.resize(n + 1);
+
+	auto const center = detail::snap_to_fixed(aVerts[0]);
+
+	auto const signed_area2 = [&center](detail::FixedVec const& aA, detail::FixedVec const& aB) {
+		return std::int64_t(aA.x - center.x) * (aB.y - center.y) - std::int64_t(aA.y - center.y) * (aB.x - center.x);
+	};
+
+	bool const reversed = [&] {
+		auto const a = detail::snap_to_fixed(aVerts[1]);
+		auto const b = detail::snap_to_fixed(aVerts[2]);
+		return signed_area2(a, b) < 0;
+	}();
+
+	for (std::size_t k = 0; k < n; ++k)
+	{
+		order[k] = reversed ? n - k : 1 + k;
+		outer[k] = detail::snap_to_fixed(aVerts[order[k]]);
+	}
+	order[n] = order[0];
+	outer[n] = outer[0];
+
+	// The single-pass scan below requires that the triangles tile the plane
+	// around the central vertex exactly once: every triangle must have the
+	// same (non-zero) winding, and their angles at the center must add up to
+	// one full turn. This is true for asteroids and other star-shaped fans.
+	// Each pixel then lies in exactly one sector between two neighbouring
+	// spokes, and only that sector's triangle can cover it. Other fans are
+	// drawn triangle by triangle.
+	for (std::size_t k = 0; k < n; ++k)
+	{
+		if (signed_area2(outer[k], outer[k+1]) <= 0)
+		{
+			draw_triangles();
+			return;
+		}
+	}
+
+	{
+		// Number of sectors that contain the +x direction (the winding
+		// number around the center). Spokes along +x are ambiguous.
+		std::size_t turns = 0;
+		for (std::size_t k = 0; k < n; ++k)
+		{
+			auto const ya = outer[k].y - center.y, yb = outer[k+1].y - center.y;
+			if ((0 == ya && outer[k].x > center.x) || (0 == yb && outer[k+1].x > center.x))
+			{
+				draw_triangles();
+				return;
+			}
+
+			// Clockwise sector k contains +x if spoke k is above the x axis
+			// and spoke k+1 below it (with y pointing down).
+			turns += (ya < 0 && yb > 0);
+		}
+
+		if (1 != turns)
+		{
+			draw_triangles();
+			return;
+		}
+	}
+
+	detail::PixelBox box;
+	{
+		thread_local std::vector<detail::FixedVec> all;
+		all.assign(outer.begin(), outer.end() - 1);
+		all.push_back(center);
+
+		if (!detail::pixel_box(box, all.data(), all.size(), aSurface.get_width(), aSurface.get_height()))
+			return;
+	}
+
+	// Per spoke: the edge from the center to outer vertex k. This is the
+	// spoke edge of triangle k; triangle k-1 uses the same spoke in the
+	// other direction, for which (with the fill rule) the test is exactly
+	// the opposite. Pixel p is therefore in sector k if spoke[k](p) >= 0
+	// and spoke[k+1](p) < 0.
+	//
+	// Per triangle: the rim edge and the color plane. The colors use the
+	// same barycentric weights as draw_triangle_interp().
+	struct Sector
+	{
+		detail::Edge spoke, rim;
+
+		// Rows whose pixel centers lie within the triangle's y range
+		std::int32_t minY, maxY;
+
+		ColorF base, dcdx, dcdy;
+	};
+
+	thread_local std::vector<Sector> sectors;
+	sectors.resize(n);
+
+	for (std::size_t k = 0; k < n; ++k)
+	{
+		auto& sec = sectors[k];
+		sec.spoke = detail::make_edge(center, outer[k], box.minX, box.minY);
+		sec.rim = detail::make_edge(outer[k], outer[k+1], box.minX, box.minY);
+
+		// Triangle (center, outer k, outer k+1): the weight of the center
+		// is rim/area2, the one of outer vertex k is back/area2, where back
+		// is the spoke to outer k+1 in reverse.
+		auto const back = detail::make_edge(outer[k+1], center, box.minX, box.minY);
+		float const inv = 1.f / float(signed_area2(outer[k], outer[k+1]));
+
+		ColorF const& cc = aColors[0];
+		ColorF const& c0 = aColors[order[k]];
+		ColorF const& c1 = aColors[order[k+1]];
+
+		ColorF const dc{ cc.r - c1.r, cc.g - c1.g, cc.b - c1.b };
+		ColorF const d0{ c0.r - c1.r, c0.g - c1.g, c0.b - c1.b };
+
+		auto const plane = [&](float aRim, float aBack) {
+			float const lc = aRim * inv, l0 = aBack * inv;
+			return ColorF{ lc * dc.r + l0 * d0.r, lc * dc.g + l0 * d0.g, lc * dc.b + l0 * d0.b };
+		};
+
+		auto const start = plane(float(sec.rim.start), float(back.start));
+		sec.base = ColorF{ c1.r + start.r, c1.g + start.g, c1.b + start.b };
+		sec.dcdx = plane(float(sec.rim.stepX), float(back.stepX));
+		sec.dcdy = plane(float(sec.rim.stepY), float(back.stepY));
+
+		auto const [lo, hi] = std::minmax({ center.y, outer[k].y, outer[k+1].y });
+		constexpr std::int32_t half = detail::kSubpixelOne / 2;
+		sec.minY = (lo - half + detail::kSubpixelOne - 1) >> detail::kSubpixelBits;
+		sec.maxY = (hi - half) >> detail::kSubpixelBits;
+	}
+
+	// Each sector is the intersection of three half-planes (its two spokes
+	// and its rim), so the pixels of a sector on a row form a single span,
+	// which edge_span() finds exactly. The sectors are disjoint, so each
+	// pixel is written once; the spans are shaded and converted to sRGB by
+	// set_row_linear() (see kernels.hpp), as in draw_triangle_interp().
+	std::int64_t const maxDx = std::int64_t(box.maxX) - box.minX;
+
+	for (std::size_t k = 0; k < n; ++k)
+	{
+		auto const& sec = sectors[k];
+		auto const& after = sectors[k + 1 == n ? 0 : k + 1];
+
+		auto const y0 = std::max(sec.minY, box.minY);
+		auto const y1 = std::min(sec.maxY, box.maxY);
+		if (y0 > y1)
+			continue;
+
+		// In sector k: spoke k >= 0, rim k >= 0 and spoke k+1 < 0, i.e.,
+		// -(spoke k+1) - 1 >= 0 (the values are integers).
+		std::int64_t const dy = y0 - box.minY;
+		std::int64_t row[3] = {
+			sec.spoke.start + dy * sec.spoke.stepY,
+			sec.rim.start + dy * sec.rim.stepY,
+			-(after.spoke.start + dy * after.spoke.stepY) - 1
+		};
+		std::int64_t const stepX[3] = { sec.spoke.stepX, sec.rim.stepX, -after.spoke.stepX };
+		std::int64_t const stepY[3] = { sec.spoke.stepY, sec.rim.stepY, -after.spoke.stepY };
+
+		for (std::int32_t y = y0; y <= y1; ++y)
+		{
+			std::int64_t first, last;
+			if (detail::edge_span(row, stepX, maxDx, first, last))
+			{
+				float const fx = float(first), fy = float(y - box.minY);
+				ColorF const color{
+					sec.base.r + fx * sec.dcdx.r + fy * sec.dcdy.r,
+					sec.base.g + fx * sec.dcdx.g + fy * sec.dcdy.g,
+					sec.base.b + fx * sec.dcdx.b + fy * sec.dcdy.b
+				};
+
+				aSurface.set_row_linear(box.minX + std::int32_t(first), y, std::int32_t(last - first + 1), color, sec.dcdx);
+			}
+
+			for (int i = 0; i < 3; ++i)
+				row[i] += stepY[i];
+		}
+	}
+}
+
 void draw_rectangle_solid(Surface &aSurface, Vec2f aMinCorner, Vec2f aMaxCorner, ColorU8_sRGB aColor)
 {
-	// TODO: your implementation goes here
-	// TODO: your implementation goes here
-	// TODO: your implementation goes here
-
-	// TODO: remove the following when you start your implementation
-	(void)aSurface;	  // Avoid warnings about unused arguments until the function
-	(void)aMinCorner; // is properly implemented.
-	(void)aMaxCorner;
-	(void)aColor;
+	fill_rect_(aSurface, pixel_rect_(aSurface, aMinCorner, aMaxCorner), aColor);
 }
 
 void draw_rectangle_outline(Surface &aSurface, Vec2f aMinCorner, Vec2f aMaxCorner, ColorU8_sRGB aColor)
 {
-	// TODO: your implementation goes here
-	// TODO: your implementation goes here
-	// TODO: your implementation goes here
-
-	// TODO: remove the following when you start your implementation
-	(void)aSurface; // Avoid warnings about unused arguments
-	(void)aMinCorner;
-	(void)aMaxCorner;
-	(void)aColor;
+	outline_rect_(aSurface, pixel_rect_(aSurface, aMinCorner, aMaxCorner), aColor);
+}
+
+void draw_rectangles_solid(Surface& aSurface, std::span<ColoredRectangle const> aRects)
+{
+	for (auto const& r : aRects)
+		fill_rect_(aSurface, pixel_rect_(aSurface, r.minCorner, r.maxCorner), r.color);
+}
+
+void draw_rectangles_outline(Surface& aSurface, std::span<ColoredRectangle const> aRects)
+{
+	for (auto const& r : aRects)
+		outline_rect_(aSurface, pixel_rect_(aSurface, r.minCorner, r.maxCorner), r.color);
 }
@@ -0,0 +1,23 @@
+#ifndef FAN_HPP_6877E505_BDA4_4FAA_AE4F_E6D2F431A777
+#define FAN_HPP_6877E505_BDA4_4FAA_AE4F_E6D2F431A777
+
+#include <cstddef>
+
+#include "forward.hpp"
+#include "color.hpp"
+
+#include "../vmlib/vec2.hpp"
+
+// Triangle fan with per-vertex colors: aVerts[0] is the central vertex, and
+// the triangles are (0, i, i+1) for i = 1...aCount-2, closed by the triangle
+// (0, aCount-1, 1); see TriangleFan. Covers the same pixels as calling
+// draw_triangle_interp() for each of the triangles, but shares the setup
+// between the triangles and writes each pixel once, in one span per row and
+// triangle (with Surface::set_row_linear(), like draw_triangle_interp()).
+void draw_triangle_fan_interp(
+	Surface&,
+	std::size_t aCount,
+	Vec2f const* aVerts, ColorF const* aColors
+);
+
+#endif // FAN_HPP_6877E505_BDA4_4FAA_AE4F_E6D2F431A777
@@ -12,6 +12,7 @@
 #include "surface.hpp"
 
 #include "../support/error.hpp"
+#include "../support/profiler.hpp"
 
 namespace
 {
@@ -51,37 +52,35 @@ std::unique_ptr<ImageRGBA> load_image( char const* aPath )
 
 void blit_masked(Surface& aSurface, ImageRGBA const& aImage, Vec2f aPosition)
 {
-    int startX = static_cast<int>(aPosition.x);
-    int startY = static_cast<int>(aPosition.y);
-
-    int imageWidth = aImage.get_width();
-    int imageHeight = aImage.get_height();
-
-    int surfaceWidth = aSurface.get_width();
-    int surfaceHeight = aSurface.get_height();
-
-    // Go through every pixel of the image
-    for (int y = 0; y < imageHeight; ++y) {
-        for (int x = 0; x < imageWidth; ++x) {
-            // Gets the current pixel color in the image
-            ColorU8_sRGB_Alpha color = aImage.get_pixel(x, y);
-
-            // Skip pixels with an Alpha value less than 128
-            if (color.a < 128) {
-                continue;
-            }
-
-            // Calculate the pixel position on the target Surface
-            int destX = startX + x;
-            int destY = startY + y;
-
-            // Check that the target location is within range of the Surface
-            if (destX >= 0 && destX < surfaceWidth && destY >= 0 && destY < surfaceHeight) {
-                // Set the pixel color on the target Surface, ignoring the Alpha channel
-                aSurface.set_pixel_srgb(destX, destY, {color.r, color.g, color.b});
-            }
-        }
-    }
+	PROFILE_ZONE("blit_masked");
+
+	int const startX = static_cast<int>(aPosition.x);
+	int const startY = static_cast<int>(aPosition.y);
+
+	int const imageWidth = aImage.get_width();
+	int const imageHeight = aImage.get_height();
+
+	int const surfaceWidth = aSurface.get_width();
+	int const surfaceHeight = aSurface.get_height();
+
+	// Clip the image to the surface once; each remaining row is then copied
+	// by set_row_srgba_masked(), which skips pixels with an alpha below 128.
+	int const x0 = std::max(0, -startX);
+	int const x1 = std::min(imageWidth, surfaceWidth - startX);
+	int const y0 = std::max(0, -startY);
+	int const y1 = std::min(imageHeight, surfaceHeight - startY);
+
+	if (x0 >= x1)
+		return;
+
+	for (int y = y0; y < y1; ++y)
+	{
+		aSurface.set_row_srgba_masked(
+			Surface::Index(startX + x0), Surface::Index(startY + y),
+			Surface::Index(x1 - x0),
+			aImage.get_image_ptr() + std::size_t(aImage.get_linear_index(x0, y))*4
+		);
+	}
 }
 
 namespace
@@ -0,0 +1,744 @@
+#include "kernels.hpp"
+
+#include <bit>
+#include <iterator>
+#include <algorithm>
+
+#include <cassert>
+#include <cstring>
+
+// The kernels are written with intrinsics, one version per instruction set.
+// AVX2 and AVX-512 versions are compiled with target attributes (GCC and
+// clang), so that the rest of the program only requires the baseline
+// instruction set of the architecture; they are used only if the CPU
+// supports them (see kernel_isa_supported()).
+//
+// All versions produce exactly the same pixels: they perform the same
+// floating point operations in the same order (draw2d is compiled with
+// -ffp-contract=off, so no version fuses multiplications and additions), and
+// share the same sRGB conversion table.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#	define DRAW2D_KERNELS_X86_ 1
+#else
+#	define DRAW2D_KERNELS_X86_ 0
+#endif
+
+#if defined(__x86_64__) || defined(_M_X64)
+#	define DRAW2D_KERNELS_SSE2_ 1
+#else
+#	define DRAW2D_KERNELS_SSE2_ 0
+#endif
+
+/* Compile-time configuration:
+ * The NEON kernels have not been built and tested on AArch64 hardware yet.
+ * Until they are, AArch64 uses the generic kernels by default. Define
+ * DRAW2D_CFG_NEON_KERNELS=1 to compile the NEON kernels, and run
+ * triangles-test and golden-test to check them against the generic ones.
+ */
+#if !defined(DRAW2D_CFG_NEON_KERNELS)
+#	define DRAW2D_CFG_NEON_KERNELS 0
+#endif
+
+#if DRAW2D_CFG_NEON_KERNELS && (defined(__aarch64__) || defined(_M_ARM64))
+#	define DRAW2D_KERNELS_NEON_ 1
+#else
+#	define DRAW2D_KERNELS_NEON_ 0
+#endif
+
+#if DRAW2D_KERNELS_X86_
+#	include <immintrin.h>
+#elif DRAW2D_KERNELS_SSE2_
+#	include <emmintrin.h>
+#elif DRAW2D_KERNELS_NEON_
+#	include <arm_neon.h>
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+#	define DRAW2D_KERNEL_INLINE_ inline __attribute__((always_inline))
+#else
+#	define DRAW2D_KERNEL_INLINE_ inline
+#endif
+
+#if DRAW2D_KERNELS_X86_
+#	define DRAW2D_TARGET_AVX2_ __attribute__((target("avx2")))
+#	define DRAW2D_TARGET_AVX512_ __attribute__((target("avx2,avx512f")))
+#endif
+
+namespace
+{
+#	if DRAW2D_KERNELS_SSE2_
+	constexpr KernelIsa kBaselineIsa_ = KernelIsa::sse2;
+#	elif DRAW2D_KERNELS_NEON_
+	constexpr KernelIsa kBaselineIsa_ = KernelIsa::neon;
+#	else
+	constexpr KernelIsa kBaselineIsa_ = KernelIsa::generic;
+#	endif
+
+	// Byte 3 of a pixel is the alpha channel in RGBA8 images and the padding
+	// byte in the surface. Loaded as a 32-bit word, it ends up in the top
+	// byte on little endian machines (which includes all of the SIMD
+	// versions below).
+	constexpr bool kLittleEndian_ = std::endian::native == std::endian::little;
+	constexpr unsigned kAlphaShift_ = kLittleEndian_ ? 24 : 0;
+	constexpr std::uint32_t kRgbMask_ = kLittleEndian_ ? 0x00ffffffu : 0xffffff00u;
+
+	/* linear_to_srgb() as a table indexed by the top 16 bits of the value.
+	 *
+	 * Each bucket of the table covers the 2^16 floats with the same top bits,
+	 * an interval of 1/128 relative to its start. linear_to_srgb() increases
+	 * by less than one over such an interval (the tests check this and its
+	 * monotonicity), so a bucket contains at most one threshold, the smallest
+	 * value that converts to the next sRGB value. An entry holds the sRGB value
+	 * at the start of the bucket (bits 17 and up) and the low 16 bits of the
+	 * threshold (bits 0...16; 0x10000 if there is none).
+	 *
+	 * This gives exactly the same results as linear_to_srgb(), without calling
+	 * std::pow(), with a single load per value (a gather in the vector
+	 * versions). Values must be clamped to [low, 1] first; low is the start of
+	 * the last bucket below the first threshold.
+	 */
+	struct SrgbTable_
+	{
+		static constexpr std::uint32_t kBuckets = 0x3f81; // up to 1.f = 0x3f800000
+		static constexpr std::uint32_t kNone = 0x10000;
+
+		float low;
+		std::uint32_t entry[kBuckets];
+	};
+
+	SrgbTable_ make_srgb_table_() noexcept;
+	SrgbTable_ const& srgb_table_() noexcept;
+
+	DRAW2D_KERNEL_INLINE_
+	float clamp_srgb_( float aValue, SrgbTable_ const& aTable ) noexcept
+	{
+		// NaNs fail the comparison and end up as low (which converts to zero).
+		return aValue > aTable.low ? std::min( aValue, 1.f ) : aTable.low;
+	}
+
+	DRAW2D_KERNEL_INLINE_
+	std::uint32_t lookup_srgb_bits_( std::uint32_t aBits, SrgbTable_ const& aTable ) noexcept
+	{
+		std::uint32_t const entry = aTable.entry[aBits >> 16];
+		return (entry >> 17) + ((aBits & 0xffffu) >= (entry & 0x1ffffu) ? 1u : 0u);
+	}
+
+	DRAW2D_KERNEL_INLINE_
+	std::uint32_t lookup_srgb_( float aValue, SrgbTable_ const& aTable ) noexcept
+	{
+		std::uint32_t bits;
+		std::memcpy( &bits, &aValue, sizeof(bits) );
+		return lookup_srgb_bits_( bits, aTable );
+	}
+
+	DRAW2D_KERNEL_INLINE_
+	std::uint32_t pack_rgbx_( std::uint32_t aR, std::uint32_t aG, std::uint32_t aB ) noexcept
+	{
+		std::uint8_t const rgbx[4] = { std::uint8_t(aR), std::uint8_t(aG), std::uint8_t(aB), 0 };
+		std::uint32_t packed;
+		std::memcpy( &packed, rgbx, sizeof(packed) );
+		return packed;
+	}
+
+	// Scalar kernels for pixels aBegin...aEnd-1. These handle the pixels
+	// that remain after the vector loops (and everything in the generic
+	// version).
+	DRAW2D_KERNEL_INLINE_
+	void fill_scalar_( std::uint8_t* aOut, std::uint32_t aBegin, std::uint32_t aEnd, std::uint32_t aPixel ) noexcept
+	{
+		for( std::uint32_t i = aBegin; i < aEnd; ++i )
+			std::memcpy( aOut + std::size_t(i)*4, &aPixel, sizeof(aPixel) );
+	}
+
+	DRAW2D_KERNEL_INLINE_
+	void blit_masked_scalar_( std::uint8_t* aOut, std::uint8_t const* aRgba, std::uint32_t aBegin, std::uint32_t aEnd ) noexcept
+	{
+		for( std::uint32_t i = aBegin; i < aEnd; ++i )
+		{
+			std::uint32_t src;
+			std::memcpy( &src, aRgba + std::size_t(i)*4, sizeof(src) );
+
+			// Alpha >= 128 means that its top bit is set.
+			if( (src >> (kAlphaShift_ + 7)) & 1u )
+			{
+				src &= kRgbMask_;
+				std::memcpy( aOut + std::size_t(i)*4, &src, sizeof(src) );
+			}
+		}
+	}
+
+	DRAW2D_KERNEL_INLINE_
+	void linear_scalar_( std::uint8_t* aOut, std::uint32_t aBegin, std::uint32_t aEnd, ColorF aFirst, ColorF aStep, SrgbTable_ const& aTable ) noexcept
+	{
+		for( std::uint32_t i = aBegin; i < aEnd; ++i )
+		{
+			float const fi = float(std::int32_t(i));
+			std::uint32_t const pixel = pack_rgbx_(
+				lookup_srgb_( clamp_srgb_( aFirst.r + fi * aStep.r, aTable ), aTable ),
+				lookup_srgb_( clamp_srgb_( aFirst.g + fi * aStep.g, aTable ), aTable ),
+				lookup_srgb_( clamp_srgb_( aFirst.b + fi * aStep.b, aTable ), aTable )
+			);
+
+			std::memcpy( aOut + std::size_t(i)*4, &pixel, sizeof(pixel) );
+		}
+	}
+}
+
+// The generic kernels are compiled everywhere: they are the baseline where
+// there is no vector instruction set, and the reference for the other
+// versions (--kernel-isa=generic) where there is.
+namespace
+{
+	namespace generic_
+	{
+		void fill_row( std::uint8_t* aOut, std::uint32_t aCount, std::uint32_t aPixel ) noexcept
+		{
+			fill_scalar_( aOut, 0, aCount, aPixel );
+		}
+
+		void blit_row_masked( std::uint8_t* aOut, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept
+		{
+			blit_masked_scalar_( aOut, aRgba, 0, aCount );
+		}
+
+		void linear_row( std::uint8_t* aOut, std::uint32_t aCount, ColorF aFirst, ColorF aStep ) noexcept
+		{
+			linear_scalar_( aOut, 0, aCount, aFirst, aStep, srgb_table_() );
+		}
+	}
+
+	constexpr Kernels kGenericKernels_{
+		KernelIsa::generic,
+		&generic_::fill_row, &generic_::blit_row_masked, &generic_::linear_row
+	};
+}
+
+#if DRAW2D_KERNELS_SSE2_
+namespace
+{
+	namespace sse2_
+	{
+		void fill_row( std::uint8_t* aOut, std::uint32_t aCount, std::uint32_t aPixel ) noexcept
+		{
+			__m128i const pixel = _mm_set1_epi32( int(aPixel) );
+
+			std::uint32_t i = 0;
+			for( ; i + 4 <= aCount; i += 4 )
+				_mm_storeu_si128( reinterpret_cast<__m128i*>(aOut + std::size_t(i)*4), pixel );
+
+			fill_scalar_( aOut, i, aCount, aPixel );
+		}
+
+		void blit_row_masked( std::uint8_t* aOut, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept
+		{
+			__m128i const rgb = _mm_set1_epi32( int(kRgbMask_) );
+
+			std::uint32_t i = 0;
+			for( ; i + 4 <= aCount; i += 4 )
+			{
+				auto* const out = reinterpret_cast<__m128i*>(aOut + std::size_t(i)*4);
+				__m128i const src = _mm_loadu_si128( reinterpret_cast<__m128i const*>(aRgba + std::size_t(i)*4) );
+				__m128i const dst = _mm_loadu_si128( out );
+
+				// Sign bit = top bit of alpha: all ones for copied pixels.
+				__m128i const mask = _mm_srai_epi32( src, 31 );
+				_mm_storeu_si128( out, _mm_or_si128(
+					_mm_and_si128( mask, _mm_and_si128( src, rgb ) ),
+					_mm_andnot_si128( mask, dst )
+				) );
+			}
+
+			blit_masked_scalar_( aOut, aRgba, i, aCount );
+		}
+
+		void linear_row( std::uint8_t* aOut, std::uint32_t aCount, ColorF aFirst, ColorF aStep ) noexcept
+		{
+			SrgbTable_ const& table = srgb_table_();
+
+			// SSE2 has no gathers. The colors are computed four at a time,
+			// and looked up one by one.
+			__m128 const low = _mm_set1_ps( table.low ), one = _mm_set1_ps( 1.f );
+			__m128i const lanes = _mm_setr_epi32( 0, 1, 2, 3 );
+
+			auto const channel = [&] ( __m128 aFi, float aFirstC, float aStepC ) {
+				__m128 const c = _mm_add_ps( _mm_set1_ps( aFirstC ), _mm_mul_ps( aFi, _mm_set1_ps( aStepC ) ) );
+				return _mm_castps_si128( _mm_min_ps( _mm_max_ps( c, low ), one ) ); // NaN -> low
+			};
+
+			std::uint32_t i = 0;
+			for( ; i + 4 <= aCount; i += 4 )
+			{
+				__m128 const fi = _mm_cvtepi32_ps( _mm_add_epi32( _mm_set1_epi32( int(i) ), lanes ) );
+
+				alignas(16) std::uint32_t r[4], g[4], b[4];
+				_mm_store_si128( reinterpret_cast<__m128i*>(r), channel( fi, aFirst.r, aStep.r ) );
+				_mm_store_si128( reinterpret_cast<__m128i*>(g), channel( fi, aFirst.g, aStep.g ) );
+				_mm_store_si128( reinterpret_cast<__m128i*>(b), channel( fi, aFirst.b, aStep.b ) );
+
+				for( int l = 0; l < 4; ++l )
+				{
+					std::uint32_t const pixel = pack_rgbx_(
+						lookup_srgb_bits_( r[l], table ),
+						lookup_srgb_bits_( g[l], table ),
+						lookup_srgb_bits_( b[l], table )
+					);
+					std::memcpy( aOut + (std::size_t(i)+l)*4, &pixel, sizeof(pixel) );
+				}
+			}
+
+			linear_scalar_( aOut, i, aCount, aFirst, aStep, table );
+		}
+	}
+
+	constexpr Kernels kBaselineKernels_{
+		KernelIsa::sse2,
+		&sse2_::fill_row, &sse2_::blit_row_masked, &sse2_::linear_row
+	};
+}
+#endif // ~ SSE2
+
+#if DRAW2D_KERNELS_X86_
+namespace
+{
+	namespace avx2_
+	{
+		DRAW2D_TARGET_AVX2_
+		void fill_row( std::uint8_t* aOut, std::uint32_t aCount, std::uint32_t aPixel ) noexcept
+		{
+			__m256i const pixel = _mm256_set1_epi32( int(aPixel) );
+
+			std::uint32_t i = 0;
+			for( ; i + 8 <= aCount; i += 8 )
+				_mm256_storeu_si256( reinterpret_cast<__m256i*>(aOut + std::size_t(i)*4), pixel );
+
+			fill_scalar_( aOut, i, aCount, aPixel );
+		}
+
+		DRAW2D_TARGET_AVX2_
+		void blit_row_masked( std::uint8_t* aOut, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept
+		{
+			__m256i const rgb = _mm256_set1_epi32( int(kRgbMask_) );
+
+			std::uint32_t i = 0;
+			for( ; i + 8 <= aCount; i += 8 )
+			{
+				auto* const out = reinterpret_cast<__m256i*>(aOut + std::size_t(i)*4);
+				__m256i const src = _mm256_loadu_si256( reinterpret_cast<__m256i const*>(aRgba + std::size_t(i)*4) );
+				__m256i const dst = _mm256_loadu_si256( out );
+
+				// Sign bit = top bit of alpha: all ones for copied pixels.
+				__m256i const mask = _mm256_srai_epi32( src, 31 );
+				_mm256_storeu_si256( out, _mm256_blendv_epi8( dst, _mm256_and_si256( src, rgb ), mask ) );
+			}
+
+			blit_masked_scalar_( aOut, aRgba, i, aCount );
+		}
+
+		DRAW2D_TARGET_AVX2_ DRAW2D_KERNEL_INLINE_
+		__m256i lookup_srgb_( __m256 aValue, SrgbTable_ const& aTable ) noexcept
+		{
+			__m256i const bits = _mm256_castps_si256( aValue );
+			__m256i const entry = _mm256_i32gather_epi32( reinterpret_cast<int const*>(aTable.entry), _mm256_srli_epi32( bits, 16 ), 4 );
+
+			// low16 >= threshold, i.e., low16 + 1 > threshold: all ones.
+			__m256i const lowBits = _mm256_and_si256( bits, _mm256_set1_epi32( 0xffff ) );
+			__m256i const next = _mm256_cmpgt_epi32(
+				_mm256_add_epi32( lowBits, _mm256_set1_epi32( 1 ) ),
+				_mm256_and_si256( entry, _mm256_set1_epi32( 0x1ffff ) )
+			);
+			return _mm256_sub_epi32( _mm256_srli_epi32( entry, 17 ), next );
+		}
+
+		// Color channel aFirst + aFi*aStep, clamped to [low,1] (NaN -> low),
+		// converted to sRGB.
+		DRAW2D_TARGET_AVX2_ DRAW2D_KERNEL_INLINE_
+		__m256i channel_( __m256 aFi, float aFirst, float aStep, SrgbTable_ const& aTable ) noexcept
+		{
+			__m256 const c = _mm256_add_ps( _mm256_set1_ps( aFirst ), _mm256_mul_ps( aFi, _mm256_set1_ps( aStep ) ) );
+			return lookup_srgb_( _mm256_min_ps( _mm256_max_ps( c, _mm256_set1_ps( aTable.low ) ), _mm256_set1_ps( 1.f ) ), aTable );
+		}
+
+		DRAW2D_TARGET_AVX2_
+		void linear_row( std::uint8_t* aOut, std::uint32_t aCount, ColorF aFirst, ColorF aStep ) noexcept
+		{
+			SrgbTable_ const& table = srgb_table_();
+			__m256i const lanes = _mm256_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7 );
+
+			std::uint32_t i = 0;
+			for( ; i + 8 <= aCount; i += 8 )
+			{
+				__m256 const fi = _mm256_cvtepi32_ps( _mm256_add_epi32( _mm256_set1_epi32( int(i) ), lanes ) );
+
+				__m256i const r = channel_( fi, aFirst.r, aStep.r, table );
+				__m256i const g = channel_( fi, aFirst.g, aStep.g, table );
+				__m256i const b = channel_( fi, aFirst.b, aStep.b, table );
+
+				__m256i const pixels = _mm256_or_si256( r, _mm256_or_si256( _mm256_slli_epi32( g, 8 ), _mm256_slli_epi32( b, 16 ) ) );
+				_mm256_storeu_si256( reinterpret_cast<__m256i*>(aOut + std::size_t(i)*4), pixels );
+			}
+
+			linear_scalar_( aOut, i, aCount, aFirst, aStep, table );
+		}
+	}
+
+	// GCC 12 warns about the intentionally undefined vectors in its own
+	// AVX-512 intrinsics (GCC bug 105593).
+#	if defined(__GNUC__) && !defined(__clang__)
+#		pragma GCC diagnostic push
+#		pragma GCC diagnostic ignored "-Wmaybe-uninitialized"
+#	endif
+
+	namespace avx512_
+	{
+		// AVX-512 has masked loads and stores: the last, partial block of
+		// each row is handled by the vector loop as well.
+		DRAW2D_TARGET_AVX512_ DRAW2D_KERNEL_INLINE_
+		__mmask16 live_( std::uint32_t aI, std::uint32_t aCount ) noexcept
+		{
+			return aCount - aI >= 16 ? __mmask16(0xffff) : __mmask16((1u << (aCount - aI)) - 1);
+		}
+
+		DRAW2D_TARGET_AVX512_
+		void fill_row( std::uint8_t* aOut, std::uint32_t aCount, std::uint32_t aPixel ) noexcept
+		{
+			__m512i const pixel = _mm512_set1_epi32( int(aPixel) );
+
+			for( std::uint32_t i = 0; i < aCount; i += 16 )
+				_mm512_mask_storeu_epi32( aOut + std::size_t(i)*4, live_( i, aCount ), pixel );
+		}
+
+		DRAW2D_TARGET_AVX512_
+		void blit_row_masked( std::uint8_t* aOut, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept
+		{
+			__m512i const rgb = _mm512_set1_epi32( int(kRgbMask_) );
+			__m512i const zero = _mm512_setzero_si512();
+
+			for( std::uint32_t i = 0; i < aCount; i += 16 )
+			{
+				__mmask16 const live = live_( i, aCount );
+				__m512i const src = _mm512_maskz_loadu_epi32( live, aRgba + std::size_t(i)*4 );
+
+				// Sign bit = top bit of alpha. Only the copied pixels are
+				// stored; the destination is never read.
+				__mmask16 const copy = _mm512_mask_cmplt_epi32_mask( live, src, zero );
+				_mm512_mask_storeu_epi32( aOut + std::size_t(i)*4, copy, _mm512_and_si512( src, rgb ) );
+			}
+		}
+
+		DRAW2D_TARGET_AVX512_ DRAW2D_KERNEL_INLINE_
+		__m512i lookup_srgb_( __m512 aValue, SrgbTable_ const& aTable ) noexcept
+		{
+			__m512i const bits = _mm512_castps_si512( aValue );
+			__m512i const entry = _mm512_i32gather_epi32( _mm512_srli_epi32( bits, 16 ), aTable.entry, 4 );
+
+			__m512i const base = _mm512_srli_epi32( entry, 17 );
+			__mmask16 const next = _mm512_cmpge_epu32_mask(
+				_mm512_and_si512( bits, _mm512_set1_epi32( 0xffff ) ),
+				_mm512_and_si512( entry, _mm512_set1_epi32( 0x1ffff ) )
+			);
+			return _mm512_mask_add_epi32( base, next, base, _mm512_set1_epi32( 1 ) );
+		}
+
+		DRAW2D_TARGET_AVX512_ DRAW2D_KERNEL_INLINE_
+		__m512i channel_( __m512 aFi, float aFirst, float aStep, SrgbTable_ const& aTable ) noexcept
+		{
+			__m512 const c = _mm512_add_ps( _mm512_set1_ps( aFirst ), _mm512_mul_ps( aFi, _mm512_set1_ps( aStep ) ) );
+			return lookup_srgb_( _mm512_min_ps( _mm512_max_ps( c, _mm512_set1_ps( aTable.low ) ), _mm512_set1_ps( 1.f ) ), aTable );
+		}
+
+		DRAW2D_TARGET_AVX512_
+		void linear_row( std::uint8_t* aOut, std::uint32_t aCount, ColorF aFirst, ColorF aStep ) noexcept
+		{
+			SrgbTable_ const& table = srgb_table_();
+			__m512i const lanes = _mm512_setr_epi32( 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 );
+
+			for( std::uint32_t i = 0; i < aCount; i += 16 )
+			{
+				__m512 const fi = _mm512_cvtepi32_ps( _mm512_add_epi32( _mm512_set1_epi32( int(i) ), lanes ) );
+
+				__m512i const r = channel_( fi, aFirst.r, aStep.r, table );
+				__m512i const g = channel_( fi, aFirst.g, aStep.g, table );
+				__m512i const b = channel_( fi, aFirst.b, aStep.b, table );
+
+				__m512i const pixels = _mm512_or_si512( r, _mm512_or_si512( _mm512_slli_epi32( g, 8 ), _mm512_slli_epi32( b, 16 ) ) );
+				_mm512_mask_storeu_epi32( aOut + std::size_t(i)*4, live_( i, aCount ), pixels );
+			}
+		}
+	}
+
+#	if defined(__GNUC__) && !defined(__clang__)
+#		pragma GCC diagnostic pop
+#	endif
+
+	constexpr Kernels kAvx2Kernels_{
+		KernelIsa::avx2,
+		&avx2_::fill_row, &avx2_::blit_row_masked, &avx2_::linear_row
+	};
+	constexpr Kernels kAvx512Kernels_{
+		KernelIsa::avx512,
+		&avx512_::fill_row, &avx512_::blit_row_masked, &avx512_::linear_row
+	};
+}
+#endif // ~ AVX2, AVX-512
+
+#if DRAW2D_KERNELS_NEON_
+namespace
+{
+	namespace neon_
+	{
+		void fill_row( std::uint8_t* aOut, std::uint32_t aCount, std::uint32_t aPixel ) noexcept
+		{
+			uint8x16_t const pixel = vreinterpretq_u8_u32( vdupq_n_u32( aPixel ) );
+
+			std::uint32_t i = 0;
+			for( ; i + 4 <= aCount; i += 4 )
+				vst1q_u8( aOut + std::size_t(i)*4, pixel );
+
+			fill_scalar_( aOut, i, aCount, aPixel );
+		}
+
+		void blit_row_masked( std::uint8_t* aOut, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept
+		{
+			uint32x4_t const rgb = vdupq_n_u32( kRgbMask_ );
+
+			std::uint32_t i = 0;
+			for( ; i + 4 <= aCount; i += 4 )
+			{
+				uint32x4_t const src = vreinterpretq_u32_u8( vld1q_u8( aRgba + std::size_t(i)*4 ) );
+				uint32x4_t const dst = vreinterpretq_u32_u8( vld1q_u8( aOut + std::size_t(i)*4 ) );
+
+				// Sign bit = top bit of alpha: all ones for copied pixels.
+				uint32x4_t const mask = vreinterpretq_u32_s32( vshrq_n_s32( vreinterpretq_s32_u32( src ), 31 ) );
+				uint32x4_t const res = vbslq_u32( mask, vandq_u32( src, rgb ), dst );
+				vst1q_u8( aOut + std::size_t(i)*4, vreinterpretq_u8_u32( res ) );
+			}
+
+			blit_masked_scalar_( aOut, aRgba, i, aCount );
+		}
+
+		void linear_row( std::uint8_t* aOut, std::uint32_t aCount, ColorF aFirst, ColorF aStep ) noexcept
+		{
+			SrgbTable_ const& table = srgb_table_();
+
+			// NEON has no gathers. The colors are computed four at a time,
+			// and looked up one by one.
+			float32x4_t const low = vdupq_n_f32( table.low ), one = vdupq_n_f32( 1.f );
+			std::uint32_t const laneInit[4] = { 0, 1, 2, 3 };
+			uint32x4_t const lanes = vld1q_u32( laneInit );
+
+			auto const channel = [&] ( float32x4_t aFi, float aFirstC, float aStepC ) {
+				float32x4_t const c = vaddq_f32( vdupq_n_f32( aFirstC ), vmulq_f32( aFi, vdupq_n_f32( aStepC ) ) );
+				// vmaxnmq_f32() returns the number if the other value is NaN
+				return vreinterpretq_u32_f32( vminq_f32( vmaxnmq_f32( c, low ), one ) );
+			};
+
+			std::uint32_t i = 0;
+			for( ; i + 4 <= aCount; i += 4 )
+			{
+				float32x4_t const fi = vcvtq_f32_u32( vaddq_u32( vdupq_n_u32( i ), lanes ) );
+
+				std::uint32_t r[4], g[4], b[4];
+				vst1q_u32( r, channel( fi, aFirst.r, aStep.r ) );
+				vst1q_u32( g, channel( fi, aFirst.g, aStep.g ) );
+				vst1q_u32( b, channel( fi, aFirst.b, aStep.b ) );
+
+				for( int l = 0; l < 4; ++l )
+				{
+					std::uint32_t const pixel = pack_rgbx_(
+						lookup_srgb_bits_( r[l], table ),
+						lookup_srgb_bits_( g[l], table ),
+						lookup_srgb_bits_( b[l], table )
+					);
+					std::memcpy( aOut + (std::size_t(i)+l)*4, &pixel, sizeof(pixel) );
+				}
+			}
+
+			linear_scalar_( aOut, i, aCount, aFirst, aStep, table );
+		}
+	}
+
+	constexpr Kernels kBaselineKernels_{
+		KernelIsa::neon,
+		&neon_::fill_row, &neon_::blit_row_masked, &neon_::linear_row
+	};
+}
+#endif // ~ NEON
+
+#if !DRAW2D_KERNELS_SSE2_ && !DRAW2D_KERNELS_NEON_
+namespace
+{
+	constexpr Kernels const& kBaselineKernels_ = kGenericKernels_;
+}
+#endif // ~ generic baseline
+
+namespace
+{
+	Kernels const* kernels_for_( KernelIsa aIsa ) noexcept
+	{
+		if( KernelIsa::generic == aIsa )
+			return &kGenericKernels_;
+		if( kBaselineIsa_ == aIsa )
+			return &kBaselineKernels_;
+
+#		if DRAW2D_KERNELS_X86_
+		if( KernelIsa::avx2 == aIsa )
+			return &kAvx2Kernels_;
+		if( KernelIsa::avx512 == aIsa )
+			return &kAvx512Kernels_;
+#		endif // ~ DRAW2D_KERNELS_X86_
+
+		return nullptr;
+	}
+
+	constexpr char const* kIsaNames_[] = {
+		"auto", "generic", "sse2", "avx2", "avx512", "neon"
+	};
+}
+
+
+namespace detail
+{
+	// Constant-initialized, so that the baseline kernels are in place even
+	// before the selection at startup (below) has run.
+	std::atomic<Kernels const*> gKernels{ &kBaselineKernels_ };
+}
+
+namespace
+{
+	[[maybe_unused]] bool const kSelectedAtStartup_ = select_kernels( KernelIsa::automatic );
+}
+
+
+bool select_kernels( KernelIsa aIsa ) noexcept
+{
+	if( KernelIsa::automatic == aIsa )
+		aIsa = best_kernel_isa();
+
+	auto const* table = kernels_for_( aIsa );
+	if( !table || !kernel_isa_supported( aIsa ) )
+		return false;
+
+	detail::gKernels.store( table, std::memory_order_relaxed );
+	return true;
+}
+
+bool kernel_isa_supported( KernelIsa aIsa ) noexcept
+{
+	if( KernelIsa::automatic == aIsa || KernelIsa::generic == aIsa || kBaselineIsa_ == aIsa )
+		return true;
+
+#	if DRAW2D_KERNELS_X86_
+	// May run before the static constructor that normally initializes the
+	// CPU data for __builtin_cpu_supports() (see kSelectedAtStartup_).
+	__builtin_cpu_init();
+
+	if( KernelIsa::avx2 == aIsa )
+		return __builtin_cpu_supports( "avx2" );
+	if( KernelIsa::avx512 == aIsa )
+		return __builtin_cpu_supports( "avx512f" );
+#	endif // ~ DRAW2D_KERNELS_X86_
+
+	return false;
+}
+
+KernelIsa best_kernel_isa() noexcept
+{
+	for( auto const isa : { KernelIsa::avx512, KernelIsa::avx2 } )
+	{
+		if( kernels_for_( isa ) && kernel_isa_supported( isa ) )
+			return isa;
+	}
+
+	return kBaselineIsa_;
+}
+
+char const* kernel_isa_name( KernelIsa aIsa ) noexcept
+{
+	auto const index = std::size_t(aIsa);
+	return index < std::size(kIsaNames_) ? kIsaNames_[index] : "unknown";
+}
+
+bool parse_kernel_isa( char const* aName, KernelIsa& aIsa ) noexcept
+{
+	for( std::size_t i = 0; i < std::size(kIsaNames_); ++i )
+	{
+		if( 0 == std::strcmp( aName, kIsaNames_[i] ) )
+		{
+			aIsa = KernelIsa(i);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+
+namespace
+{
+	SrgbTable_ make_srgb_table_() noexcept
+	{
+		auto const to_bits = [] ( float aValue ) {
+			std::uint32_t bits;
+			std::memcpy( &bits, &aValue, sizeof(bits) );
+			return bits;
+		};
+		auto const from_bits = [] ( std::uint32_t aBits ) {
+			float value;
+			std::memcpy( &value, &aBits, sizeof(value) );
+			return value;
+		};
+
+		// Thresholds: element k is the bit pattern of the smallest value in
+		// [0,1] that converts to k or more. Non-negative floats are ordered
+		// like their bit patterns, so each threshold is found by a binary
+		// search over the bit patterns in [0,1]. The thresholds are
+		// increasing; each search starts at the previous one.
+		std::uint32_t thresholds[257];
+		thresholds[0] = 0;
+		thresholds[256] = ~std::uint32_t(0);
+
+		std::uint32_t lo = 0;
+		for( unsigned k = 1; k < 256; ++k )
+		{
+			std::uint32_t hi = to_bits( 1.f );
+			while( lo < hi )
+			{
+				auto const mid = lo + (hi - lo) / 2;
+				if( linear_to_srgb( from_bits( mid ) ) >= k )
+					hi = mid;
+				else
+					lo = mid + 1;
+			}
+
+			thresholds[k] = lo;
+		}
+
+		// Buckets from the one before the first threshold up to 1.f.
+		SrgbTable_ ret{};
+
+		std::uint32_t const first = (thresholds[1] >> 16) - 1;
+		ret.low = from_bits( first << 16 );
+
+		std::uint32_t base = 0;
+		for( std::uint32_t bucket = first; bucket < SrgbTable_::kBuckets; ++bucket )
+		{
+			auto const start = bucket << 16, end = (bucket + 1) << 16;
+			while( thresholds[base+1] <= start )
+				++base;
+
+			auto const next = thresholds[base+1];
+			assert( base + 2 > 255 || thresholds[base+2] >= end );
+
+			auto const lowBits = next < end ? next & 0xffffu : SrgbTable_::kNone;
+			ret.entry[bucket] = (base << 17) | lowBits;
+		}
+
+		return ret;
+	}
+
+	SrgbTable_ const& srgb_table_() noexcept
+	{
+		static SrgbTable_ const table = make_srgb_table_();
+		return table;
+	}
+}
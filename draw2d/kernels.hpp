@@ -0,0 +1,92 @@
+#ifndef KERNELS_HPP_DCA8087D_41E6_40E3_9E3D_CC0A114C5C41
+#define KERNELS_HPP_DCA8087D_41E6_40E3_9E3D_CC0A114C5C41
+
+// Span kernels of the draw2d rasterizers, compiled for several instruction
+// sets and selected at runtime.
+//
+// The kernels write whole runs of pixels; the surrounding setup, clipping and
+// coverage computations are scalar and do not depend on the instruction set.
+// All variants of a kernel produce exactly the same pixels.
+
+#include <atomic>
+
+#include <cstdint>
+
+#include "color.hpp"
+
+/* Instruction sets that the kernels are compiled for. The generic (scalar)
+ * kernels and the baseline of the target architecture (sse2 on x86-64,
+ * generic elsewhere) are always available. avx2 and avx512 (AVX-512F) are
+ * compiled on x86 with GCC and clang, and are used if the CPU supports them.
+ * neon is compiled on AArch64 only with DRAW2D_CFG_NEON_KERNELS (see
+ * kernels.cpp).
+ *
+ * automatic picks the best instruction set that the CPU supports.
+ */
+enum class KernelIsa
+{
+	automatic,
+	generic,
+	sse2,
+	avx2,
+	avx512,
+	neon
+};
+
+/** Kernels - table of the kernels for one instruction set
+ *
+ * Pixels are in the Surface format (sRGB, RGBx8 with a zero padding byte).
+ * aOut points to the first pixel of the run. Use the Surface row functions
+ * (fill_row_srgb(), set_row_srgba_masked(), set_row_linear()) rather than
+ * calling these directly.
+ */
+struct Kernels
+{
+	KernelIsa isa;
+
+	// Set aCount pixels to aPixel (one packed RGBx8 pixel)
+	void (*fillRow)( std::uint8_t* aOut, std::uint32_t aCount, std::uint32_t aPixel ) noexcept;
+
+	// Copy those of aCount RGBA8 pixels whose alpha is at least 128; the
+	// others leave the destination unchanged.
+	void (*blitRowMasked)( std::uint8_t* aOut, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept;
+
+	// Set pixel i of aCount pixels to the linear color aFirst + i*aStep,
+	// clamped to [0,1] and converted with linear_to_srgb(). Used by
+	// draw_triangle_interp() and draw_triangle_fan_interp().
+	void (*linearRow)( std::uint8_t* aOut, std::uint32_t aCount, ColorF aFirst, ColorF aStep ) noexcept;
+};
+
+/* The active kernels. At startup, these are the kernels of the best
+ * instruction set that the CPU supports; select_kernels() overrides this.
+ */
+Kernels const& kernels() noexcept;
+
+/* Switches to the kernels of aIsa. Returns false (and keeps the current
+ * kernels) if the CPU does not support aIsa or the kernels were not compiled
+ * for it. Intended for startup and for benchmarks: do not switch while other
+ * threads are drawing.
+ */
+bool select_kernels( KernelIsa aIsa ) noexcept;
+
+bool kernel_isa_supported( KernelIsa ) noexcept;
+KernelIsa best_kernel_isa() noexcept;
+
+// Names as accepted by --kernel-isa= ("auto", "generic", "sse2", "avx2",
+// "avx512", "neon").
+char const* kernel_isa_name( KernelIsa ) noexcept;
+bool parse_kernel_isa( char const* aName, KernelIsa& aIsa ) noexcept;
+
+
+namespace detail
+{
+	extern std::atomic<Kernels const*> gKernels;
+}
+
+inline
+Kernels const& kernels() noexcept
+{
+	return *detail::gKernels.load( std::memory_order_relaxed );
+}
+
+#endif // KERNELS_HPP_DCA8087D_41E6_40E3_9E3D_CC0A114C5C41
@@ -0,0 +1,57 @@
+#include "overdraw.hpp"
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <stb_image_write.h>
+
+// write_heatmap() is kept apart from the counting in overdraw.cpp: the
+// programs that only draw (e.g., the tests) do not link against stb.
+namespace
+{
+	struct Stop_
+	{
+		float writes;
+		float r, g, b;
+	};
+
+	constexpr Stop_ kStops_[] = {
+		{ 0.f,   0.f,   0.f,   0.f },
+		{ 1.f,   0.f,   0.f, 255.f },
+		{ 2.f,   0.f, 255.f, 255.f },
+		{ 3.f,   0.f, 255.f,   0.f },
+		{ 4.f, 255.f, 255.f,   0.f },
+		{ 6.f, 255.f,   0.f,   0.f },
+		{ 8.f, 255.f, 255.f, 255.f }
+	};
+}
+
+bool OverdrawStats::write_heatmap( char const* aPath ) const
+{
+	if( mCounts.empty() )
+		return false;
+
+	auto const frames = float(std::max<std::uint64_t>( 1, mTotals.frames ));
+
+	std::vector<std::uint8_t> rgb( mCounts.size() * 3 );
+	for( std::size_t i = 0; i < mCounts.size(); ++i )
+	{
+		float const writes = std::min( float(mCounts[i]) / frames, kStops_[std::size(kStops_)-1].writes );
+
+		// Linear interpolation between the two surrounding stops
+		std::size_t s = 1;
+		while( s + 1 < std::size(kStops_) && writes > kStops_[s].writes )
+			++s;
+
+		auto const& a = kStops_[s-1];
+		auto const& b = kStops_[s];
+		float const t = std::clamp( (writes - a.writes) / (b.writes - a.writes), 0.f, 1.f );
+
+		rgb[i*3+0] = std::uint8_t(a.r + t * (b.r - a.r) + .5f);
+		rgb[i*3+1] = std::uint8_t(a.g + t * (b.g - a.g) + .5f);
+		rgb[i*3+2] = std::uint8_t(a.b + t * (b.b - a.b) + .5f);
+	}
+
+	return 0 != stbi_write_png( aPath, int(mWidth), int(mHeight), 3, rgb.data(), int(mWidth) * 3 );
+}
@@ -0,0 +1,165 @@
+#include "overdraw.hpp"
+
+#include <iterator>
+#include <algorithm>
+
+#include <cassert>
+
+#include "surface.hpp"
+
+namespace
+{
+	constexpr char const* kCategoryNames_[] = {
+		"clear", "pixels", "points", "solid spans", "interp. spans", "masked blits", "row copies"
+	};
+	static_assert( std::size(kCategoryNames_) == std::size_t(OverdrawCategory::count) );
+
+	void add_( OverdrawStats::Totals& aTotals, OverdrawStats::Totals const& aOther ) noexcept
+	{
+		for( std::size_t i = 0; i < std::size_t(OverdrawCategory::count); ++i )
+			aTotals.writes[i] += aOther.writes[i];
+
+		aTotals.pixelsWritten += aOther.pixelsWritten;
+		aTotals.frames += aOther.frames;
+	}
+}
+
+char const* overdraw_category_name( OverdrawCategory aCategory ) noexcept
+{
+	auto const index = std::size_t(aCategory);
+	return index < std::size(kCategoryNames_) ? kCategoryNames_[index] : "unknown";
+}
+
+
+OverdrawStats::~OverdrawStats()
+{
+	if( this == detail::tActiveOverdraw )
+		detail::tActiveOverdraw = nullptr;
+}
+
+void OverdrawStats::begin_frame( Surface const& aSurface )
+{
+	assert( !detail::tActiveOverdraw );
+
+	if( aSurface.get_width() != mWidth || aSurface.get_height() != mHeight )
+	{
+		mWidth = aSurface.get_width();
+		mHeight = aSurface.get_height();
+
+		mFrameCounts.assign( std::size_t(mWidth) * mHeight, 0 );
+		mCounts.assign( std::size_t(mWidth) * mHeight, 0 );
+		mTotals = Totals{};
+	}
+	else
+	{
+		std::fill( mFrameCounts.begin(), mFrameCounts.end(), 0 );
+	}
+
+	mSurface = &aSurface;
+	mFrame = Totals{};
+	mFrame.frames = 1;
+
+	detail::tActiveOverdraw = this;
+}
+
+void OverdrawStats::end_frame() noexcept
+{
+	assert( this == detail::tActiveOverdraw );
+	detail::tActiveOverdraw = nullptr;
+
+	for( std::size_t i = 0; i < mFrameCounts.size(); ++i )
+	{
+		mFrame.pixelsWritten += (0 != mFrameCounts[i]);
+		mCounts[i] += mFrameCounts[i];
+	}
+
+	add_( mTotals, mFrame );
+	mSurface = nullptr;
+}
+
+void OverdrawStats::reset() noexcept
+{
+	std::fill( mCounts.begin(), mCounts.end(), 0 );
+	mTotals = Totals{};
+}
+
+auto OverdrawStats::totals() const noexcept -> Totals const&
+{
+	return mTotals;
+}
+auto OverdrawStats::last_frame() const noexcept -> Totals const&
+{
+	return mFrame;
+}
+
+std::uint64_t OverdrawStats::pixel_writes( std::uint32_t aX, std::uint32_t aY ) const noexcept
+{
+	assert( aX < mWidth && aY < mHeight );
+	return mCounts[std::size_t(aY) * mWidth + aX];
+}
+
+void OverdrawStats::print( std::FILE* aOut, char const* aTitle ) const
+{
+	auto const frames = double(std::max<std::uint64_t>( 1, mTotals.frames ));
+
+	std::uint64_t drawn = 0;
+	for( std::size_t i = 0; i < std::size_t(OverdrawCategory::count); ++i )
+	{
+		if( std::size_t(OverdrawCategory::clear) != i )
+			drawn += mTotals.writes[i];
+	}
+
+	std::fprintf( aOut, "%s: %llu frames at %ux%u\n", aTitle, (unsigned long long)mTotals.frames, mWidth, mHeight );
+	std::fprintf( aOut, "  %-14s %14s %8s\n", "category", "writes/frame", "share" );
+
+	for( std::size_t i = 0; i < std::size_t(OverdrawCategory::count); ++i )
+	{
+		auto const writes = mTotals.writes[i];
+		bool const isClear = std::size_t(OverdrawCategory::clear) == i;
+		std::fprintf( aOut, "  %-14s %14.0f %7.1f%%\n",
+			kCategoryNames_[i],
+			double(writes) / frames,
+			(!isClear && drawn) ? 100.0 * double(writes) / double(drawn) : 0.0
+		);
+	}
+
+	double const pixels = double(mWidth) * mHeight;
+	double const written = double(mTotals.pixelsWritten) / frames;
+	std::fprintf( aOut, "  drawn pixels/frame %.0f (%.1f%% of the surface), %.2f writes per drawn pixel\n",
+		written,
+		pixels > 0.0 ? 100.0 * written / pixels : 0.0,
+		mTotals.pixelsWritten ? double(drawn) / double(mTotals.pixelsWritten) : 0.0
+	);
+}
+
+
+void OverdrawStats::count_( OverdrawCategory aCategory, std::uint32_t aIndex, std::uint32_t aCount ) noexcept
+{
+	mFrame.writes[std::size_t(aCategory)] += aCount;
+
+	// clear() and fill() write every pixel exactly once per call; leaving
+	// them out of the per-pixel counts keeps the heatmap about drawing.
+	if( OverdrawCategory::clear == aCategory )
+		return;
+
+	assert( std::size_t(aIndex) + aCount <= mFrameCounts.size() );
+	for( std::uint32_t i = 0; i < aCount; ++i )
+		++mFrameCounts[aIndex + i];
+}
+
+void OverdrawStats::count_masked_( std::uint32_t aIndex, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept
+{
+	assert( std::size_t(aIndex) + aCount <= mFrameCounts.size() );
+
+	std::uint32_t written = 0;
+	for( std::uint32_t i = 0; i < aCount; ++i )
+	{
+		if( aRgba[std::size_t(i)*4 + 3] >= 128 )
+		{
+			++mFrameCounts[aIndex + i];
+			++written;
+		}
+	}
+
+	mFrame.writes[std::size_t(OverdrawCategory::maskedBlit)] += written;
+}
@@ -0,0 +1,170 @@
+#ifndef OVERDRAW_HPP_7C2000F0_380B_46F6_A902_36BB5645A494
+#define OVERDRAW_HPP_7C2000F0_380B_46F6_A902_36BB5645A494
+
+#include <vector>
+
+#include <cstdio>
+#include <cstdint>
+
+#include "forward.hpp"
+
+/* Compile-time configuration:
+ * With DRAW2D_CFG_OVERDRAW enabled, each Surface function that writes pixels
+ * reports the pixels it wrote to the active OverdrawStats (if any). This
+ * costs a branch per write call even if no statistics are being collected,
+ * and a loop over the written pixels if they are. Without it, OverdrawStats
+ * still exists but never counts anything. Enable it with
+ *
+ *   premake5 gmake2 --overdraw
+ *
+ * (or define DRAW2D_CFG_OVERDRAW=1 for all projects by other means).
+ */
+#if !defined(DRAW2D_CFG_OVERDRAW)
+#	define DRAW2D_CFG_OVERDRAW 0
+#endif
+
+constexpr bool kOverdrawEnabled = (0 != DRAW2D_CFG_OVERDRAW);
+
+/* Categories of pixel writes. Each corresponds to one kind of Surface write
+ * function, and thereby to the draw calls that use it.
+ */
+enum class OverdrawCategory
+{
+	clear,       // clear(), fill()
+	pixels,      // set_pixel_srgb(): lines, fans, single pixels
+	points,      // draw_points(): particle fields
+	solidSpans,  // fill_row_srgb(): solid triangles, rectangles
+	interpSpans, // set_row_linear(): interpolated triangles
+	maskedBlit,  // set_row_srgba_masked(): blit_masked(), e.g., the earth
+	rowCopy,     // set_row_srgbx(): sprites
+
+	count
+};
+
+char const* overdraw_category_name( OverdrawCategory ) noexcept;
+
+/** OverdrawStats - counts how often each pixel of a surface is written
+ *
+ * Collects the writes to one surface per frame, on the calling thread:
+ *
+ *   OverdrawStats overdraw;
+ *   ...
+ *   overdraw.begin_frame( surface );
+ *   draw_everything( surface );
+ *   overdraw.end_frame();
+ *   ...
+ *   overdraw.print( stdout, "Overdraw" );
+ *   overdraw.write_heatmap( "overdraw.png" );
+ *
+ * Only writes to that surface from the thread that called begin_frame() are
+ * counted. Writes through raw pointers (SurfaceEx) are not seen.
+ *
+ * The per-pixel counts and per-category totals are summed over all frames
+ * since the last reset(). If the size of the surface changes, the counts
+ * start over. clear() and fill() write each pixel once per call; they are
+ * included in the category totals, but not in the per-pixel counts, so that
+ * the heatmap and the overdraw factor are about the drawing.
+ *
+ * Requires DRAW2D_CFG_OVERDRAW (see above); otherwise nothing is counted.
+ */
+class OverdrawStats final
+{
+	public:
+		struct Totals
+		{
+			std::uint64_t writes[std::size_t(OverdrawCategory::count)] = {};
+			std::uint64_t pixelsWritten = 0; // pixels drawn at least once
+			std::uint64_t frames = 0;
+		};
+
+	public:
+		OverdrawStats() = default;
+		~OverdrawStats();
+
+		OverdrawStats( OverdrawStats const& ) = delete;
+		OverdrawStats& operator= (OverdrawStats const&) = delete;
+
+	public:
+		void begin_frame( Surface const& );
+		void end_frame() noexcept;
+
+		void reset() noexcept;
+
+		Totals const& totals() const noexcept;
+		Totals const& last_frame() const noexcept;
+
+		// Writes to pixel (x,y) summed over all frames
+		std::uint64_t pixel_writes( std::uint32_t aX, std::uint32_t aY ) const noexcept;
+
+		// Prints writes per frame for each category, and the average number
+		// of writes per written pixel (the overdraw factor).
+		void print( std::FILE*, char const* aTitle ) const;
+
+		/* Writes the average writes per pixel and frame as a PNG image:
+		 * black = never written, then blue (1), cyan (2), green (3),
+		 * yellow (4), red (6) and white (8 or more). Returns false if the
+		 * image could not be written.
+		 */
+		bool write_heatmap( char const* aPath ) const;
+
+	public:
+		// Called by Surface
+		void count_( OverdrawCategory, std::uint32_t aIndex, std::uint32_t aCount ) noexcept;
+		void count_masked_( std::uint32_t aIndex, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept;
+
+		Surface const* surface_() const noexcept;
+
+	private:
+		Surface const* mSurface = nullptr;
+		std::uint32_t mWidth = 0, mHeight = 0;
+
+		std::vector<std::uint32_t> mFrameCounts; // this frame
+		std::vector<std::uint64_t> mCounts; // all frames
+
+		Totals mFrame, mTotals;
+};
+
+
+namespace detail
+{
+	// The statistics that the calling thread is collecting (between
+	// begin_frame() and end_frame()), or null.
+	inline thread_local OverdrawStats* tActiveOverdraw = nullptr;
+
+	inline
+	OverdrawStats* active_overdraw( Surface const* aSurface ) noexcept
+	{
+		auto* stats = tActiveOverdraw;
+		return (stats && stats->surface_() == aSurface) ? stats : nullptr;
+	}
+
+	// Hooks in the Surface write functions. They compile to nothing without
+	// DRAW2D_CFG_OVERDRAW.
+	inline
+	void count_overdraw( Surface const* aSurface, OverdrawCategory aCategory, std::uint32_t aIndex, std::uint32_t aCount ) noexcept
+	{
+		if constexpr( kOverdrawEnabled )
+		{
+			if( auto* stats = active_overdraw( aSurface ) )
+				stats->count_( aCategory, aIndex, aCount );
+		}
+	}
+
+	inline
+	void count_overdraw_masked( Surface const* aSurface, std::uint32_t aIndex, std::uint8_t const* aRgba, std::uint32_t aCount ) noexcept
+	{
+		if constexpr( kOverdrawEnabled )
+		{
+			if( auto* stats = active_overdraw( aSurface ) )
+				stats->count_masked_( aIndex, aRgba, aCount );
+		}
+	}
+}
+
+inline
+Surface const* OverdrawStats::surface_() const noexcept
+{
+	return mSurface;
+}
+
+#endif // OVERDRAW_HPP_7C2000F0_380B_46F6_A902_36BB5645A494
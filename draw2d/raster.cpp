@@ -0,0 +1,108 @@
+#include "raster.hpp"
+
+#include <algorithm>
+#include <utility>
+
+#include <cmath>
+
+namespace detail
+{
+	FixedVec snap_to_fixed( Vec2f aVec ) noexcept
+	{
+		auto const snap = [] ( float aValue ) {
+			// Written such that NaNs end up at the guard band, too.
+			if( !(aValue >= -kGuardBand) ) aValue = -kGuardBand;
+			if( !(aValue <= kGuardBand) ) aValue = kGuardBand;
+
+			return std::int32_t(std::floor( aValue * float(kSubpixelOne) + .5f ));
+		};
+
+		return FixedVec{ snap( aVec.x ), snap( aVec.y ) };
+	}
+
+	Edge make_edge( FixedVec aA, FixedVec aB, std::int32_t aX, std::int32_t aY ) noexcept
+	{
+		constexpr std::int32_t half = kSubpixelOne / 2;
+
+		std::int64_t const px = std::int64_t(aX) * kSubpixelOne + half;
+		std::int64_t const py = std::int64_t(aY) * kSubpixelOne + half;
+
+		std::int64_t const dx = std::int64_t(aB.x) - aA.x;
+		std::int64_t const dy = std::int64_t(aB.y) - aA.y;
+
+		Edge edge;
+		edge.start = dx * (py - aA.y) - dy * (px - aA.x);
+		edge.stepX = -dy * kSubpixelOne;
+		edge.stepY = dx * kSubpixelOne;
+
+		// Top-left rule. In the winding used here, top edges point in +x and
+		// left edges point in -y. Pixel centers that lie exactly on other
+		// edges (value zero) are excluded by shifting the value down by one.
+		bool const topLeft = (0 == dy && dx > 0) || dy < 0;
+		if( !topLeft )
+			edge.start -= 1;
+
+		return edge;
+	}
+
+	bool pixel_box( PixelBox& aBox, FixedVec const* aVerts, std::size_t aCount, std::uint32_t aWidth, std::uint32_t aHeight ) noexcept
+	{
+		if( 0 == aCount )
+			return false;
+
+		auto minFx = aVerts[0].x, maxFx = aVerts[0].x;
+		auto minFy = aVerts[0].y, maxFy = aVerts[0].y;
+		for( std::size_t i = 1; i < aCount; ++i )
+		{
+			minFx = std::min( minFx, aVerts[i].x );
+			maxFx = std::max( maxFx, aVerts[i].x );
+			minFy = std::min( minFy, aVerts[i].y );
+			maxFy = std::max( maxFy, aVerts[i].y );
+		}
+
+		// Pixel x has its center at x*kSubpixelOne + kSubpixelOne/2.
+		constexpr std::int32_t half = kSubpixelOne / 2;
+
+		aBox.minX = std::max( (minFx - half + kSubpixelOne-1) >> kSubpixelBits, std::int32_t(0) );
+		aBox.minY = std::max( (minFy - half + kSubpixelOne-1) >> kSubpixelBits, std::int32_t(0) );
+		aBox.maxX = std::min( (maxFx - half) >> kSubpixelBits, std::int32_t(aWidth) - 1 );
+		aBox.maxY = std::min( (maxFy - half) >> kSubpixelBits, std::int32_t(aHeight) - 1 );
+
+		return aBox.minX <= aBox.maxX && aBox.minY <= aBox.maxY;
+	}
+
+	bool setup_triangle( TriangleSetup& aTri, Vec2f aP0, Vec2f aP1, Vec2f aP2, std::uint32_t aWidth, std::uint32_t aHeight ) noexcept
+	{
+		FixedVec v[3] = { snap_to_fixed( aP0 ), snap_to_fixed( aP1 ), snap_to_fixed( aP2 ) };
+
+		// Twice the signed area. With y pointing down, a positive area means
+		// that the vertices are in clockwise order on screen. Reorder the
+		// other winding to this one.
+		auto const area2 = std::int64_t(v[1].x - v[0].x) * (v[2].y - v[0].y)
+			- std::int64_t(v[1].y - v[0].y) * (v[2].x - v[0].x);
+
+		if( 0 == area2 )
+			return false;
+
+		aTri.swapped = area2 < 0;
+		if( aTri.swapped )
+			std::swap( v[1], v[2] );
+
+		aTri.area2 = aTri.swapped ? -area2 : area2;
+
+		PixelBox box;
+		if( !pixel_box( box, v, 3, aWidth, aHeight ) )
+			return false;
+
+		aTri.minX = box.minX;
+		aTri.minY = box.minY;
+		aTri.maxX = box.maxX;
+		aTri.maxY = box.maxY;
+
+		// Edge functions, evaluated at the center of the first pixel
+		for( int i = 0; i < 3; ++i )
+			aTri.edges[i] = make_edge( v[(i+1) % 3], v[(i+2) % 3], aTri.minX, aTri.minY );
+
+		return true;
+	}
+}
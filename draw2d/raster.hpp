@@ -0,0 +1,172 @@
+#ifndef RASTER_HPP_98E40B3A_6981_4857_8FDF_266B4A82DCD0
+#define RASTER_HPP_98E40B3A_6981_4857_8FDF_266B4A82DCD0
+
+// Internal: shared triangle setup for the rasterizers in draw.cpp. This is
+// not part of the public draw2d interface.
+
+#include <algorithm>
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../vmlib/vec2.hpp"
+
+namespace detail
+{
+	/* Vertices are snapped to a fixed-point grid with kSubpixelBits
+	 * fractional bits (24.8). All coverage decisions are made with exact
+	 * integer arithmetic on the snapped vertices, so two triangles that share
+	 * an edge never both cover a pixel, and never both miss one (watertight).
+	 *
+	 * Coordinates are clamped to +-kGuardBand pixels before snapping; the
+	 * edge functions then fit comfortably into 64-bit integers.
+	 */
+	constexpr int kSubpixelBits = 8;
+	constexpr std::int32_t kSubpixelOne = std::int32_t(1) << kSubpixelBits;
+	constexpr float kGuardBand = 4194304.f; // 2^22 pixels
+
+	/* Vertex snapped to the fixed-point grid */
+	struct FixedVec
+	{
+		std::int32_t x, y;
+	};
+
+	FixedVec snap_to_fixed( Vec2f ) noexcept;
+
+	/* Edge function of one edge, evaluated at pixel centers. The value at
+	 * pixel (x,y) is
+	 *
+	 *   start + (x - minX) * stepX + (y - minY) * stepY
+	 *
+	 * The fill rule is folded into start: a pixel is covered if the values of
+	 * all three edges are >= 0.
+	 */
+	struct Edge
+	{
+		std::int64_t start;
+		std::int64_t stepX, stepY;
+	};
+
+	/* Edge function of the edge from aA to aB, evaluated at the center of
+	 * pixel (aX,aY), with the fill rule applied. Pixels to the right of the
+	 * edge (on screen, with y pointing down) have positive values; in a
+	 * triangle whose vertices are in clockwise order, these are the pixels on
+	 * the inside of the edge.
+	 */
+	Edge make_edge( FixedVec aA, FixedVec aB, std::int32_t aX, std::int32_t aY ) noexcept;
+
+	/* Pixels whose centers may be covered by a shape with the given
+	 * vertices, clipped to a aWidth x aHeight surface. Returns false if no
+	 * pixels of the surface remain.
+	 */
+	struct PixelBox
+	{
+		std::int32_t minX, minY; // first pixel, inclusive
+		std::int32_t maxX, maxY; // last pixel, inclusive
+	};
+
+	bool pixel_box(
+		PixelBox&,
+		FixedVec const*, std::size_t aCount,
+		std::uint32_t aWidth, std::uint32_t aHeight
+	) noexcept;
+
+	/* Triangle after setup. edges[i] is the edge opposite of vertex i, so
+	 * that (edge value) / area2 is the barycentric weight of vertex i.
+	 *
+	 * The vertices are reordered to a consistent winding if necessary; in that
+	 * case, swapped is set, and vertices 1 and 2 have traded places (which
+	 * callers need to know when attaching per-vertex attributes).
+	 */
+	struct TriangleSetup
+	{
+		std::int32_t minX, minY; // first pixel, inclusive
+		std::int32_t maxX, maxY; // last pixel, inclusive
+
+		Edge edges[3];
+		std::int64_t area2; // twice the area, in 1/kSubpixelOne^2 pixels
+
+		bool swapped;
+	};
+
+	/* Sets up the triangle for rasterization on a aWidth x aHeight surface.
+	 * Returns false if the triangle covers no pixels: if it has zero area
+	 * (after snapping) or lies outside of the surface.
+	 *
+	 * The fill rule is the "top-left" rule: a pixel whose center lies
+	 * exactly on an edge is covered only if that edge is a top edge
+	 * (horizontal, with the triangle below it) or a left edge.
+	 */
+	bool setup_triangle(
+		TriangleSetup&,
+		Vec2f aP0, Vec2f aP1, Vec2f aP2,
+		std::uint32_t aWidth, std::uint32_t aHeight
+	) noexcept;
+
+	/* Columns where three linear functions aRow[i] + x*aStepX[i] are all
+	 * >= 0, for x in [0, aMaxX]. On return, these are the columns aFirst to
+	 * aLast (inclusive); returns false if there are none.
+	 *
+	 * Each function bounds the columns from one side. The bounds are computed
+	 * with exact integer divisions, and therefore give the same columns as
+	 * testing all three values at each x.
+	 */
+	inline
+	bool edge_span( std::int64_t const (&aRow)[3], std::int64_t const (&aStepX)[3], std::int64_t aMaxX, std::int64_t& aFirst, std::int64_t& aLast ) noexcept
+	{
+		std::int64_t first = 0, last = aMaxX;
+
+		for( int i = 0; i < 3; ++i )
+		{
+			std::int64_t const w = aRow[i];
+			std::int64_t const step = aStepX[i];
+
+			if( step > 0 )
+			{
+				// Increasing: covered from the first x where w + x*step >= 0
+				if( w < 0 )
+					first = std::max( first, (-w + step - 1) / step );
+			}
+			else if( step < 0 )
+			{
+				// Decreasing: covered up to the last x where w + x*step >= 0
+				if( w < 0 )
+					return false;
+
+				last = std::min( last, w / -step );
+			}
+			else if( w < 0 )
+			{
+				return false;
+			}
+		}
+
+		if( first > last )
+			return false;
+
+		aFirst = first;
+		aLast = last;
+		return true;
+	}
+
+	/* Covered pixels of one row, given the values aRow[i] of the three edge
+	 * functions at the row's first pixel (column minX). On return, the
+	 * covered pixels are the columns aBegin to aEnd (inclusive); returns
+	 * false if no pixel on the row is covered.
+	 */
+	inline
+	bool row_span( TriangleSetup const& aTri, std::int64_t const (&aRow)[3], std::int32_t& aBegin, std::int32_t& aEnd ) noexcept
+	{
+		std::int64_t const steps[3] = { aTri.edges[0].stepX, aTri.edges[1].stepX, aTri.edges[2].stepX };
+
+		std::int64_t first, last;
+		if( !edge_span( aRow, steps, std::int64_t(aTri.maxX) - aTri.minX, first, last ) )
+			return false;
+
+		aBegin = aTri.minX + std::int32_t(first);
+		aEnd = aTri.minX + std::int32_t(last);
+		return true;
+	}
+}
+
+#endif // RASTER_HPP_98E40B3A_6981_4857_8FDF_266B4A82DCD0
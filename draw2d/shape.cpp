@@ -1,14 +1,36 @@
 #include "shape.hpp"
 
+#include <vector>
 #include <utility>
 
 #include <cassert>
 #include <cstring>
 
 #include "draw.hpp"
+#include "fan.hpp"
 #include "color.hpp"
 #include "surface.hpp"
 
+#include "../vmlib/transform.hpp"
+
+namespace
+{
+	/* Transforms all vertices of a shape up front, into a per-thread scratch
+	 * buffer. The buffer is reused between calls, so after the first few
+	 * shapes this no longer allocates. The returned pointer is valid until the
+	 * next call on the same thread.
+	 */
+	Vec2f const* transform_vertices_( std::size_t aCount, Vec2f const* aVerts, Mat22f const& aRotation, Vec2f const& aTranslation )
+	{
+		thread_local std::vector<Vec2f> scratch;
+		if( scratch.size() < aCount )
+			scratch.resize( aCount );
+
+		transform_points( aRotation, aTranslation, { aVerts, aCount }, { scratch.data(), aCount } );
+		return scratch.data();
+	}
+}
+
 LineStrip::LineStrip( std::size_t aCount, Vec2f const* aVerts )
 	: mCount( aCount )
 	, mVertices( nullptr )
@@ -39,14 +61,10 @@ void LineStrip::draw( Surface& aSurface, ColorF const& aColor, Mat22f const& aRo
 {
 	ColorU8_sRGB const color = linear_to_srgb( aColor );
 
-	Vec2f previous = aRotation * mVertices[0] + aTranslation;
+	Vec2f const* verts = transform_vertices_( mCount, mVertices, aRotation, aTranslation );
 
 	for( std::size_t i = 1; i < mCount; ++i )
-	{
-		Vec2f const current = aRotation * mVertices[i] + aTranslation;
-		draw_line_solid( aSurface, previous, current, color );
-		previous = current;
-	}
+		draw_line_solid( aSurface, verts[i-1], verts[i], color );
 }
 
 
@@ -105,21 +123,27 @@ TriangleFan& TriangleFan::operator= (TriangleFan&& aOther)  noexcept
 
 void TriangleFan::draw( Surface& aSurface, Mat22f const& aRotation, Vec2f const& aTranslation ) const
 {
-	Vec2f const center = aRotation * mVertices[0] + aTranslation;
-	ColorF const cencol = mColors[0];
+	Vec2f const* verts = transform_vertices_( mCount, mVertices, aRotation, aTranslation );
+
+	draw_triangle_fan_interp( aSurface, mCount, verts, mColors );
+}
+
+void TriangleFan::draw_wireframe( Surface& aSurface, ColorF const& aColor, Mat22f const& aRotation, Vec2f const& aTranslation ) const
+{
+	if( mCount < 3 )
+		return;
+
+	ColorU8_sRGB const color = linear_to_srgb( aColor );
+
+	Vec2f const* verts = transform_vertices_( mCount, mVertices, aRotation, aTranslation );
+
+	// Spokes, and the rim edges between consecutive outer vertices
+	for( std::size_t i = 1; i < mCount; ++i )
+		draw_line_solid( aSurface, verts[0], verts[i], color );
 
-	Vec2f previous = aRotation * mVertices[1] + aTranslation;
-	ColorF pcol = mColors[1];
 	for( std::size_t i = 2; i < mCount; ++i )
-	{
-		Vec2f const current = aRotation * mVertices[i] + aTranslation;
-		ColorF const curcol = mColors[i];
-		draw_triangle_interp( aSurface, center, previous, current, cencol, pcol, curcol );
-		previous = current;
-		pcol = curcol;
-	}
+		draw_line_solid( aSurface, verts[i-1], verts[i], color );
 
-	Vec2f const first = aRotation * mVertices[1] + aTranslation;
-	ColorF const fcol = mColors[1];
-	draw_triangle_interp( aSurface, center, previous, first, cencol, pcol, fcol );
+	// Close the fan
+	draw_line_solid( aSurface, verts[mCount-1], verts[1], color );
 }
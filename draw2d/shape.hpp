@@ -119,11 +119,26 @@ class TriangleFan final
 		 *
 		 * finalVertex = vertexIn * matrix + vector
 		 *
-		 * TriangleFan::draw() uses draw_triangle_interp() internally.  It uses
-		 * the (linear) per-vertex colors assigned at construction time.
+		 * TriangleFan::draw() uses draw_triangle_fan_interp() internally,
+		 * which covers the same pixels as draw_triangle_interp() for each
+		 * triangle. It uses the (linear) per-vertex colors assigned at
+		 * construction time.
 		 */
 		void draw( Surface&, Mat22f const&, Vec2f const& ) const;
 
+		/* Draw the edges of the fan's triangles in a single color (linear),
+		 * e.g., for debug views. The vertices are transformed as for draw().
+		 *
+		 * Edges that are shared by two triangles are drawn once: each spoke
+		 * (central vertex to outer vertex) and each rim edge (between two
+		 * neighbouring outer vertices) is one line. N vertices therefore give
+		 * 2(N-1) lines instead of the 3(N-1) lines that calling
+		 * draw_triangle_wireframe() for each triangle would draw.
+		 */
+		void draw_wireframe( Surface&, ColorF const&, Mat22f const&, Vec2f const& ) const;
+
+		std::size_t vertex_count() const noexcept { return mCount; }
+		Vec2f const* vertices() const noexcept { return mVertices; }
 
 	private:
 		std::size_t mCount;
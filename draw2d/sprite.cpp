@@ -0,0 +1,144 @@
+#include "sprite.hpp"
+
+#include <numbers>
+#include <algorithm>
+
+#include <cmath>
+#include <cassert>
+#include <cstring>
+
+#include "shape.hpp"
+#include "surface-ex.hpp"
+
+Sprite::Sprite( TriangleFan const& aFan, Mat22f const& aRotation )
+{
+	auto const count = aFan.vertex_count();
+	auto const* verts = aFan.vertices();
+	assert( count > 0 && verts );
+
+	// Bounds of the rotated shape, with a pixel of margin on each side
+	Vec2f lo = aRotation * verts[0], hi = lo;
+	for( std::size_t i = 1; i < count; ++i )
+	{
+		Vec2f const v = aRotation * verts[i];
+		lo.x = std::min( lo.x, v.x ); hi.x = std::max( hi.x, v.x );
+		lo.y = std::min( lo.y, v.y ); hi.y = std::max( hi.y, v.y );
+	}
+
+	mOffsetX = std::int32_t(std::floor( lo.x )) - 1;
+	mOffsetY = std::int32_t(std::floor( lo.y )) - 1;
+	mWidth = std::int32_t(std::ceil( hi.x )) + 2 - mOffsetX;
+	mHeight = std::int32_t(std::ceil( hi.y )) + 2 - mOffsetY;
+
+	// Render the shape into a scratch surface. set_pixel_srgb() clears the
+	// padding byte of each pixel that it writes; initializing the padding
+	// bytes to a non-zero value thus marks the pixels that the shape covers.
+	auto const width = Surface::Index(mWidth), height = Surface::Index(mHeight);
+
+	SurfaceEx scratch( width, height );
+	std::uint8_t* const ptr = scratch.get_surface_ptr();
+	std::memset( ptr, 0xff, std::size_t(width)*height*4 );
+
+	aFan.draw( scratch, aRotation, Vec2f{ -float(mOffsetX), -float(mOffsetY) } );
+
+	// Extract runs of covered pixels
+	for( std::int32_t y = 0; y < mHeight; ++y )
+	{
+		std::uint8_t const* row = ptr + std::size_t(y)*mWidth*4;
+
+		std::int32_t x = 0;
+		while( x < mWidth )
+		{
+			if( 0 != row[x*4+3] )
+			{
+				++x;
+				continue;
+			}
+
+			std::int32_t end = x+1;
+			while( end < mWidth && 0 == row[end*4+3] )
+				++end;
+
+			auto const offset = std::uint32_t(mPixels.size() / 4);
+			mPixels.insert( mPixels.end(), row + x*4, row + end*4 );
+			mRuns.emplace_back( Run_{ x, y, std::uint32_t(end-x), offset } );
+
+			x = end;
+		}
+	}
+}
+
+void Sprite::draw( Surface& aSurface, Vec2f const& aTranslation ) const
+{
+	auto const width = std::int32_t(aSurface.get_width());
+	auto const height = std::int32_t(aSurface.get_height());
+
+	// Sprite corner in surface coordinates. Rounding to the nearest pixel
+	// matches the exact path for integer translations.
+	std::int32_t const cx = std::int32_t(std::floor( aTranslation.x + .5f )) + mOffsetX;
+	std::int32_t const cy = std::int32_t(std::floor( aTranslation.y + .5f )) + mOffsetY;
+
+	if( cx >= width || cy >= height || cx + mWidth <= 0 || cy + mHeight <= 0 )
+		return;
+
+	for( auto const& run : mRuns )
+	{
+		std::int32_t const y = cy + run.y;
+		if( y < 0 || y >= height )
+			continue;
+
+		std::int32_t const x0 = cx + run.x;
+		std::int32_t const x1 = x0 + std::int32_t(run.length);
+
+		std::int32_t const bx = std::max( x0, 0 );
+		std::int32_t const ex = std::min( x1, width );
+		if( bx >= ex )
+			continue;
+
+		aSurface.set_row_srgbx(
+			Surface::Index(bx), Surface::Index(y),
+			Surface::Index(ex - bx),
+			mPixels.data() + (std::size_t(run.offset) + (bx - x0))*4
+		);
+	}
+}
+
+std::size_t Sprite::byte_size() const noexcept
+{
+	return sizeof(Sprite) + mRuns.size()*sizeof(Run_) + mPixels.size();
+}
+
+
+SpriteCache::SpriteCache( TriangleFan const& aFan, std::size_t aRotationCount )
+{
+	assert( aRotationCount > 0 );
+
+	float const step = 2.f*std::numbers::pi_v<float> / float(aRotationCount);
+
+	mSprites.reserve( aRotationCount );
+	for( std::size_t i = 0; i < aRotationCount; ++i )
+		mSprites.emplace_back( aFan, make_rotation_2d( float(i) * step ) );
+}
+
+void SpriteCache::draw( Surface& aSurface, Mat22f const& aRotation, Vec2f const& aTranslation ) const
+{
+	auto const count = std::int32_t(mSprites.size());
+
+	// make_rotation_2d() puts sin(angle) into _10 and cos(angle) into _00.
+	float const angle = std::atan2( aRotation._10, aRotation._00 );
+	float const steps = angle * float(count) / (2.f*std::numbers::pi_v<float>);
+
+	std::int32_t index = std::int32_t(std::floor( steps + .5f )) % count;
+	if( index < 0 )
+		index += count;
+
+	mSprites[index].draw( aSurface, aTranslation );
+}
+
+std::size_t SpriteCache::byte_size() const noexcept
+{
+	std::size_t ret = sizeof(SpriteCache);
+	for( auto const& sprite : mSprites )
+		ret += sprite.byte_size();
+	return ret;
+}
@@ -34,19 +34,86 @@ Surface& Surface::operator=( Surface&& aOther ) noexcept
 void Surface::clear() noexcept
 {
 	std::memset( mSurface, 0, sizeof(std::uint8_t)*mWidth*mHeight*4 );
+	detail::count_overdraw( this, OverdrawCategory::clear, 0, mWidth*mHeight );
 }
 
 void Surface::fill( ColorU8_sRGB aColor ) noexcept
 {
-	// This can be optimized quite a bit. 8 bit loads and stores are generally
-	// not the most efficient.
-	auto const limit = mWidth * mHeight * 4;
-	for( std::size_t i = 0; i < limit; i += 4 )
+	// The whole surface is one contiguous run of pixels.
+	std::uint8_t const rgbx[4] = { aColor.r, aColor.g, aColor.b, 0 };
+	std::uint32_t packed;
+	std::memcpy( &packed, rgbx, sizeof(packed) );
+
+	kernels().fillRow( mSurface, mWidth * mHeight, packed );
+	detail::count_overdraw( this, OverdrawCategory::clear, 0, mWidth*mHeight );
+}
+
+void Surface::draw_points( std::size_t aCount, float const* aXs, float const* aYs, ColorU8_sRGB const& aColor, float aOffsetX, float aOffsetY )
+{
+	assert( 0 == aCount || (aXs && aYs) );
+
+	// Pack the color once. A single 32-bit store then writes the whole pixel.
+	std::uint8_t const rgbx[4] = { aColor.r, aColor.g, aColor.b, 0 };
+	std::uint32_t packed;
+	std::memcpy( &packed, rgbx, sizeof(packed) );
+
+	// Points are processed in blocks of kLanes. The conversion and clipping
+	// are branch-free, so the compiler turns them into vector code. Only the
+	// final scatter of the pixels is scalar.
+	constexpr std::size_t kLanes = 8;
+
+	float const fwidth = float(mWidth);
+	float const fheight = float(mHeight);
+	std::uint32_t const width = mWidth;
+
+	float const ox = aOffsetX + .5f;
+	float const oy = aOffsetY + .5f;
+
+	std::size_t i = 0;
+	for( ; i + kLanes <= aCount; i += kLanes )
 	{
-		mSurface[i+0] = aColor.r;
-		mSurface[i+1] = aColor.g;
-		mSurface[i+2] = aColor.b;
-		mSurface[i+3] = 0;
+		std::uint32_t index[kLanes];
+		std::uint32_t valid[kLanes];
+
+		for( std::size_t l = 0; l < kLanes; ++l )
+		{
+			// Round to nearest. Clipping in floating point first means that
+			// the (truncating) conversions only see non-negative values,
+			// where truncation and floor() agree.
+			float const x = aXs[i+l] + ox;
+			float const y = aYs[i+l] + oy;
+
+			bool const inside = (x >= 0.f) & (x < fwidth) & (y >= 0.f) & (y < fheight);
+
+			std::uint32_t const ix = std::uint32_t( inside ? x : 0.f );
+			std::uint32_t const iy = std::uint32_t( inside ? y : 0.f );
+
+			index[l] = iy * width + ix;
+			valid[l] = inside;
+		}
+
+		for( std::size_t l = 0; l < kLanes; ++l )
+		{
+			if( valid[l] )
+			{
+				std::memcpy( mSurface + std::size_t(index[l])*4, &packed, sizeof(packed) );
+				detail::count_overdraw( this, OverdrawCategory::points, index[l], 1 );
+			}
+		}
+	}
+
+	// Remaining points one by one
+	for( ; i < aCount; ++i )
+	{
+		float const x = aXs[i] + ox;
+		float const y = aYs[i] + oy;
+
+		if( x >= 0.f && x < fwidth && y >= 0.f && y < fheight )
+		{
+			auto const index = get_linear_index( Index(x), Index(y) );
+			std::memcpy( mSurface + std::size_t(index)*4, &packed, sizeof(packed) );
+			detail::count_overdraw( this, OverdrawCategory::points, index, 1 );
+		}
 	}
 }
 
@@ -9,8 +9,11 @@
 #include <cassert>
 #include <cstdint>
 #include <cstdlib>
+#include <cstring>
 
 #include "color.hpp"
+#include "kernels.hpp"
+#include "overdraw.hpp"
 
 /** Surface - an image that we can draw to
  *
@@ -54,6 +57,34 @@ class Surface
 		// Set the pixel at index (aX,aY) to the specified color
 		void set_pixel_srgb( Index aX, Index aY, ColorU8_sRGB const& );
 
+		// Set the pixels nearest to each of the aCount points (aXs[i],aYs[i])
+		// to the specified color. The offset (aOffsetX,aOffsetY) is added to
+		// each point. Points outside of the surface are skipped. This is much
+		// faster than calling set_pixel_srgb() for each point (see
+		// surface.cpp).
+		void draw_points( std::size_t aCount, float const* aXs, float const* aYs, ColorU8_sRGB const&, float aOffsetX = 0.f, float aOffsetY = 0.f );
+
+		// Copy aCount pixels to row aY, starting at column aX. The source
+		// pixels must be in the surface's format (sRGB, RGBx8). The span must
+		// lie within the surface.
+		void set_row_srgbx( Index aX, Index aY, Index aCount, std::uint8_t const* aPixels );
+
+		// Set aCount pixels of row aY, starting at column aX, to the specified
+		// color. The span must lie within the surface. Pixels are written with
+		// wide stores (see kernels.hpp), so this is much faster than calling
+		// set_pixel_srgb() for each pixel.
+		void fill_row_srgb( Index aX, Index aY, Index aCount, ColorU8_sRGB const& );
+
+		// Copy those of aCount RGBA pixels (sRGB, RGBA8) whose alpha is at
+		// least 128 to row aY, starting at column aX; pixels with a lower
+		// alpha are skipped. The span must lie within the surface.
+		void set_row_srgba_masked( Index aX, Index aY, Index aCount, std::uint8_t const* aPixels );
+
+		// Set aCount pixels of row aY, starting at column aX, to the linear
+		// colors aFirst + i*aStep (i = 0...aCount-1), clamped to [0,1] and
+		// converted to sRGB. The span must lie within the surface.
+		void set_row_linear( Index aX, Index aY, Index aCount, ColorF const& aFirst, ColorF const& aStep );
+
 		// Get pointer to surface image data. This is mainly used when drawing
 		// the surface's contents to the screen. You must not use these functions
 		// when implementing your drawing functions.
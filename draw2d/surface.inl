@@ -23,6 +23,51 @@ void Surface::set_pixel_srgb( Index aX, Index aY, ColorU8_sRGB const& aColor )
     mSurface[index * 4 + 1] = aColor.g; // Green Channel
     mSurface[index * 4 + 2] = aColor.b; // Blue Channel
     mSurface[index * 4 + 3] = 0;        // Alpha Channel
+
+	detail::count_overdraw( this, OverdrawCategory::pixels, index, 1 );
+}
+
+inline
+void Surface::set_row_srgbx( Index aX, Index aY, Index aCount, std::uint8_t const* aPixels )
+{
+	assert( aY < mHeight && aX <= mWidth && aCount <= mWidth - aX );
+	assert( aPixels || 0 == aCount );
+
+	std::memcpy( mSurface + std::size_t(get_linear_index( aX, aY ))*4, aPixels, std::size_t(aCount)*4 );
+	detail::count_overdraw( this, OverdrawCategory::rowCopy, get_linear_index( aX, aY ), aCount );
+}
+
+inline
+void Surface::fill_row_srgb( Index aX, Index aY, Index aCount, ColorU8_sRGB const& aColor )
+{
+	assert( aY < mHeight && aX <= mWidth && aCount <= mWidth - aX );
+
+	// Same pixel format as set_pixel_srgb(), including the zero padding byte.
+	std::uint8_t const rgbx[4] = { aColor.r, aColor.g, aColor.b, 0 };
+	std::uint32_t packed;
+	std::memcpy( &packed, rgbx, sizeof(packed) );
+
+	kernels().fillRow( mSurface + std::size_t(get_linear_index( aX, aY ))*4, aCount, packed );
+	detail::count_overdraw( this, OverdrawCategory::solidSpans, get_linear_index( aX, aY ), aCount );
+}
+
+inline
+void Surface::set_row_srgba_masked( Index aX, Index aY, Index aCount, std::uint8_t const* aPixels )
+{
+	assert( aY < mHeight && aX <= mWidth && aCount <= mWidth - aX );
+	assert( aPixels || 0 == aCount );
+
+	kernels().blitRowMasked( mSurface + std::size_t(get_linear_index( aX, aY ))*4, aPixels, aCount );
+	detail::count_overdraw_masked( this, get_linear_index( aX, aY ), aPixels, aCount );
+}
+
+inline
+void Surface::set_row_linear( Index aX, Index aY, Index aCount, ColorF const& aFirst, ColorF const& aStep )
+{
+	assert( aY < mHeight && aX <= mWidth && aCount <= mWidth - aX );
+
+	kernels().linearRow( mSurface + std::size_t(get_linear_index( aX, aY ))*4, aCount, aFirst, aStep );
+	detail::count_overdraw( this, OverdrawCategory::interpSpans, get_linear_index( aX, aY ), aCount );
 }
 
 inline 
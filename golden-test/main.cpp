@@ -0,0 +1,457 @@
+#include <regex>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <typeinfo>
+#include <exception>
+#include <filesystem>
+#include <unordered_map>
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <stb_image.h>
+#include <stb_image_write.h>
+
+#include "../draw2d/kernels.hpp"
+#include "../draw2d/surface.hpp"
+
+#include "../support/error.hpp"
+
+#include "scenes.hpp"
+
+// Golden-image regression test for draw2d. Renders each scene of the corpus
+// (see scenes.cpp) and compares the result bit-exactly against the
+// reference image in golden-test/reference/<scene>.png. Mismatching scenes
+// are written to golden-test/out/, together with an image that marks the
+// differing pixels.
+//
+// Each scene is also timed: the fastest of repeated samples, which is less
+// sensitive to interference from other processes than the mean or the
+// median. The timings are compared against a JSON baseline that was recorded earlier on the same
+// machine with --record-baseline; scenes that became slower by more than
+// the threshold fail as well. Baselines are specific to a machine and build,
+// and are therefore not part of the repository.
+//
+// The draw2d kernels exist in several versions (see draw2d/kernels.hpp),
+// which must all produce the same pixels. Scenes are drawn with the best
+// version that the CPU supports, and then again with each of the others; a
+// version that differs fails the scene. With --kernel-isa=, only the given
+// version is checked (and timed).
+//
+// The reference images depend on the exact floating point results of the
+// compiler, its flags and the standard library in use (e.g., sRGB conversion
+// with std::pow()). They are recorded with the release configuration. After
+// switching toolchains, check the differences and re-create the references
+// with --update-references.
+//
+// Run from the repository's root directory. The exit code is non-zero if any
+// scene fails.
+namespace
+{
+	constexpr char const* kReferenceDir = "golden-test/reference";
+	constexpr char const* kOutputDir = "golden-test/out";
+	constexpr char const* kDefaultBaseline = "golden-test/baseline.json";
+
+	constexpr double kDefaultThreshold = 20.0; // percent
+
+	// Timing: each sample renders the scene repeatedly, for at least
+	// kMinSampleSeconds, so that short scenes are not dominated by the clock's
+	// resolution. At least kMinSamples are taken, and then more until
+	// kMinSeconds have passed.
+	constexpr int kMinSamples = 5;
+	constexpr double kMinSampleSeconds = 0.002;
+	constexpr double kMinSeconds = 0.2;
+
+	struct Options_
+	{
+		bool updateReferences = false;
+		bool recordBaseline = false;
+		bool timing = true;
+		double threshold = kDefaultThreshold;
+		std::string baseline = kDefaultBaseline;
+		std::string filter;
+
+		// automatic: check all kernel versions
+		KernelIsa kernelIsa = KernelIsa::automatic;
+	};
+
+	Options_ parse_options_( int, char const* const* );
+
+	// Surface contents as tightly packed RGB (the padding byte is dropped)
+	std::vector<std::uint8_t> to_rgb_( Surface const& );
+
+	bool write_png_( std::string const& aPath, std::uint32_t aWidth, std::uint32_t aHeight, std::uint8_t const* aRgb );
+
+	double time_scene_ms_( Scene const&, Surface& );
+
+	std::unordered_map<std::string,double> read_baseline_( std::string const& aPath );
+	void write_baseline_( std::string const& aPath, std::unordered_map<std::string,double> const& );
+}
+
+int main( int aArgc, char* aArgv[] ) try
+{
+	auto const opts = parse_options_( aArgc, aArgv );
+
+	select_kernels( opts.kernelIsa );
+	std::printf( "Kernels: %s\n", kernel_isa_name( kernels().isa ) );
+
+	// Other kernel versions to compare against
+	std::vector<KernelIsa> otherIsas;
+	if( KernelIsa::automatic == opts.kernelIsa )
+	{
+		for( auto const isa : { KernelIsa::generic, KernelIsa::sse2, KernelIsa::avx2, KernelIsa::avx512, KernelIsa::neon } )
+		{
+			if( isa != kernels().isa && kernel_isa_supported( isa ) )
+				otherIsas.emplace_back( isa );
+		}
+	}
+
+	auto const scenes = make_scenes();
+	auto baseline = read_baseline_( opts.baseline );
+
+	int failed = 0, checked = 0;
+	for( auto const& scene : scenes )
+	{
+		if( !opts.filter.empty() && std::string::npos == scene.name.find( opts.filter ) )
+			continue;
+
+		++checked;
+		std::printf( "%-22s", scene.name.c_str() );
+
+		Surface surface( scene.width, scene.height );
+		surface.clear();
+		scene.draw( surface );
+
+		auto const actual = to_rgb_( surface );
+
+		// The same scene with the other kernel versions
+		std::string isaDiffs;
+		for( auto const isa : otherIsas )
+		{
+			auto const active = kernels().isa;
+			select_kernels( isa );
+
+			Surface other( scene.width, scene.height );
+			other.clear();
+			scene.draw( other );
+
+			select_kernels( active );
+
+			if( to_rgb_( other ) != actual )
+				isaDiffs += std::string(isaDiffs.empty() ? "" : ",") + kernel_isa_name( isa );
+		}
+		auto const refPath = std::string(kReferenceDir) + "/" + scene.name + ".png";
+
+		bool ok = true;
+		if( opts.updateReferences )
+		{
+			std::filesystem::create_directories( kReferenceDir );
+			if( !write_png_( refPath, scene.width, scene.height, actual.data() ) )
+				throw Error( "Unable to write '%s'", refPath.c_str() );
+
+			std::printf( " updated      " );
+		}
+		else
+		{
+			// Surface rows are stored bottom to top (as OpenGL expects them),
+			// images top to bottom. See write_png_().
+			stbi_set_flip_vertically_on_load( 1 );
+
+			int w = 0, h = 0, comp = 0;
+			stbi_uc* ref = stbi_load( refPath.c_str(), &w, &h, &comp, 3 );
+
+			std::size_t diffs = 0;
+			std::vector<std::uint8_t> diff( actual.size(), 0 );
+			if( ref && std::uint32_t(w) == scene.width && std::uint32_t(h) == scene.height )
+			{
+				for( std::size_t i = 0; i < actual.size(); i += 3 )
+				{
+					if( 0 != std::memcmp( ref + i, actual.data() + i, 3 ) )
+					{
+						++diffs;
+						diff[i] = 255;
+					}
+					else
+					{
+						// Faint copy of the image, for orientation
+						diff[i+1] = diff[i+2] = std::uint8_t(actual[i+1] / 4);
+					}
+				}
+			}
+
+			if( !ref )
+				std::printf( " NO REFERENCE " );
+			else if( std::uint32_t(w) != scene.width || std::uint32_t(h) != scene.height )
+				std::printf( " WRONG SIZE   " );
+			else if( diffs )
+				std::printf( " %6zu DIFFS ", diffs );
+			else
+				std::printf( " ok           " );
+
+			ok = ref && 0 == diffs && std::uint32_t(w) == scene.width && std::uint32_t(h) == scene.height;
+			stbi_image_free( ref );
+
+			if( !ok )
+			{
+				std::filesystem::create_directories( kOutputDir );
+
+				auto const base = std::string(kOutputDir) + "/" + scene.name;
+				write_png_( base + ".png", scene.width, scene.height, actual.data() );
+				if( diffs )
+					write_png_( base + "-diff.png", scene.width, scene.height, diff.data() );
+			}
+		}
+
+		if( !isaDiffs.empty() )
+		{
+			std::printf( " DIFFERS WITH %s", isaDiffs.c_str() );
+			ok = false;
+		}
+
+		if( opts.timing )
+		{
+			double const ms = time_scene_ms_( scene, surface );
+			std::printf( " %10.4f ms", ms );
+
+			auto const it = baseline.find( scene.name );
+			if( opts.recordBaseline )
+			{
+				baseline[scene.name] = ms;
+			}
+			else if( baseline.end() != it && it->second > 0.0 )
+			{
+				double const change = 100.0 * (ms / it->second - 1.0);
+				std::printf( " (baseline %.4f ms, %+.1f%%)", it->second, change );
+
+				if( change > opts.threshold )
+				{
+					std::printf( " TOO SLOW" );
+					ok = false;
+				}
+			}
+		}
+
+		std::printf( "\n" );
+		failed += !ok;
+	}
+
+	if( opts.timing && opts.recordBaseline )
+	{
+		write_baseline_( opts.baseline, baseline );
+		std::printf( "Recorded baseline in '%s'\n", opts.baseline.c_str() );
+	}
+
+	std::printf( "%d of %d scenes failed\n", failed, checked );
+	return failed ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+catch( std::exception const& eErr )
+{
+	std::fprintf( stderr, "Top-level Exception (%s):\n", typeid(eErr).name() );
+	std::fprintf( stderr, "%s\n", eErr.what() );
+	std::fprintf( stderr, "Bye.\n" );
+	return 1;
+}
+
+
+namespace
+{
+	void synopsis_( char const* aName )
+	{
+		std::printf( "Usage: %s [options]\n", aName );
+		std::printf( "Run from the repository's root directory. Options:\n" );
+		std::printf( "  --help                : print this help and exit\n" );
+		std::printf( "  --update-references   : (re-)write the reference images instead of comparing\n" );
+		std::printf( "  --record-baseline     : record the timings as the new baseline\n" );
+		std::printf( "  --no-timing           : only compare images\n" );
+		std::printf( "  --threshold=P         : fail scenes that are more than P%% slower than the baseline (default %.0f)\n", kDefaultThreshold );
+		std::printf( "  --baseline=FILE       : baseline file (default %s)\n", kDefaultBaseline );
+		std::printf( "  --filter=S            : only run scenes whose name contains S\n" );
+		std::printf( "  --kernel-isa=ISA      : only check the draw2d kernels for ISA (auto, generic, sse2, avx2, avx512, neon)\n" );
+	}
+
+	Options_ parse_options_( int aArgc, char const* const* aArgv )
+	{
+		Options_ opts;
+
+		for( int i = 1; i < aArgc; ++i )
+		{
+			char name[128], value[512];
+			int ret = std::sscanf( aArgv[i], "--%127[a-zA-Z0-9_-]=%511s", name, value );
+
+			if( ret == 1 )
+			{
+				if( 0 == std::strcmp( "help", name ) )
+				{
+					synopsis_( aArgv[0] );
+					std::exit( 0 );
+				}
+				else if( 0 == std::strcmp( "update-references", name ) )
+					opts.updateReferences = true;
+				else if( 0 == std::strcmp( "record-baseline", name ) )
+					opts.recordBaseline = true;
+				else if( 0 == std::strcmp( "no-timing", name ) )
+					opts.timing = false;
+				else
+				{
+					throw Error( "Error while parsing command line\n"
+						"Unrecognized flag '--%s'\n"
+						"Use --help to print available command line options", name );
+				}
+			}
+			else if( ret == 2 )
+			{
+				char dummy;
+				if( 0 == std::strcmp( "threshold", name ) )
+				{
+					if( 1 != std::sscanf( value, "%lf%c", &opts.threshold, &dummy ) || !(opts.threshold >= 0.0) )
+					{
+						throw Error( "Error while parsing command line\n"
+							"Value '%s' not valid for --threshold; expected non-negative number\n"
+							"Use --help to print available command line options", value );
+					}
+				}
+				else if( 0 == std::strcmp( "baseline", name ) )
+					opts.baseline = value;
+				else if( 0 == std::strcmp( "filter", name ) )
+					opts.filter = value;
+				else if( 0 == std::strcmp( "kernel-isa", name ) )
+				{
+					if( !parse_kernel_isa( value, opts.kernelIsa ) || !kernel_isa_supported( opts.kernelIsa ) )
+					{
+						throw Error( "Error while parsing command line\n"
+							"Value '%s' not valid for --kernel-isa; not a known instruction set, or not supported by this CPU\n"
+							"Use --help to print available command line options", value );
+					}
+				}
+				else
+				{
+					throw Error( "Error while parsing command line\n"
+						"Unrecognized option '--%s'\n"
+						"Use --help to print available command line options", name );
+				}
+			}
+			else
+			{
+				throw Error( "Error while parsing command line\n"
+					"Unrecognized argument '%s'\n"
+					"Use --help to print available command line options", aArgv[i] );
+			}
+		}
+
+		return opts;
+	}
+
+
+	std::vector<std::uint8_t> to_rgb_( Surface const& aSurface )
+	{
+		auto const w = aSurface.get_width(), h = aSurface.get_height();
+		auto const* ptr = aSurface.get_surface_ptr();
+
+		std::vector<std::uint8_t> ret( std::size_t(w) * h * 3 );
+		for( std::size_t i = 0; i < std::size_t(w) * h; ++i )
+		{
+			ret[i*3+0] = ptr[i*4+0];
+			ret[i*3+1] = ptr[i*4+1];
+			ret[i*3+2] = ptr[i*4+2];
+		}
+		return ret;
+	}
+
+	bool write_png_( std::string const& aPath, std::uint32_t aWidth, std::uint32_t aHeight, std::uint8_t const* aRgb )
+	{
+		// The surface's first row is the bottom one; flip, so that the image
+		// files look like the window contents.
+		stbi_flip_vertically_on_write( 1 );
+		return 0 != stbi_write_png( aPath.c_str(), int(aWidth), int(aHeight), 3, aRgb, int(aWidth) * 3 );
+	}
+
+
+	double time_scene_ms_( Scene const& aScene, Surface& aSurface )
+	{
+		using Clock_ = std::chrono::steady_clock;
+
+		// Time aCount renders. The scenes do not blend, so drawing a scene
+		// again over itself is the same amount of work as drawing it into a
+		// cleared surface.
+		auto const sample = [&] ( std::size_t aCount ) {
+			aSurface.clear();
+
+			auto const start = Clock_::now();
+			for( std::size_t i = 0; i < aCount; ++i )
+				aScene.draw( aSurface );
+			auto const end = Clock_::now();
+
+			return std::chrono::duration<double>( end - start ).count();
+		};
+
+		std::size_t count = 1;
+		while( sample( count ) < kMinSampleSeconds )
+			count *= 2;
+
+		double best = sample( count ), total = best;
+		for( int i = 1; i < kMinSamples || total < kMinSeconds; ++i )
+		{
+			double const secs = sample( count );
+			best = std::min( best, secs );
+			total += secs;
+		}
+
+		return best / double(count) * 1000.0;
+	}
+
+
+	// The baseline is a small JSON file:
+	//
+	// {
+	//   "scenes": {
+	//     "<scene>": { "ms": <time> },
+	//     ...
+	//   }
+	// }
+	//
+	// read_baseline_() only understands this format (as written by
+	// write_baseline_()); it is not a general JSON parser.
+	std::unordered_map<std::string,double> read_baseline_( std::string const& aPath )
+	{
+		std::unordered_map<std::string,double> ret;
+
+		std::ifstream file( aPath );
+		if( !file )
+			return ret;
+
+		std::stringstream ss;
+		ss << file.rdbuf();
+		std::string const text = ss.str();
+
+		std::regex const entry( R"re("([^"]+)"\s*:\s*\{\s*"ms"\s*:\s*([-+0-9.eE]+)\s*\})re" );
+		for( std::sregex_iterator it( text.begin(), text.end(), entry ), end; it != end; ++it )
+			ret[(*it)[1].str()] = std::strtod( (*it)[2].str().c_str(), nullptr );
+
+		return ret;
+	}
+
+	void write_baseline_( std::string const& aPath, std::unordered_map<std::string,double> const& aTimes )
+	{
+		std::vector<std::pair<std::string,double>> sorted( aTimes.begin(), aTimes.end() );
+		std::sort( sorted.begin(), sorted.end() );
+
+		std::FILE* file = std::fopen( aPath.c_str(), "w" );
+		if( !file )
+			throw Error( "Unable to write baseline '%s'", aPath.c_str() );
+
+		std::fprintf( file, "{\n\t\"scenes\": {\n" );
+		for( std::size_t i = 0; i < sorted.size(); ++i )
+		{
+			std::fprintf( file, "\t\t\"%s\": { \"ms\": %.6f }%s\n", sorted[i].first.c_str(), sorted[i].second,
+				i + 1 < sorted.size() ? "," : "" );
+		}
+		std::fprintf( file, "\t}\n}\n" );
+		std::fclose( file );
+	}
+}
@@ -0,0 +1,411 @@
+#include "scenes.hpp"
+
+#include <memory>
+#include <numbers>
+#include <utility>
+
+#include "../draw2d/draw.hpp"
+#include "../draw2d/draw-ex.hpp"
+#include "../draw2d/image.hpp"
+#include "../draw2d/shape.hpp"
+#include "../draw2d/sprite.hpp"
+#include "../draw2d/surface.hpp"
+
+#include "../vmlib/mat22.hpp"
+#include "../vmlib/sincos.hpp"
+
+#include "../support/error.hpp"
+#include "../support/random.hpp"
+
+namespace
+{
+	constexpr std::uint32_t kWidth = 320;
+	constexpr std::uint32_t kHeight = 240;
+
+	constexpr float kPi = std::numbers::pi_v<float>;
+
+	// The scenes' inputs are generated with basic float arithmetic only
+	// (Xoshiro128, fast_sincos() and polynomials instead of std::sin(),
+	// std::exp(), ...), so that they do not depend on the standard library.
+
+	Vec2f direction_( float aAngle )
+	{
+		auto const sc = fast_sincos( aAngle );
+		return Vec2f{ sc.cos, sc.sin };
+	}
+
+	// Between aMin and aMax, with many more small values than large ones
+	float skewed_( Xoshiro128& aRng, float aMin, float aMax )
+	{
+		float const u = aRng.uniform();
+		return aMin + (aMax - aMin) * u*u*u;
+	}
+
+	ColorU8_sRGB random_color_( Xoshiro128& aRng )
+	{
+		auto const bits = aRng();
+		return ColorU8_sRGB{ std::uint8_t(bits), std::uint8_t(bits >> 8), std::uint8_t(bits >> 16) };
+	}
+
+	ColorF random_color_f_( Xoshiro128& aRng )
+	{
+		return ColorF{ aRng.uniform(), aRng.uniform(), aRng.uniform() };
+	}
+
+	// A point anywhere on the surface, or up to aMargin pixels beyond it
+	Vec2f random_point_( Xoshiro128& aRng, float aMargin )
+	{
+		return Vec2f{
+			aRng.uniform( -aMargin, kWidth + aMargin ),
+			aRng.uniform( -aMargin, kHeight + aMargin )
+		};
+	}
+
+	// Bumpy, roughly circular fan of radius aRadius, similar to the asteroids
+	TriangleFan make_rock_( Xoshiro128& aRng, std::size_t aPoints, float aRadius = 1.f )
+	{
+		std::vector<Vec2f> verts{ Vec2f{ 0.f, 0.f } };
+		std::vector<ColorF> colors{ random_color_f_( aRng ) };
+
+		for( std::size_t i = 0; i < aPoints; ++i )
+		{
+			float const angle = 2.f*kPi * i / aPoints;
+			float const r = aRadius * aRng.uniform( .75f, 1.f );
+
+			verts.emplace_back( r * direction_( angle ) );
+			colors.emplace_back( random_color_f_( aRng ) );
+		}
+
+		return TriangleFan( verts.size(), verts.data(), colors.data() );
+	}
+
+
+	// Lines
+	Scene lines_octants_()
+	{
+		// Spokes from the center in 64 directions (all octants, both
+		// directions, and the axis-aligned and diagonal special cases),
+		// plus spokes from off-center points at non-integer positions.
+		std::vector<std::pair<Vec2f,Vec2f>> segs;
+		for( int i = 0; i < 64; ++i )
+		{
+			float const angle = 2.f*kPi * i / 64.f;
+			Vec2f const dir = direction_( angle );
+
+			segs.emplace_back( Vec2f{ 80.f, 120.f }, Vec2f{ 80.f, 120.f } + 70.f * dir );
+			segs.emplace_back( Vec2f{ 240.3f, 119.7f } + 70.f * dir, Vec2f{ 240.3f, 119.7f } + 10.f * dir );
+		}
+
+		return Scene{ "lines-octants", kWidth, kHeight, [segs] ( Surface& aSurface ) {
+			for( auto const& s : segs )
+				draw_line_solid( aSurface, s.first, s.second, { 255, 255, 255 } );
+		} };
+	}
+
+	Scene lines_random_()
+	{
+		// Seeded segments, mostly short; a third of them start
+		// off screen, so both clipping and culling are exercised.
+		Xoshiro128 rng( 4501 );
+
+		struct Seg { Vec2f a, b; ColorU8_sRGB color; };
+		std::vector<Seg> segs;
+		for( int i = 0; i < 2000; ++i )
+		{
+			float const length = skewed_( rng, 1.f, 400.f );
+			float const angle = rng.uniform( 0.f, 2.f*kPi );
+
+			Vec2f const a = random_point_( rng, (i % 3) ? 0.f : 100.f );
+			Vec2f const b = a + length * direction_( angle );
+			segs.emplace_back( Seg{ a, b, random_color_( rng ) } );
+		}
+
+		return Scene{ "lines-random", kWidth, kHeight, [segs] ( Surface& aSurface ) {
+			for( auto const& s : segs )
+				draw_line_solid( aSurface, s.a, s.b, s.color );
+		} };
+	}
+
+	Scene line_strips_()
+	{
+		auto star = std::make_shared<LineStrip>( [] {
+			std::vector<Vec2f> verts;
+			for( int i = 0; i <= 10; ++i )
+			{
+				float const angle = 2.f*kPi * i / 10.f;
+				float const r = (i % 2) ? .4f : 1.f;
+				auto const sc = fast_sincos( angle );
+				verts.emplace_back( Vec2f{ r * sc.sin, -r * sc.cos } );
+			}
+			return LineStrip( verts.size(), verts.data() );
+		}() );
+
+		return Scene{ "line-strips", kWidth, kHeight, [star] ( Surface& aSurface ) {
+			for( int i = 0; i < 12; ++i )
+			{
+				float const scale = 10.f + 9.f * i;
+				Mat22f const xform = make_rotation_2d( .3f * i ) * Mat22f{ scale, 0.f, 0.f, scale };
+				Vec2f const pos{ 30.f + 26.5f * i, 120.f + ((i % 2) ? 40.f : -40.f) };
+
+				star->draw( aSurface, ColorF{ 1.f, .1f * i, .5f }, xform, pos );
+			}
+		} };
+	}
+
+
+	// Triangles
+	Scene triangles_solid_()
+	{
+		// Random triangles of all sizes and both windings, many of them
+		// crossing the surface's edges.
+		Xoshiro128 rng( 4502 );
+
+		struct Tri { Vec2f p[3]; ColorU8_sRGB color; };
+		std::vector<Tri> tris;
+		for( int i = 0; i < 400; ++i )
+		{
+			Vec2f const c = random_point_( rng, 30.f );
+			float const size = skewed_( rng, .5f, 120.f );
+
+			Tri t;
+			for( auto& p : t.p )
+				p = c + size * Vec2f{ rng.uniform( -1.f, 1.f ), rng.uniform( -1.f, 1.f ) };
+			t.color = random_color_( rng );
+			tris.emplace_back( t );
+		}
+
+		return Scene{ "triangles-solid", kWidth, kHeight, [tris] ( Surface& aSurface ) {
+			for( auto const& t : tris )
+				draw_triangle_solid( aSurface, t.p[0], t.p[1], t.p[2], t.color );
+		} };
+	}
+
+	Scene triangles_mesh_()
+	{
+		// A jittered grid, split into triangles that share all inner edges.
+		// Alternating colors make any gaps or double-covered pixels along
+		// the shared edges visible in the image.
+		Xoshiro128 rng( 4503 );
+
+		constexpr int kCols = 23, kRows = 17;
+		std::vector<Vec2f> grid;
+		for( int y = 0; y <= kRows; ++y )
+		{
+			for( int x = 0; x <= kCols; ++x )
+			{
+				Vec2f const jitter = (0 < x && x < kCols && 0 < y && y < kRows)
+					? Vec2f{ rng.uniform( -5.f, 5.f ), rng.uniform( -5.f, 5.f ) }
+					: Vec2f{ 0.f, 0.f };
+
+				grid.emplace_back( Vec2f{ -10.f + 15.f * x, -10.f + 15.f * y } + jitter );
+			}
+		}
+
+		return Scene{ "triangles-mesh", kWidth, kHeight, [grid] ( Surface& aSurface ) {
+			auto const at = [&] ( int aX, int aY ) { return grid[aY * (kCols+1) + aX]; };
+
+			for( int y = 0; y < kRows; ++y )
+			{
+				for( int x = 0; x < kCols; ++x )
+				{
+					auto const shade = std::uint8_t(60 + 8 * ((x + y) % 4));
+					draw_triangle_solid( aSurface, at( x, y ), at( x+1, y ), at( x, y+1 ), { shade, 200, 90 } );
+					draw_triangle_solid( aSurface, at( x+1, y ), at( x+1, y+1 ), at( x, y+1 ), { 200, shade, 90 } );
+				}
+			}
+		} };
+	}
+
+	Scene triangles_interp_()
+	{
+		Xoshiro128 rng( 4504 );
+
+		struct Tri { Vec2f p[3]; ColorF c[3]; };
+		std::vector<Tri> tris;
+		for( int i = 0; i < 60; ++i )
+		{
+			Vec2f const c = random_point_( rng, 20.f );
+			float const size = rng.uniform( 4.f, 90.f );
+
+			Tri t;
+			for( int j = 0; j < 3; ++j )
+			{
+				t.p[j] = c + size * Vec2f{ rng.uniform( -1.f, 1.f ), rng.uniform( -1.f, 1.f ) };
+				t.c[j] = random_color_f_( rng );
+			}
+			tris.emplace_back( t );
+		}
+
+		return Scene{ "triangles-interp", kWidth, kHeight, [tris] ( Surface& aSurface ) {
+			for( auto const& t : tris )
+				draw_triangle_interp( aSurface, t.p[0], t.p[1], t.p[2], t.c[0], t.c[1], t.c[2] );
+		} };
+	}
+
+	Scene triangles_wireframe_()
+	{
+		Xoshiro128 rng( 4505 );
+
+		struct Tri { Vec2f p[3]; ColorU8_sRGB color; };
+		std::vector<Tri> tris;
+		for( int i = 0; i < 150; ++i )
+		{
+			Vec2f const c = random_point_( rng, 20.f );
+			float const size = rng.uniform( 2.f, 60.f );
+
+			Tri t;
+			for( auto& p : t.p )
+				p = c + size * Vec2f{ rng.uniform( -1.f, 1.f ), rng.uniform( -1.f, 1.f ) };
+			t.color = random_color_( rng );
+			tris.emplace_back( t );
+		}
+
+		return Scene{ "triangles-wireframe", kWidth, kHeight, [tris] ( Surface& aSurface ) {
+			for( auto const& t : tris )
+				draw_triangle_wireframe( aSurface, t.p[0], t.p[1], t.p[2], t.color );
+		} };
+	}
+
+
+	// Fans and sprites
+	struct Placement_
+	{
+		Mat22f xform;
+		Vec2f pos;
+	};
+
+	std::vector<Placement_> make_placements_( Xoshiro128& aRng, std::size_t aCount, float aMinSize, float aMaxSize )
+	{
+		std::vector<Placement_> ret;
+		for( std::size_t i = 0; i < aCount; ++i )
+		{
+			float const size = aRng.uniform( aMinSize, aMaxSize );
+			Mat22f const xform = make_rotation_2d( aRng.uniform( 0.f, 2.f*kPi ) ) * Mat22f{ size, 0.f, 0.f, size };
+
+			ret.emplace_back( Placement_{ xform, random_point_( aRng, 10.f ) } );
+		}
+		return ret;
+	}
+
+	Scene fans_()
+	{
+		Xoshiro128 rng( 4506 );
+		auto rock = std::make_shared<TriangleFan>( make_rock_( rng, 14 ) );
+		auto const placements = make_placements_( rng, 40, 3.f, 40.f );
+
+		return Scene{ "fans", kWidth, kHeight, [rock, placements] ( Surface& aSurface ) {
+			for( auto const& pl : placements )
+				rock->draw( aSurface, pl.xform, pl.pos );
+		} };
+	}
+
+	Scene fans_wireframe_()
+	{
+		Xoshiro128 rng( 4507 );
+		auto rock = std::make_shared<TriangleFan>( make_rock_( rng, 11 ) );
+		auto const placements = make_placements_( rng, 40, 3.f, 40.f );
+
+		return Scene{ "fans-wireframe", kWidth, kHeight, [rock, placements] ( Surface& aSurface ) {
+			for( auto const& pl : placements )
+				rock->draw_wireframe( aSurface, ColorF{ .9f, .8f, .2f }, pl.xform, pl.pos );
+		} };
+	}
+
+	Scene sprites_()
+	{
+		Xoshiro128 rng( 4508 );
+		auto const rock = make_rock_( rng, 16, 24.f );
+		auto cache = std::make_shared<SpriteCache>( rock, 32 );
+
+		std::vector<std::pair<float,Vec2f>> placements;
+		for( int i = 0; i < 30; ++i )
+			placements.emplace_back( rng.uniform( 0.f, 2.f*kPi ), random_point_( rng, 10.f ) );
+
+		// SpriteCache::draw() takes a pure rotation; the sprites have the
+		// size of the fan they were rendered from.
+		return Scene{ "sprites", kWidth, kHeight, [cache, placements] ( Surface& aSurface ) {
+			for( auto const& pl : placements )
+				cache->draw( aSurface, make_rotation_2d( pl.first ), pl.second );
+		} };
+	}
+
+
+	// Rectangles, points and blits
+	Scene rectangles_()
+	{
+		Xoshiro128 rng( 4509 );
+
+		std::vector<ColoredRectangle> solid, outline;
+		for( int i = 0; i < 40; ++i )
+		{
+			Vec2f const a = random_point_( rng, 20.f );
+			Vec2f const b = a + Vec2f{ rng.uniform( .3f, 80.f ), rng.uniform( .3f, 50.f ) };
+			solid.emplace_back( ColoredRectangle{ a, b, random_color_( rng ) } );
+
+			Vec2f const c = random_point_( rng, 20.f );
+			Vec2f const d = c + Vec2f{ rng.uniform( .3f, 80.f ), rng.uniform( .3f, 50.f ) };
+			outline.emplace_back( ColoredRectangle{ c, d, random_color_( rng ) } );
+		}
+
+		return Scene{ "rectangles", kWidth, kHeight, [solid, outline] ( Surface& aSurface ) {
+			draw_rectangles_solid( aSurface, solid );
+			draw_rectangles_outline( aSurface, outline );
+		} };
+	}
+
+	Scene points_()
+	{
+		Xoshiro128 rng( 4510 );
+
+		std::vector<float> xs, ys;
+		for( int i = 0; i < 5000; ++i )
+		{
+			Vec2f const p = random_point_( rng, 10.f );
+			xs.emplace_back( p.x );
+			ys.emplace_back( p.y );
+		}
+
+		return Scene{ "points", kWidth, kHeight, [xs, ys] ( Surface& aSurface ) {
+			aSurface.draw_points( xs.size(), xs.data(), ys.data(), { 255, 240, 200 } );
+			aSurface.draw_points( xs.size(), xs.data(), ys.data(), { 120, 160, 255 }, 7.5f, -3.25f );
+		} };
+	}
+
+	Scene blit_()
+	{
+		std::shared_ptr<ImageRGBA> earth = load_image( "assets/earth.png" );
+		if( !earth )
+			throw Error( "Unable to load assets/earth.png (run from the repository's root directory)" );
+
+		// Blits that cross each of the surface's edges. blit_masked()
+		// truncates the position to whole pixels; the positions are whole
+		// numbers already, so that rounding of the inputs cannot shift them.
+		return Scene{ "blit-masked", kWidth, kHeight, [earth] ( Surface& aSurface ) {
+			auto const w = float(earth->get_width()), h = float(earth->get_height());
+
+			blit_masked( aSurface, *earth, { 80.f - w, 60.f - h } );
+			blit_masked( aSurface, *earth, { kWidth - 90.f, 50.f - h } );
+			blit_masked( aSurface, *earth, { 70.f - w, kHeight - 40.f } );
+			blit_masked( aSurface, *earth, { kWidth - 200.f, kHeight - 150.f } );
+		} };
+	}
+}
+
+std::vector<Scene> make_scenes()
+{
+	std::vector<Scene> ret;
+	ret.emplace_back( lines_octants_() );
+	ret.emplace_back( lines_random_() );
+	ret.emplace_back( line_strips_() );
+	ret.emplace_back( triangles_solid_() );
+	ret.emplace_back( triangles_mesh_() );
+	ret.emplace_back( triangles_interp_() );
+	ret.emplace_back( triangles_wireframe_() );
+	ret.emplace_back( fans_() );
+	ret.emplace_back( fans_wireframe_() );
+	ret.emplace_back( sprites_() );
+	ret.emplace_back( rectangles_() );
+	ret.emplace_back( points_() );
+	ret.emplace_back( blit_() );
+	return ret;
+}
@@ -0,0 +1,31 @@
+#ifndef SCENES_HPP_2FCFE85E_7437_4B1A_91CD_E636AF48705F
+#define SCENES_HPP_2FCFE85E_7437_4B1A_91CD_E636AF48705F
+
+#include <string>
+#include <vector>
+#include <functional>
+
+#include <cstdint>
+
+#include "../draw2d/forward.hpp"
+
+/* One scene of the golden-image corpus. draw() renders the scene into a
+ * cleared aWidth x aHeight surface; it must produce exactly the same pixels
+ * every time it is called. Any random input is generated up front, when the
+ * scene is created, so that draw() only measures the drawing itself.
+ */
+struct Scene
+{
+	std::string name;
+	std::uint32_t width, height;
+	std::function<void (Surface&)> draw;
+};
+
+/* The corpus. Each scene exercises one of the draw2d primitives (or a small
+ * group of them), including the cases that optimized implementations tend
+ * to get wrong: clipping at all four edges, all line octants, shared
+ * triangle edges, sub-pixel sizes and positions.
+ */
+std::vector<Scene> make_scenes();
+
+#endif // SCENES_HPP_2FCFE85E_7437_4B1A_91CD_E636AF48705F
@@ -0,0 +1,19 @@
+#ifndef DDA_HPP_0EA2D1D8_8A1A_43B1_8753_891013F7EF35
+#define DDA_HPP_0EA2D1D8_8A1A_43B1_8753_891013F7EF35
+
+#include "../draw2d/forward.hpp"
+#include "../draw2d/color.hpp"
+
+#include "../vmlib/vec2.hpp"
+
+// Reference line drawing with a floating point DDA (one step per pixel
+// along the major axis, with rounding). Same endpoint handling as
+// draw_line_solid(): endpoints are truncated to integers, and each pixel is
+// clipped against the surface.
+void draw_line_solid_dda(
+	Surface&,
+	Vec2f aBegin, Vec2f aEnd,
+	ColorU8_sRGB
+);
+
+#endif // DDA_HPP_0EA2D1D8_8A1A_43B1_8753_891013F7EF35
@@ -0,0 +1,219 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <numbers>
+#include <algorithm>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include "../draw2d/draw.hpp"
+#include "../draw2d/surface-ex.hpp"
+
+#include "../support/random.hpp"
+#include "../support/hwcounters.hpp"
+
+#include "dda.hpp"
+
+// Line drawing over large, seeded batches of random segments, for
+// draw_line_solid() and draw_line_solid_dda(). The arguments are
+//  - w, h:     surface resolution
+//  - min, max: segment lengths in pixels. Lengths are log-uniform in
+//              [min, max], so that a wide range gives many short segments
+//              and a few long ones, as in typical line art and wireframes.
+//  - off%:     percentage of segments that start outside of the surface.
+//              These either cross into the surface (and are clipped) or
+//              miss it entirely (and are culled).
+//
+// Directions are uniform over all angles, so all eight octants (and both
+// directions along each) are covered. Every iteration draws the same batch
+// of kBatch segments.
+//
+// Items are drawn pixels (counted exactly), so items_per_second is pixels/s;
+// "segments" is the rate in segments/s. Where hardware counters are
+// available, instructions and cache misses per pixel and the IPC are reported
+// as well (see add_hw_counters()).
+namespace
+{
+	using DrawLine_ = void (*)( Surface&, Vec2f, Vec2f, ColorU8_sRGB );
+
+	constexpr std::size_t kBatch = 8192;
+	constexpr std::uint32_t kSeed = 1234;
+
+	struct Segment_
+	{
+		Vec2f begin, end;
+	};
+
+	struct Case_
+	{
+		std::uint32_t width, height;
+		float minLength, maxLength;
+		float offscreen;
+	};
+
+	Case_ get_case_( benchmark::State const& aState )
+	{
+		return Case_{
+			std::uint32_t(aState.range(0)), std::uint32_t(aState.range(1)),
+			float(aState.range(2)), float(aState.range(3)),
+			float(aState.range(4)) / 100.f
+		};
+	}
+
+	std::vector<Segment_> make_segments_( Case_ const& aCase )
+	{
+		float const w = float(aCase.width), h = float(aCase.height);
+		float const logMin = std::log( aCase.minLength ), logMax = std::log( aCase.maxLength );
+
+		Xoshiro128 rng( kSeed );
+
+		std::vector<Segment_> ret;
+		ret.reserve( kBatch );
+		for( std::size_t i = 0; i < kBatch; ++i )
+		{
+			float const length = std::exp( rng.uniform( logMin, logMax ) );
+			float const angle = rng.uniform( 0.f, 2.f*std::numbers::pi_v<float> );
+			Vec2f dir{ std::cos( angle ), std::sin( angle ) };
+
+			Vec2f begin;
+			if( rng.uniform() < aCase.offscreen )
+			{
+				// Start up to one segment length beyond one of the four edges.
+				// The endpoints are truncated towards zero when drawn, so stay
+				// a pixel clear of the surface.
+				float const along = rng.uniform();
+				float const away = rng.uniform( 1.f, length + 1.f );
+				switch( i % 4 )
+				{
+					case 0: begin = Vec2f{ -away, along * h }; break;
+					case 1: begin = Vec2f{ w + away, along * h }; break;
+					case 2: begin = Vec2f{ along * w, -away }; break;
+					case 3: begin = Vec2f{ along * w, h + away }; break;
+				}
+
+				ret.emplace_back( Segment_{ begin, begin + length * dir } );
+				continue;
+			}
+
+			// On-screen: mirror the direction if the segment would leave the
+			// surface, and clamp long segments to its edges.
+			begin = Vec2f{ rng.uniform( 0.f, w ), rng.uniform( 0.f, h ) };
+
+			Vec2f end = begin + length * dir;
+			if( end.x < 0.f || end.x >= w ) dir.x = -dir.x;
+			if( end.y < 0.f || end.y >= h ) dir.y = -dir.y;
+
+			end = begin + length * dir;
+			end.x = std::clamp( end.x, 0.f, w - .5f );
+			end.y = std::clamp( end.y, 0.f, h - .5f );
+
+			ret.emplace_back( Segment_{ begin, end } );
+		}
+
+		return ret;
+	}
+
+	// Pixels written when drawing all segments with aDraw. Each segment is
+	// drawn on its own; set_pixel_srgb() clears the padding byte, which marks
+	// the written pixels. Both algorithms write at most one pixel per step
+	// along the major axis, within a pixel of the ideal line, so only those
+	// pixels need to be scanned (and reset).
+	std::int64_t count_pixels_( DrawLine_ aDraw, Case_ const& aCase, std::vector<Segment_> const& aSegments )
+	{
+		SurfaceEx surface( aCase.width, aCase.height );
+		std::uint8_t* const ptr = surface.get_surface_ptr();
+		std::memset( ptr, 0xff, std::size_t(aCase.width)*aCase.height*4 );
+
+		auto const w = std::int64_t(aCase.width), h = std::int64_t(aCase.height);
+
+		std::int64_t ret = 0;
+		for( auto const& seg : aSegments )
+		{
+			aDraw( surface, seg.begin, seg.end, { 255, 255, 255 } );
+
+			std::int64_t const x0 = std::int64_t(seg.begin.x), y0 = std::int64_t(seg.begin.y);
+			std::int64_t const x1 = std::int64_t(seg.end.x), y1 = std::int64_t(seg.end.y);
+
+			bool const steep = std::abs( y1 - y0 ) > std::abs( x1 - x0 );
+			std::int64_t const a0 = steep ? y0 : x0, a1 = steep ? y1 : x1;
+			std::int64_t const b0 = steep ? x0 : y0, b1 = steep ? x1 : y1;
+			std::int64_t const aSize = steep ? h : w, bSize = steep ? w : h;
+
+			std::int64_t const first = std::max( std::min( a0, a1 ), std::int64_t(0) );
+			std::int64_t const last = std::min( std::max( a0, a1 ), aSize - 1 );
+			for( std::int64_t a = first; a <= last; ++a )
+			{
+				double const b = (a0 == a1) ? double(b0) : b0 + double(a - a0) * (b1 - b0) / (a1 - a0);
+				auto const bc = std::int64_t(std::floor( b ));
+
+				for( std::int64_t bb = std::max( bc - 1, std::int64_t(0) ); bb <= std::min( bc + 2, bSize - 1 ); ++bb )
+				{
+					std::int64_t const x = steep ? bb : a, y = steep ? a : bb;
+					std::uint8_t* const pixel = ptr + (y*w + x)*4;
+
+					ret += (0 == pixel[3]);
+					std::memset( pixel, 0xff, 4 );
+				}
+			}
+		}
+
+		return ret;
+	}
+
+	void segments_( benchmark::State& aState, DrawLine_ aDraw )
+	{
+		auto const cs = get_case_( aState );
+		auto const segments = make_segments_( cs );
+
+		SurfaceEx surface( cs.width, cs.height );
+		surface.clear();
+
+		HwCounters hw;
+		hw.start();
+
+		for( auto _ : aState )
+		{
+			for( auto const& seg : segments )
+				aDraw( surface, seg.begin, seg.end, { 255, 255, 255 } );
+
+			benchmark::ClobberMemory();
+		}
+
+		hw.stop();
+
+		auto const pixels = count_pixels_( aDraw, cs, segments );
+		aState.SetItemsProcessed( pixels * aState.iterations() );
+		add_hw_counters( aState, hw, double(pixels) * aState.iterations() );
+		aState.counters["segments"] = benchmark::Counter( double(segments.size()), benchmark::Counter::kIsIterationInvariantRate );
+		aState.counters["px/segment"] = double(pixels) / segments.size();
+	}
+
+	// Short, medium, long and mixed lengths on screen, then the mixed lengths
+	// with more and more segments starting off screen, and the mixed lengths
+	// at other resolutions.
+	void distributions_( benchmark::internal::Benchmark* aBench )
+	{
+		aBench->ArgNames( { "w", "h", "min", "max", "off%" } );
+
+		std::int64_t const lengths[][2] = { { 1, 16 }, { 16, 128 }, { 256, 2048 }, { 1, 2048 } };
+		for( auto const& len : lengths )
+			aBench->Args( { 1920, 1080, len[0], len[1], 0 } );
+
+		for( std::int64_t off : { 25, 50, 100 } )
+			aBench->Args( { 1920, 1080, 1, 2048, off } );
+
+		std::int64_t const resolutions[][2] = { { 320, 240 }, { 1280, 720 }, { 7680, 4320 } };
+		for( auto const& res : resolutions )
+			aBench->Args( { res[0], res[1], 1, 2048, 0 } );
+	}
+}
+
+BENCHMARK_CAPTURE( segments_, bresenham, &draw_line_solid )
+	->Apply( distributions_ )
+;
+BENCHMARK_CAPTURE( segments_, dda, &draw_line_solid_dda )
+	->Apply( distributions_ )
+;
@@ -4,56 +4,7 @@
 #include "../draw2d/draw-ex.hpp"
 #include "../draw2d/surface-ex.hpp"
 
-void draw_line_solid_dda(Surface &aSurface, Vec2f aBegin, Vec2f aEnd, ColorU8_sRGB aColor)
-{
-    // Extract integer coordinates of start and end points
-    int x0 = static_cast<int>(aBegin.x);
-    int y0 = static_cast<int>(aBegin.y);
-    int x1 = static_cast<int>(aEnd.x);
-    int y1 = static_cast<int>(aEnd.y);
-
-    // Get screen boundaries
-    int width = aSurface.get_width();
-    int height = aSurface.get_height();
-
-    // Check if the entire line is outside the screen bounds
-    if ((x0 < 0 && x1 < 0) || (x0 >= width && x1 >= width) ||
-        (y0 < 0 && y1 < 0) || (y0 >= height && y1 >= height))
-    {
-        return; // Entire line is out of bounds, no need to draw
-    }
-
-    // Calculate dx and dy
-    float dx = x1 - x0;
-    float dy = y1 - y0;
-
-    // Determine the number of steps required for the line
-    int steps = std::max(std::abs(dx), std::abs(dy));
-
-    // Calculate the increment for each step
-    float xIncrement = dx / steps;
-    float yIncrement = dy / steps;
-
-    // Initialize starting position
-    float x = x0;
-    float y = y0;
-
-    // Drawing loop with clipping
-    for (int i = 0; i <= steps; ++i)
-    {
-        // Draw current pixel only if it's within bounds
-        int xi = static_cast<int>(std::round(x));
-        int yi = static_cast<int>(std::round(y));
-        if (xi >= 0 && xi < width && yi >= 0 && yi < height)
-        {
-            aSurface.set_pixel_srgb(xi, yi, aColor);
-        }
-
-        // Increment x and y for the next step
-        x += xIncrement;
-        y += yIncrement;
-    }
-}
+#include "dda.hpp"
 
 namespace
 {
@@ -11,6 +11,7 @@
 #include "../draw2d/surface.hpp"
 #include "../draw2d/draw.hpp"
 #include "../draw2d/shape.hpp"
+#include "../draw2d/kernels.hpp"
 
 #include "../support/error.hpp"
 #include "../support/context.hpp"
@@ -43,6 +44,10 @@ try
 	// Parse command line arguments
 	RuntimeConfig const config = parse_command_line(aArgc, aArgv);
 
+	KernelIsa kernelIsa{};
+	if (!parse_kernel_isa(config.kernelIsa.c_str(), kernelIsa) || !select_kernels(kernelIsa))
+		throw Error("Kernel instruction set '%s' is unknown or not available", config.kernelIsa.c_str());
+
 	// Initialize GLFW
 	if (GLFW_TRUE != glfwInit())
 	{
@@ -1,6 +1,5 @@
 #include "asteroid.hpp"
 
-#include <random>
 #include <vector>
 #include <numbers>
 #include <algorithm>
@@ -13,13 +12,13 @@
 #include "../vmlib/vec2.hpp"
 #include "../vmlib/mat22.hpp"
 
-TriangleFan make_asteroid( std::minstd_rand& aRNG, std::size_t aNumPoints, float aRadiusMean, float aRadiusStddev, float aSquishStddev, float aDisplaceStddev, ColorF const& aBaseColor, float aColorBaseStddev, float aColorVar )
+TriangleFan make_asteroid( RNG& aRNG, std::size_t aNumPoints, float aRadiusMean, float aRadiusStddev, float aSquishStddev, float aDisplaceStddev, ColorF const& aBaseColor, float aColorBaseStddev, float aColorVar )
 {
 	// Sample general parameters
-	float const radius = std::normal_distribution<float>{aRadiusMean, aRadiusStddev}(aRNG);
-	float const squish = std::normal_distribution<float>{1.f, aSquishStddev}(aRNG);
+	float const radius = aRNG.normal( aRadiusMean, aRadiusStddev );
+	float const squish = aRNG.normal( 1.f, aSquishStddev );
 
-	float crand = std::normal_distribution<float>{ 0.f, aColorBaseStddev }(aRNG);
+	float crand = aRNG.normal( 0.f, aColorBaseStddev );
 
 	ColorF baseColor = aBaseColor;
 	baseColor.r = std::clamp( baseColor.r + crand, 0.1f, 1.f );
@@ -42,10 +41,9 @@ TriangleFan make_asteroid( std::minstd_rand& aRNG, std::size_t aNumPoints, float
 	}
 
 	// Displace vertices
-	std::normal_distribution<float> displace( 0.f, aDisplaceStddev );
 	for( auto& vert : verts )
 	{
-		float const displacement = displace( aRNG );
+		float const displacement = aRNG.normal( 0.f, aDisplaceStddev );
 		float const length = std::sqrt( dot( vert, vert ) );
 		Vec2f const delta = (displacement / length) * vert;
 
@@ -59,13 +57,11 @@ TriangleFan make_asteroid( std::minstd_rand& aRNG, std::size_t aNumPoints, float
 		vert.x *= squish;
 
 	// Generate colors
-	std::uniform_real_distribution<float> cdist( -aColorVar, aColorVar );
-
 	std::vector<ColorF> colors;
 	colors.reserve( aNumPoints + 1 );
 	for( std::size_t i = 0; i < aNumPoints; ++i )
 	{
-		float cvar = cdist(aRNG);
+		float cvar = aRNG.uniform( -aColorVar, aColorVar );
 
 		ColorF col = baseColor;
 		col.r = std::clamp( col.r + cvar, 0.f, 1.f );
@@ -1,21 +1,52 @@
 #include "asteroid_field.hpp"
 
-#include <random>
+#include <memory>
 #include <numbers>
 #include <algorithm>
 
 #include <cassert>
 
 #include "../draw2d/shape.hpp"
+#include "../draw2d/sprite.hpp"
+
+#include "../vmlib/transform.hpp"
+
+#include "../support/profiler.hpp"
 
 #include "asteroid.hpp"
 
-AsteroidField::AsteroidField( RNG& aRNG, std::uint32_t aWidth, std::uint32_t aHeight, float aDensity, float aInitialSpeedStddev, float aMaximumSpeed, float aInitialRotStddev, float aPadding )
-	: mInitialSpeed( aInitialSpeedStddev )
+namespace
+{
+	// Each update multiplies the asteroids' rotations by a small step
+	// rotation. Rounding errors make the matrices drift away from pure
+	// rotations over time; every so many updates, they are corrected.
+	constexpr std::size_t kOrthonormalizeInterval = 256;
+}
+
+struct AsteroidField::Shape
+{
+	TriangleFan fan;
+	std::unique_ptr<SpriteCache const> sprites; // null if disabled
+
+	void draw( Surface& aSurface, Mat22f const& aRotation, Vec2f const& aTranslation ) const
+	{
+		if( sprites )
+			sprites->draw( aSurface, aRotation, aTranslation );
+		else
+			fan.draw( aSurface, aRotation, aTranslation );
+	}
+};
+
+AsteroidField::AsteroidField( RNG& aRNG, std::uint32_t aWidth, std::uint32_t aHeight, std::size_t aSpriteRotations, float aDensity, float aInitialSpeedStddev, float aMaximumSpeed, float aInitialRotStddev, float aPadding )
+	: mSpriteRotations( aSpriteRotations )
+	, mInitialSpeed( aInitialSpeedStddev )
 	, mMaximumSpeed( aMaximumSpeed )
 	, mInitialRot( aInitialRotStddev )
 	, mPadding( aPadding )
 	, mDensity( aDensity )
+	, mLastElapsed( 0.f )
+	, mLastMovement{ 0.f, 0.f }
+	, mUpdatesSinceOrthonormalize( 0 )
 	, mRNG( aRNG )
 {
 	// Compute area of simulation
@@ -33,32 +64,29 @@ AsteroidField::AsteroidField( RNG& aRNG, std::uint32_t aWidth, std::uint32_t aHe
 	mAsteroids.resize( numAsteroids );
 	mShapes.reserve( numAsteroids ); // reserve! not resize!
 
-	using Uniform_ = std::uniform_real_distribution<float>;
-	using Normal_ = std::normal_distribution<float>;
-
-	Uniform_ xpos{ mBoundsMin.x, mBoundsMax.x };
-	Uniform_ ypos{ mBoundsMin.y, mBoundsMax.y };
+	auto const xpos = [&] { return mRNG.uniform( mBoundsMin.x, mBoundsMax.x ); };
+	auto const ypos = [&] { return mRNG.uniform( mBoundsMin.y, mBoundsMax.y ); };
 
-	Uniform_ angle( 0.f, 2*std::numbers::pi_v<float> );
+	auto const angle = [&] { return mRNG.uniform( 0.f, 2*std::numbers::pi_v<float> ); };
 
-	Normal_ vvel{ 0.f, mInitialSpeed };
-	Normal_ rots{ 0.f, mInitialRot };
+	auto const vvel = [&] { return mRNG.normal( 0.f, mInitialSpeed ); };
+	auto const rots = [&] { return mRNG.normal( 0.f, mInitialRot ); };
 
 	for( std::size_t i = 0; i < numAsteroids; ++i )
 	{
 		auto& astr = mAsteroids[i];
-		astr.pos = Vec2f{ xpos( mRNG ), ypos( mRNG ) };
-		astr.vel = Vec2f{ vvel( mRNG ), vvel( mRNG ) };
+		astr.pos = Vec2f{ xpos(), ypos() };
+		astr.vel = Vec2f{ vvel(), vvel() };
 
-		astr.rot = make_rotation_2d( angle( mRNG ) );
-		astr.radpersec = rots( mRNG );
+		astr.rot = make_rotation_2d( angle() );
+		astr.radpersec = rots();
 
 		// Don't break the speed limits. The space police will get you!
 		astr.vel.x = std::clamp( astr.vel.x, -mMaximumSpeed, +mMaximumSpeed );
 		astr.vel.y = std::clamp( astr.vel.y, -mMaximumSpeed, +mMaximumSpeed );
 
 		// Create shape
-		mShapes.emplace_back( make_asteroid( mRNG ) );
+		mShapes.emplace_back( make_shape_() );
 	}
 }
 
@@ -67,19 +95,33 @@ AsteroidField::~AsteroidField() = default;
 
 void AsteroidField::update( float aElapsed, Vec2f const& aTransl )
 {
+	PROFILE_ZONE( "AsteroidField::update" );
+
 	auto const numAsteroids = mAsteroids.size();
 	assert( numAsteroids == mShapes.size() );
 
-	using Uniform_ = std::uniform_real_distribution<float>;
-	using Normal_ = std::normal_distribution<float>;
+	mLastElapsed = aElapsed;
+	mLastMovement = aTransl;
+
+	// Rotation steps for all asteroids at once
+	mStepAngles.resize( numAsteroids );
+	mStepRotations.resize( numAsteroids );
+	for( std::size_t i = 0; i < numAsteroids; ++i )
+		mStepAngles[i] = mAsteroids[i].radpersec * aElapsed;
+
+	make_rotations_2d( mStepAngles, mStepRotations );
+
+	bool const orthonormalize = ++mUpdatesSinceOrthonormalize >= kOrthonormalizeInterval;
+	if( orthonormalize )
+		mUpdatesSinceOrthonormalize = 0;
 
-	Uniform_ xpos{ mBoundsMin.x, mBoundsMax.x };
-	Uniform_ ypos{ mBoundsMin.y, mBoundsMax.y };
+	auto const xpos = [&] { return mRNG.uniform( mBoundsMin.x, mBoundsMax.x ); };
+	auto const ypos = [&] { return mRNG.uniform( mBoundsMin.y, mBoundsMax.y ); };
 
-	Uniform_ angle( 0.f, 2*std::numbers::pi_v<float> );
+	auto const angle = [&] { return mRNG.uniform( 0.f, 2*std::numbers::pi_v<float> ); };
 
-	Normal_ vvel{ 0.f, mInitialSpeed };
-	Normal_ rots{ 0.f, mInitialRot };
+	auto const vvel = [&] { return mRNG.normal( 0.f, mInitialSpeed ); };
+	auto const rots = [&] { return mRNG.normal( 0.f, mInitialRot ); };
 
 	for( std::size_t i = 0; i < numAsteroids; ++i )
 	{
@@ -100,45 +142,50 @@ void AsteroidField::update( float aElapsed, Vec2f const& aTransl )
 			if( astr.pos.x < mBoundsMin.x )
 			{
 				astr.pos.x = mBoundsMax.x - mPadding/2.f;
-				astr.pos.y = ypos( mRNG );
+				astr.pos.y = ypos();
 			}
 			else if( astr.pos.x > mBoundsMax.x )
 			{
 				astr.pos.x = mBoundsMin.x + mPadding/2.f;
-				astr.pos.y = ypos( mRNG );
+				astr.pos.y = ypos();
 			}
 			else if( astr.pos.y < mBoundsMin.y )
 			{
-				astr.pos.x = xpos( mRNG );
+				astr.pos.x = xpos();
 				astr.pos.y = mBoundsMax.y - mPadding/2.f;
 			}
 			else if( astr.pos.y > mBoundsMax.y )
 			{
-				astr.pos.x = xpos( mRNG );
+				astr.pos.x = xpos();
 				astr.pos.y = mBoundsMin.y + mPadding/2.f;
 			}
 
-			astr.vel = Vec2f{ vvel( mRNG ), vvel( mRNG ) };
+			astr.vel = Vec2f{ vvel(), vvel() };
 
-			astr.rot = make_rotation_2d( angle( mRNG ) );
-			astr.radpersec = rots( mRNG );
+			astr.rot = make_rotation_2d( angle() );
+			astr.radpersec = rots();
 
 			// Don't break the speed limits. The space police will get you!
 			astr.vel.x = std::clamp( astr.vel.x, -mMaximumSpeed, +mMaximumSpeed );
 			astr.vel.y = std::clamp( astr.vel.y, -mMaximumSpeed, +mMaximumSpeed );
 
 			// Create shape
-			mShapes[i] = make_asteroid( mRNG );
+			mShapes[i] = make_shape_();
 		}
 		else
 		{
-			astr.rot = make_rotation_2d( astr.radpersec * aElapsed ) * astr.rot;
+			astr.rot = mStepRotations[i] * astr.rot;
+
+			if( orthonormalize )
+				astr.rot = orthonormalize_rotation_2d( astr.rot );
 		}
 	}
 }
 
 void AsteroidField::draw( Surface& aSurface ) const
 {
+	PROFILE_ZONE( "AsteroidField::draw" );
+
 	auto const numAsteroids = mAsteroids.size();
 	assert( numAsteroids == mShapes.size() );
 
@@ -150,7 +197,7 @@ void AsteroidField::draw( Surface& aSurface ) const
 		// Performance: culling asteroids here would remove some work; right
 		// now each triangle will be culled individually.
 
-		shape.draw(
+		shape->draw(
 			aSurface,
 			astr.rot,
 			astr.pos
@@ -158,6 +205,49 @@ void AsteroidField::draw( Surface& aSurface ) const
 	}
 }
 
+void AsteroidField::capture( Snapshot& aSnapshot ) const
+{
+	auto const numAsteroids = mAsteroids.size();
+	assert( numAsteroids == mShapes.size() );
+
+	aSnapshot.items.resize( numAsteroids );
+	for( std::size_t i = 0; i < numAsteroids; ++i )
+	{
+		auto const& astr = mAsteroids[i];
+
+		// Asteroids that were respawned during the last update have jumped;
+		// reconstructing their movement from the current velocity places them
+		// near the new spawn position instead.
+		auto& item = aSnapshot.items[i];
+		item.pos = astr.pos;
+		item.step = astr.vel * mLastElapsed - mLastMovement;
+		item.rot = astr.rot;
+		item.stepAngle = astr.radpersec * mLastElapsed;
+	}
+
+	aSnapshot.shapes.assign( mShapes.begin(), mShapes.end() );
+}
+
+void AsteroidField::draw( Surface& aSurface, Snapshot const& aSnapshot, float aInterpolation )
+{
+	PROFILE_ZONE( "AsteroidField::draw" );
+
+	auto const numAsteroids = aSnapshot.items.size();
+	assert( numAsteroids == aSnapshot.shapes.size() );
+
+	float const back = 1.f - aInterpolation;
+
+	for( std::size_t i = 0; i < numAsteroids; ++i )
+	{
+		auto const& item = aSnapshot.items[i];
+
+		Vec2f const pos = item.pos - back * item.step;
+		Mat22f const rot = make_rotation_2d( -back * item.stepAngle ) * item.rot;
+
+		aSnapshot.shapes[i]->draw( aSurface, rot, pos );
+	}
+}
+
 void AsteroidField::resize( std::uint32_t aWidth, std::uint32_t aHeight )
 {
 	// WARNING: This is a bit of a hack...
@@ -205,9 +295,6 @@ void AsteroidField::resize( std::uint32_t aWidth, std::uint32_t aHeight )
 	assert( mShapes.size() == activeAsteroids );
 
 	// Generate new asteroids.
-	using Normal_ = std::normal_distribution<float>;
-	using Uniform_ = std::uniform_real_distribution<float>;
-
 	if( activeAsteroids < numAsteroids )
 	{
 		auto dd = mBoundsMax - oldMax;
@@ -217,40 +304,40 @@ void AsteroidField::resize( std::uint32_t aWidth, std::uint32_t aHeight )
 		float xarea = dd.x * mBoundsMax.y;
 		float yarea = dd.y * (mBoundsMax.x - dd.x);
 
-		Uniform_ area( 0.f, xarea+yarea );
-		Uniform_ xax( oldMax.x, oldMax.x+dd.x );
-		Uniform_ xay( 0.f, mBoundsMax.y );
-		Uniform_ yax( 0.f, mBoundsMax.x - dd.x );
-		Uniform_ yay( oldMax.y, oldMax.y+dd.y );
+		auto const area = [&] { return mRNG.uniform( 0.f, xarea+yarea ); };
+		auto const xax = [&] { return mRNG.uniform( oldMax.x, oldMax.x+dd.x ); };
+		auto const xay = [&] { return mRNG.uniform( 0.f, mBoundsMax.y ); };
+		auto const yax = [&] { return mRNG.uniform( 0.f, mBoundsMax.x - dd.x ); };
+		auto const yay = [&] { return mRNG.uniform( oldMax.y, oldMax.y+dd.y ); };
 
-		Uniform_ angle( 0.f, 2*std::numbers::pi_v<float> );
+		auto const angle = [&] { return mRNG.uniform( 0.f, 2*std::numbers::pi_v<float> ); };
 
-		Normal_ vvel{ 0.f, mInitialSpeed };
-		Normal_ rots{ 0.f, mInitialRot };
+		auto const vvel = [&] { return mRNG.normal( 0.f, mInitialSpeed ); };
+		auto const rots = [&] { return mRNG.normal( 0.f, mInitialRot ); };
 
 		for( std::size_t i = activeAsteroids; i < numAsteroids; ++i )
 		{
 			Vec2f pos;
 
-			auto const where = area(mRNG);
+			auto const where = area();
 			if( where <= xarea )
 			{
-				pos.x = xax( mRNG );
-				pos.y = xay( mRNG );
+				pos.x = xax();
+				pos.y = xay();
 			}
 			else
 			{
-				pos.x = yax( mRNG );
-				pos.y = yay( mRNG );
+				pos.x = yax();
+				pos.y = yay();
 			}
 
 			auto& astr = mAsteroids[i];
 
 			astr.pos = pos;
-			astr.vel = Vec2f{ vvel( mRNG ), vvel( mRNG ) };
+			astr.vel = Vec2f{ vvel(), vvel() };
 
-			astr.rot = make_rotation_2d( angle( mRNG ) );
-			astr.radpersec = rots( mRNG );
+			astr.rot = make_rotation_2d( angle() );
+			astr.radpersec = rots();
 
 			// Don't break the speed limits. The space police will get you!
 			astr.vel.x = std::clamp( astr.vel.x, -mMaximumSpeed, +mMaximumSpeed );
@@ -258,10 +345,21 @@ void AsteroidField::resize( std::uint32_t aWidth, std::uint32_t aHeight )
 
 			// Create shape
 			assert( i == mShapes.size() );
-			mShapes.emplace_back( make_asteroid( mRNG ) );
+			mShapes.emplace_back( make_shape_() );
 		}
 	}
 
 	assert( mAsteroids.size() == mShapes.size() );
 }
 
+std::shared_ptr<AsteroidField::Shape const> AsteroidField::make_shape_()
+{
+	auto shape = std::make_shared<Shape>( Shape{ make_asteroid( mRNG ), nullptr } );
+
+	// The sprites are rendered up front, when the asteroid is created. This
+	// happens during updates, so drawing never has to wait for it.
+	if( mSpriteRotations )
+		shape->sprites = std::make_unique<SpriteCache const>( shape->fan, mSpriteRotations );
+
+	return shape;
+}
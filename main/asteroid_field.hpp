@@ -1,6 +1,7 @@
 #ifndef ASTEROID_FIELD_HPP_7D5A0B40_4466_4CAC_B7CC_85E8DC927E08
 #define ASTEROID_FIELD_HPP_7D5A0B40_4466_4CAC_B7CC_85E8DC927E08
 
+#include <memory>
 #include <vector>
 
 #include <cstdlib>
@@ -25,6 +26,11 @@
  *
  * With the current implementation, the asteroid field is a purely visual
  * effect.
+ *
+ * Asteroids only ever rotate and translate. With aSpriteRotations > 0, each
+ * asteroid's shape is pre-rendered at that many rotations when the asteroid
+ * is created (see SpriteCache), and drawing just copies the pixels of the
+ * closest rotation. Otherwise the shapes are rasterized each frame.
  */
 class AsteroidField
 {
@@ -32,6 +38,7 @@ class AsteroidField
 		AsteroidField(
 			RNG&,
 			std::uint32_t aImageWidth, std::uint32_t aImageHeight,
+			std::size_t aSpriteRotations = 0,
 			float aDensity = 1e-5f,
 			float aInitialSpeedStddev = 100.f,
 			float aMaximumSpeed = 500.f,
@@ -52,6 +59,36 @@ class AsteroidField
 
 		void resize( std::uint32_t aWidth, std::uint32_t aHeight );
 
+	public:
+		// An asteroid's shape, and its sprites (if enabled). Defined in
+		// asteroid_field.cpp.
+		struct Shape;
+
+		/* Snapshot of the asteroids after an update. The shapes are shared
+		 * with the field (they are immutable once created), so capturing a
+		 * snapshot only copies a few values per asteroid.
+		 *
+		 * Drawing interpolates between each asteroid's state before
+		 * (aInterpolation = 0) and after (aInterpolation = 1) the update.
+		 */
+		struct Snapshot
+		{
+			struct Item
+			{
+				Vec2f pos;
+				Vec2f step; // movement during the update
+				Mat22f rot;
+				float stepAngle; // rotation during the update
+			};
+
+			std::vector<Item> items;
+			std::vector<std::shared_ptr<Shape const>> shapes;
+		};
+
+		void capture( Snapshot& ) const;
+
+		static void draw( Surface&, Snapshot const&, float aInterpolation );
+
 	private:
 		struct Asteroid_
 		{
@@ -62,17 +99,30 @@ class AsteroidField
 			float radpersec;
 		};
 
+	private:
+		std::shared_ptr<Shape const> make_shape_();
+
 	private:
 		Vec2f mBoundsMin, mBoundsMax;
 		Vec2f mExactExtent, mActualExtent;
 		
 		std::vector<Asteroid_> mAsteroids;
-		std::vector<TriangleFan> mShapes;
+		std::vector<std::shared_ptr<Shape const>> mShapes;
+		std::size_t mSpriteRotations;
 
 		float mInitialSpeed, mMaximumSpeed;
 		float mInitialRot;
 		float mPadding, mDensity;
 
+		// Parameters of the most recent update
+		float mLastElapsed;
+		Vec2f mLastMovement;
+
+		// Per-update rotation steps, computed in bulk (reused between updates)
+		std::vector<float> mStepAngles;
+		std::vector<Mat22f> mStepRotations;
+		std::size_t mUpdatesSinceOrthonormalize;
+
 		RNG& mRNG;
 };
 
@@ -1,31 +1,45 @@
 #include "background.hpp"
 
+#include <cassert>
+
 #include "../draw2d/image.hpp"
 
-Background::Background( RNG& aRNG, std::uint32_t aImageWidth, std::uint32_t aImageHeight )
+#include "../support/jobs.hpp"
+
+Background::Background( RNG& aRNG, std::uint32_t aImageWidth, std::uint32_t aImageHeight, float aDensityScale )
 	: mFarField{
-		{ aRNG, aImageWidth, aImageHeight, kFarColors[0], kFarDensities[0], kFarSpeedMults[0] },
-		{ aRNG, aImageWidth, aImageHeight, kFarColors[1], kFarDensities[1], kFarSpeedMults[1] },
-		{ aRNG, aImageWidth, aImageHeight, kFarColors[2], kFarDensities[2], kFarSpeedMults[2] }
+		{ aRNG, aImageWidth, aImageHeight, kFarColors[0], aDensityScale*kFarDensities[0], kFarSpeedMults[0] },
+		{ aRNG, aImageWidth, aImageHeight, kFarColors[1], aDensityScale*kFarDensities[1], kFarSpeedMults[1] },
+		{ aRNG, aImageWidth, aImageHeight, kFarColors[2], aDensityScale*kFarDensities[2], kFarSpeedMults[2] }
 	}
-	, mNearField{ aRNG, aImageWidth, aImageHeight, kNearColor, kNearDensity, kNearSpeedMult }
+	, mNearField{ aRNG, aImageWidth, aImageHeight, kNearColor, aDensityScale*kNearDensity, kNearSpeedMult }
 {
 	mEarthSprite = load_image( kEarthPath );
 	mCurrentPosition = Vec2f{ 0.f, 0.f };
+	mCurrentMovement = Vec2f{ 0.f, 0.f };
 }
 
 Background::~Background() = default;
 
-void Background::update( Vec2f aPosition, Vec2f aMovementDelta )
+void Background::update( JobSystem& aJobs, JobGroup& aGroup, Vec2f aPosition, Vec2f aMovementDelta )
 {
-	// Update particle fields
+	// Update particle fields. Each chunk of each field is a separate job.
+	auto const spawn_field = [&] (ParticleField& aField) {
+		aField.begin_update( aMovementDelta );
+
+		auto const chunks = aField.chunk_count();
+		for( std::size_t i = 0; i < chunks; ++i )
+			aJobs.spawn( aGroup, [&aField, i] { aField.update_chunk( i ); } );
+	};
+
 	for( auto& pf : mFarField )
-		pf.update( aMovementDelta );
+		spawn_field( pf );
 
-	mNearField.update( aMovementDelta );
+	spawn_field( mNearField );
 
 	// Store current position
 	mCurrentPosition = aPosition;
+	mCurrentMovement = aMovementDelta;
 }
 
 void Background::draw( Surface& aSurface )
@@ -41,6 +55,30 @@ void Background::draw( Surface& aSurface )
 	mNearField.draw( aSurface );
 }
 
+void Background::capture( Snapshot& aSnapshot ) const
+{
+	for( std::size_t i = 0; i < kFarLayers; ++i )
+		mFarField[i].capture( aSnapshot.farFields[i] );
+
+	mNearField.capture( aSnapshot.nearField );
+
+	aSnapshot.earthSprite = mEarthSprite.get();
+	aSnapshot.position = mCurrentPosition;
+	aSnapshot.movement = mCurrentMovement;
+}
+
+void Background::draw( Surface& aSurface, Snapshot const& aSnapshot, float aInterpolation )
+{
+	for( auto const& pf : aSnapshot.farFields )
+		ParticleField::draw( aSurface, pf, aInterpolation );
+
+	assert( aSnapshot.earthSprite );
+	Vec2f const position = aSnapshot.position - (1.f - aInterpolation) * aSnapshot.movement;
+	blit_masked( aSurface, *aSnapshot.earthSprite, kEarthCoord - position );
+
+	ParticleField::draw( aSurface, aSnapshot.nearField, aInterpolation );
+}
+
 void Background::resize( std::uint32_t aImageWidth, std::uint32_t aImageHeight )
 {
 	for( auto& pf : mFarField )
@@ -11,19 +11,47 @@
 #include "defaults.hpp"
 #include "particle_field.hpp"
 
+class JobGroup;
+class JobSystem;
+
 class Background final
 {
 	public:
-		Background( RNG&, std::uint32_t aImageWidth, std::uint32_t aImageHeight );
+		// aDensityScale scales the densities of all particle fields (see
+		// kFarDensities and kNearDensity below).
+		Background( RNG&, std::uint32_t aImageWidth, std::uint32_t aImageHeight, float aDensityScale = 1.f );
 		~Background();
 
 	public:
-		void update( Vec2f aPosition, Vec2f aMovementDelta );
+		/* Spawns the particle field updates into the provided job group. The
+		 * fields must not be drawn (or resized) before the group has been
+		 * waited on.
+		 */
+		void update( JobSystem&, JobGroup&, Vec2f aPosition, Vec2f aMovementDelta );
 
 		void draw( Surface& );
 
 		void resize( std::uint32_t aImageWidth, std::uint32_t aImageHeight );
 
+	public:
+		/* Snapshot of the background after an update. See
+		 * ParticleField::Snapshot for the meaning of aInterpolation.
+		 */
+		struct Snapshot
+		{
+			ParticleField::Snapshot farFields[3];
+			ParticleField::Snapshot nearField;
+
+			ImageRGBA const* earthSprite = nullptr;
+
+			Vec2f position{ 0.f, 0.f };
+			Vec2f movement{ 0.f, 0.f };
+		};
+
+		void capture( Snapshot& ) const;
+
+		static void draw( Surface&, Snapshot const&, float aInterpolation );
+
 	private:
 		ParticleField mFarField[3];
 		ParticleField mNearField;
@@ -31,6 +59,7 @@ class Background final
 		std::unique_ptr<ImageRGBA> mEarthSprite;
 
 		Vec2f mCurrentPosition;
+		Vec2f mCurrentMovement;
  
 	public: // Configuration values. Mostly empirically determined
 		static constexpr std::size_t kFarLayers = 3;
@@ -2,14 +2,18 @@
 #define DEFAULTS_HPP_BF9C692C_BF14_459C_B203_B0ED7DD3CB94
 
 #include <chrono>
-#include <random>
+
+#include "../support/random.hpp"
 
 /* Select default random number generator
  *
  * We don't need very high quality random numbers in this case, so we can
- * opt for a fast (but fairly low quality) LCG-based generator.
+ * opt for a fast generator. Xoshiro128 is faster than std::minstd_rand and
+ * has better statistical properties. Use its uniform() and normal() methods
+ * rather than the standard library distributions: they are faster and give
+ * the same results on all platforms.
  */
-using RNG = std::minstd_rand;
+using RNG = Xoshiro128;
 
 /* Select default clock
  *
@@ -0,0 +1,211 @@
+#include "frame_pipeline.hpp"
+
+#include <algorithm>
+
+#include <cassert>
+
+#include "../support/profiler.hpp"
+
+namespace
+{
+	double to_ms_( Clock::duration aDuration )
+	{
+		return std::chrono::duration<double, std::milli>( aDuration ).count();
+	}
+}
+
+void FrameStats::record_presented( Clock::time_point aRenderStart, Clock::time_point aRenderEnd, Clock::time_point aPresented ) noexcept
+{
+	if( 0 == mPresented )
+		mFirstPresent = aPresented;
+
+	mLastPresent = aPresented;
+	++mPresented;
+
+	auto const latency = aPresented - aRenderStart;
+	mLatencySum += latency;
+	mLatencyMax = std::max( mLatencyMax, latency );
+
+	auto const render = aRenderEnd - aRenderStart;
+	mRenderSum += render;
+	mRenderMax = std::max( mRenderMax, render );
+}
+
+void FrameStats::record_dropped() noexcept
+{
+	++mDropped;
+}
+
+void FrameStats::print( std::FILE* aOut, char const* aLabel ) const
+{
+	if( 0 == mPresented )
+	{
+		std::fprintf( aOut, "%s: no frames presented\n", aLabel );
+		return;
+	}
+
+	double const seconds = to_ms_( mLastPresent - mFirstPresent ) / 1000.0;
+	double const fps = seconds > 0.0 ? double(mPresented-1) / seconds : 0.0;
+
+	std::fprintf( aOut, "%s: %llu frames in %.1f s (%.1f fps), %llu dropped\n", aLabel, (unsigned long long)mPresented, seconds, fps, (unsigned long long)mDropped );
+	std::fprintf( aOut, "  latency: avg %.2f ms, max %.2f ms\n", to_ms_( mLatencySum ) / double(mPresented), to_ms_( mLatencyMax ) );
+	std::fprintf( aOut, "  render:  avg %.2f ms, max %.2f ms\n", to_ms_( mRenderSum ) / double(mPresented), to_ms_( mRenderMax ) );
+}
+
+
+FramePipeline::FramePipeline( std::size_t aSurfaceCount, Surface::Index aWidth, Surface::Index aHeight )
+	: mWidth( aWidth )
+	, mHeight( aHeight )
+{
+	assert( aSurfaceCount >= 2 );
+
+	mFrames.reserve( aSurfaceCount );
+	for( std::size_t i = 0; i < aSurfaceCount; ++i )
+	{
+		mFrames.emplace_back( std::make_unique<Frame>( Frame{ Surface( aWidth, aHeight ) } ) );
+		mFree.emplace_back( mFrames.back().get() );
+	}
+}
+
+FramePipeline::~FramePipeline()
+{
+	stop();
+}
+
+
+void FramePipeline::start( RenderFunc aRender )
+{
+	assert( aRender );
+	assert( !mThread.joinable() );
+
+	mRender = std::move(aRender);
+	mThread = std::thread( [this] { thread_(); } );
+}
+
+void FramePipeline::stop()
+{
+	if( !mThread.joinable() )
+		return;
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStop = true;
+	}
+	mFreeCV.notify_all();
+
+	mThread.join();
+}
+
+void FramePipeline::resize( Surface::Index aWidth, Surface::Index aHeight )
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	mWidth = aWidth;
+	mHeight = aHeight;
+}
+
+
+FramePipeline::Frame* FramePipeline::acquire_present( Clock::duration aTimeout )
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	mReadyCV.wait_for( lock, aTimeout, [this] {
+		return mError || !mReady.empty();
+	} );
+
+	if( mError )
+		std::rethrow_exception( mError );
+
+	if( mReady.empty() )
+		return nullptr;
+
+	// Present the newest frame. Older frames would only add latency.
+	Frame* frame = mReady.back();
+	mReady.pop_back();
+
+	bool const dropped = !mReady.empty();
+	while( !mReady.empty() )
+	{
+		mFree.emplace_back( mReady.front() );
+		mReady.pop_front();
+		mStats.record_dropped();
+	}
+
+	lock.unlock();
+
+	if( dropped )
+		mFreeCV.notify_one();
+
+	return frame;
+}
+
+void FramePipeline::release( Frame* aFrame )
+{
+	assert( aFrame );
+	auto const now = Clock::now();
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mStats.record_presented( aFrame->renderStart, aFrame->renderEnd, now );
+		mFree.emplace_back( aFrame );
+	}
+
+	mFreeCV.notify_one();
+}
+
+FrameStats FramePipeline::stats() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mStats;
+}
+
+
+void FramePipeline::thread_()
+{
+	PROFILE_THREAD_NAME( "render" );
+
+	try
+	{
+		while( true )
+		{
+			Frame* frame = nullptr;
+			Surface::Index width, height;
+
+			{
+				std::unique_lock<std::mutex> lock( mMutex );
+				mFreeCV.wait( lock, [this] {
+					return mStop || !mFree.empty();
+				} );
+
+				if( mStop )
+					break;
+
+				frame = mFree.front();
+				mFree.pop_front();
+
+				frame->index = mNextIndex++;
+				width = mWidth;
+				height = mHeight;
+			}
+
+			if( frame->surface.get_width() != width || frame->surface.get_height() != height )
+				frame->surface = Surface( width, height );
+
+			frame->renderStart = Clock::now();
+			mRender( frame->surface );
+			frame->renderEnd = Clock::now();
+
+			{
+				std::lock_guard<std::mutex> lock( mMutex );
+				mReady.emplace_back( frame );
+			}
+			mReadyCV.notify_one();
+		}
+	}
+	catch( ... )
+	{
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mError = std::current_exception();
+		}
+		mReadyCV.notify_all();
+	}
+}
@@ -0,0 +1,130 @@
+#ifndef FRAME_PIPELINE_HPP_6D4D6F93_966E_4D48_B418_2FC3334A2333
+#define FRAME_PIPELINE_HPP_6D4D6F93_966E_4D48_B418_2FC3334A2333
+
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <exception>
+#include <functional>
+#include <condition_variable>
+
+#include <cstdio>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../draw2d/surface.hpp"
+
+#include "defaults.hpp"
+
+/** FrameStats - latency and throughput of presented frames
+ *
+ * Latency is the time from the start of rendering a frame until after its
+ * presentation (i.e., after the buffer swap returns). Throughput is the number
+ * of presented frames per second.
+ */
+class FrameStats final
+{
+	public:
+		void record_presented( Clock::time_point aRenderStart, Clock::time_point aRenderEnd, Clock::time_point aPresented ) noexcept;
+		void record_dropped() noexcept;
+
+		void print( std::FILE*, char const* aLabel ) const;
+
+	private:
+		std::uint64_t mPresented = 0, mDropped = 0;
+		Clock::time_point mFirstPresent, mLastPresent;
+		Clock::duration mLatencySum{}, mLatencyMax{};
+		Clock::duration mRenderSum{}, mRenderMax{};
+};
+
+/** FramePipeline - overlap rasterization with presentation
+ *
+ * Without the pipeline, the main thread rasterizes a frame into a Surface,
+ * and then uploads and presents it. With v-sync, presenting blocks until the
+ * next vertical blank, and no rasterization happens in the meantime.
+ *
+ * The pipeline rotates two or three Surfaces between a render thread and the
+ * thread that owns the OpenGL context (the main thread). The render thread
+ * rasterizes frame N+1 while the main thread uploads and presents frame N:
+ *
+ *   render thread:   acquire free surface -> render -> submit
+ *   main thread:     acquire_present() -> upload + swap -> release()
+ *
+ * With three surfaces, the render thread can run ahead by one frame. If more
+ * than one rendered frame is waiting, acquire_present() returns the newest one
+ * and recycles the older ones (these are counted as dropped frames). This
+ * keeps latency at most one frame above the non-pipelined case.
+ *
+ * The pipeline records FrameStats for the presented frames.
+ */
+class FramePipeline final
+{
+	public:
+		struct Frame
+		{
+			Surface surface;
+
+			std::uint64_t index = 0;
+			Clock::time_point renderStart, renderEnd;
+		};
+
+		using RenderFunc = std::function<void(Surface&)>;
+
+	public:
+		FramePipeline( std::size_t aSurfaceCount, Surface::Index aWidth, Surface::Index aHeight );
+		~FramePipeline();
+
+		FramePipeline( FramePipeline const& ) = delete;
+		FramePipeline& operator= (FramePipeline const&) = delete;
+
+	public:
+		/* Start the render thread. It calls aRender for each frame, with a
+		 * Surface of the current size (see resize()). The surface is not
+		 * cleared in between frames.
+		 */
+		void start( RenderFunc aRender );
+
+		/* Stop and join the render thread. Called by the destructor if
+		 * necessary.
+		 */
+		void stop();
+
+		// Set the size of subsequent frames. Frames that are already in the
+		// pipeline keep their old size.
+		void resize( Surface::Index aWidth, Surface::Index aHeight );
+
+		/* Wait at most aTimeout for a rendered frame. Returns nullptr if no
+		 * frame became ready in that time. The frame must be handed back with
+		 * release() after it has been presented. If the render function threw
+		 * an exception, it is rethrown here.
+		 */
+		Frame* acquire_present( Clock::duration aTimeout );
+		void release( Frame* );
+
+		FrameStats stats() const;
+
+	private:
+		void thread_();
+
+	private:
+		std::vector<std::unique_ptr<Frame>> mFrames;
+
+		RenderFunc mRender;
+		std::thread mThread;
+
+		mutable std::mutex mMutex;
+		std::condition_variable mFreeCV, mReadyCV;
+
+		std::deque<Frame*> mFree, mReady;
+		bool mStop = false;
+		std::exception_ptr mError;
+
+		Surface::Index mWidth, mHeight;
+		std::uint64_t mNextIndex = 0;
+
+		FrameStats mStats;
+};
+
+#endif // FRAME_PIPELINE_HPP_6D4D6F93_966E_4D48_B418_2FC3334A2333
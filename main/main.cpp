@@ -1,6 +1,9 @@
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
 
+#include <chrono>
+#include <memory>
+#include <string>
 #include <random>
 #include <typeinfo>
 #include <stdexcept>
@@ -11,9 +14,13 @@
 #include "../draw2d/surface.hpp"
 #include "../draw2d/draw.hpp"
 #include "../draw2d/shape.hpp"
+#include "../draw2d/kernels.hpp"
+#include "../draw2d/overdraw.hpp"
 
+#include "../support/jobs.hpp"
 #include "../support/error.hpp"
 #include "../support/context.hpp"
+#include "../support/profiler.hpp"
 #include "../support/runconfig.hpp"
 
 #include "../vmlib/vec2.hpp"
@@ -22,8 +29,8 @@
 #include "defaults.hpp"
 #include "state.hpp"
 #include "spaceship.hpp"
-#include "background.hpp"
-#include "asteroid_field.hpp"
+#include "simulation.hpp"
+#include "frame_pipeline.hpp"
 
 namespace
 {
@@ -44,6 +51,12 @@ namespace
 		~GLFWWindowDeleter();
 		GLFWwindow *window;
 	};
+
+	struct ProfileTraceWriter
+	{
+		~ProfileTraceWriter();
+		std::string path;
+	};
 }
 
 int main(int aArgc, char *aArgv[])
@@ -52,6 +65,40 @@ try
 	// Parse command line arguments
 	RuntimeConfig const config = parse_command_line(aArgc, aArgv);
 
+	// Drawing kernels. Report the choice only if one was asked for with
+	// --kernel-isa.
+	KernelIsa kernelIsa{};
+	if (!parse_kernel_isa(config.kernelIsa.c_str(), kernelIsa))
+	{
+		throw Error("Error while parsing command line\n"
+			"Value '%s' not valid for --kernel-isa; expected auto, generic, sse2, avx2, avx512 or neon\n"
+			"Use --help to print available command line options", config.kernelIsa.c_str());
+	}
+
+	if (!select_kernels(kernelIsa))
+	{
+		throw Error("Error while parsing command line\n"
+			"Kernel instruction set '%s' is not available on this CPU (or in this build)\n"
+			"Use --help to print available command line options", config.kernelIsa.c_str());
+	}
+
+	if (KernelIsa::automatic != kernelIsa)
+		std::printf("Drawing with %s kernels\n", kernel_isa_name(kernels().isa));
+
+	// Overdraw statistics are compiled in only with DRAW2D_CFG_OVERDRAW
+	if (!config.overdrawHeatmap.empty() && !kOverdrawEnabled)
+	{
+		throw Error("Error while parsing command line\n"
+			"--overdraw requires a build with overdraw statistics (premake5 --overdraw)\n"
+			"Use --help to print available command line options");
+	}
+
+	// Write the zones recorded by the profiler (if it is compiled in; see
+	// support/profiler.hpp) on exit. This is declared before everything else
+	// and therefore destroyed last, after all other threads have stopped.
+	ProfileTraceWriter traceWriter{config.traceFile};
+	PROFILE_THREAD_NAME("main");
+
 	// Initialize GLFW
 	if (GLFW_TRUE != glfwInit())
 	{
@@ -152,16 +199,62 @@ try
 	glViewport(0, 0, iwidth, iheight);
 
 	// Resources
-	RNG rng(std::random_device{}());
+	RNG rng(config.fixedSeed ? config.randomSeed : std::random_device{}());
 
-	Background background(rng, fbwidth, fbheight);
-	AsteroidField asteroids(rng, fbwidth, fbheight);
+	// Job system used for updates. With --threads=1, everything runs on the
+	// main thread.
+	JobSystem jobs(config.threadCount);
+
+	// The simulation (background and asteroids) advances in fixed steps. With
+	// --simthread, the steps run on a separate thread.
+	Simulation simulation(rng, jobs, fbwidth, fbheight, config.simulationRate, config.starDensityScale, config.asteroidSpriteRotations);
+
+	if (config.simulationThread)
+		simulation.start_thread();
 
 	auto const spaceship = make_spaceship_shape();
 
-	// Main loop
-	auto lastUpdateTime = Clock::now();
+	// With --overdraw, count the pixel writes of each frame (see
+	// draw2d/overdraw.hpp).
+	OverdrawStats overdraw;
+	bool const countOverdraw = !config.overdrawHeatmap.empty();
+
+	// Render one frame. Called either by the main loop directly, or by the
+	// render thread of the frame pipeline.
+	auto const render_frame = [&](Surface &aSurface) {
+		PROFILE_ZONE("frame");
+
+		auto const now = Clock::now();
+		if (!config.simulationThread)
+			simulation.advance(now);
+
+		if (countOverdraw)
+			overdraw.begin_frame(aSurface);
+
+		aSurface.clear();
+
+		simulation.draw(aSurface, now);
+
+		auto const rot = make_rotation_2d(simulation.input().angle);
+		auto const offs = Vec2f{aSurface.get_width() * 0.5f, aSurface.get_height() * 0.5f};
+		spaceship.draw(aSurface, {0.2f, 0.4f, 0.7f}, rot, offs);
+
+		if (countOverdraw)
+			overdraw.end_frame();
+	};
+
+	// With --pipeline=N, frames are rendered on a separate thread while the
+	// main thread uploads and presents the previous frame.
+	std::unique_ptr<FramePipeline> pipeline;
+	FrameStats directStats;
+
+	if (config.pipelineDepth)
+	{
+		pipeline = std::make_unique<FramePipeline>(config.pipelineDepth, fbwidth, fbheight);
+		pipeline->start(render_frame);
+	}
 
+	// Main loop
 	while (!glfwWindowShouldClose(window))
 	{
 		// Let GLFW process events
@@ -199,39 +292,69 @@ try
 				fbwidth = std::uint32_t(iwidth / ws) >> config.framebufferScaleShift;
 				fbheight = std::uint32_t(iheight / hs) >> config.framebufferScaleShift;
 
-				// Resize things
-				context.resize(fbwidth, fbheight);
+				// Resize things. In pipelined mode, the context is resized
+				// when the first frame with the new size arrives.
+				if (pipeline)
+				{
+					pipeline->resize(fbwidth, fbheight);
+				}
+				else
+				{
+					context.resize(fbwidth, fbheight);
+					surface = Surface(fbwidth, fbheight);
+				}
 
-				surface = Surface(fbwidth, fbheight);
-				background.resize(fbwidth, fbheight);
-				asteroids.resize(fbwidth, fbheight);
+				simulation.resize(fbwidth, fbheight);
 			}
 		}
 
 		// Update state
-		auto const now = Clock::now();
-		auto const dt = std::chrono::duration_cast<Secondsf>(now - lastUpdateTime).count();
-		lastUpdateTime = now;
-
-		state_update(state, dt);
+		simulation.set_input({state.player.angle, state.player.accelerationMagnitude});
 
-		background.update(state.player.position, state.thisFrame.movement);
-		asteroids.update(state.thisFrame.dt, state.thisFrame.movement);
+		if (pipeline)
+		{
+			// Present the most recent frame from the render thread. The
+			// timeout keeps the window responsive if rendering stalls.
+			if (auto *frame = pipeline->acquire_present(std::chrono::milliseconds(100)))
+			{
+				context.resize(frame->surface.get_width(), frame->surface.get_height());
+				context.draw(frame->surface);
 
-		// Draw scene
-		surface.clear();
+				glfwSwapBuffers(window);
+				pipeline->release(frame);
+			}
+		}
+		else
+		{
+			// Draw scene
+			auto const renderStart = Clock::now();
+			render_frame(surface);
+			auto const renderEnd = Clock::now();
 
-		background.draw(surface);
-		asteroids.draw(surface);
+			context.draw(surface);
 
-		auto const rot = make_rotation_2d(state.player.angle);
-		auto const offs = Vec2f{fbwidth * 0.5f, fbheight * 0.5f};
-		spaceship.draw(surface, {0.2f, 0.4f, 0.7f}, rot, offs);
+			// Display results
+			glfwSwapBuffers(window);
+			directStats.record_presented(renderStart, renderEnd, Clock::now());
+		}
+	}
 
-		context.draw(surface);
+	// Report frame statistics
+	if (pipeline)
+	{
+		pipeline->stop();
+		pipeline->stats().print(stdout, "Pipelined frames");
+	}
+	else
+	{
+		directStats.print(stdout, "Frames");
+	}
 
-		// Display results
-		glfwSwapBuffers(window);
+	if (countOverdraw)
+	{
+		overdraw.print(stdout, "Overdraw");
+		if (!overdraw.write_heatmap(config.overdrawHeatmap.c_str()))
+			std::fprintf(stderr, "Unable to write overdraw heatmap '%s'\n", config.overdrawHeatmap.c_str());
 	}
 
 	// Cleanup.
@@ -336,4 +459,20 @@ namespace
 		if (window)
 			glfwDestroyWindow(window);
 	}
+
+	ProfileTraceWriter::~ProfileTraceWriter()
+	{
+		if (!kProfilerEnabled)
+			return;
+
+		try
+		{
+			auto const zones = write_chrome_trace(path.c_str());
+			std::printf("Wrote %zu profiler zones to '%s'\n", zones, path.c_str());
+		}
+		catch (std::exception const &eErr)
+		{
+			std::fprintf(stderr, "Unable to write profiler trace: %s\n", eErr.what());
+		}
+	}
 }
@@ -2,13 +2,39 @@
 
 #include "../draw2d/surface.hpp"
 
-#include <cassert> 
+#include "../vmlib/vec2x.hpp"
+
+#include <bit>
+#include <algorithm>
+
+#include <cassert>
+
+namespace
+{
+	// Branch-free select: aMask ? aA : aB. Written with bit operations, as
+	// compilers reliably turn this into vector blends (a plain ?: is not
+	// always if-converted).
+	inline
+	float select_( bool aMask, float aA, float aB ) noexcept
+	{
+		std::uint32_t const mask = 0u - std::uint32_t(aMask);
+		std::uint32_t const bits = (std::bit_cast<std::uint32_t>(aA) & mask)
+			| (std::bit_cast<std::uint32_t>(aB) & ~mask);
+		return std::bit_cast<float>( bits );
+	}
+
+	constexpr float kInv65536_ = 1.f / 65536.f;
+}
 
 ParticleField::ParticleField( RNG& aRNG, std::uint32_t aImageWidth, std::uint32_t aImageHeight, ColorF const& aParticleColor, float aParticleDensity, float aParticleSpeedMult, float aPadding )
-	: mColor( linear_to_srgb( aParticleColor ) )
+	: mCount( 0 )
+	, mColor( linear_to_srgb( aParticleColor ) )
 	, mParticleSpeedMult( aParticleSpeedMult )
 	, mParticleDensity( aParticleDensity )
 	, mPadding( aPadding )
+	, mDelta{ 0.f, 0.f }
+	, mRespawnPad{ aPadding, aPadding }
+	, mStep( 0 )
 	, mRNG( aRNG )
 {
 	// Store extents
@@ -20,86 +46,135 @@ ParticleField::ParticleField( RNG& aRNG, std::uint32_t aImageWidth, std::uint32_
 
 	// Allocate particles
 	Vec2f const extent = mBoxMax - mBoxMin;
-	
+
 	float const totalArea = extent.x * extent.y;
 	float const particleCountf = totalArea * mParticleDensity;
 	std::size_t const particleCount = std::size_t(particleCountf+0.5f);
 
-	mParticles.resize( particleCount );
+	resize_arrays_( particleCount );
 
 	// Initialize particles
-	std::uniform_real_distribution<float> xdist( mBoxMin.x, mBoxMax.x );
-	std::uniform_real_distribution<float> ydist( mBoxMin.y, mBoxMax.y );
+	mRNG.fill_uniform( mCount, mXs.data(), mBoxMin.x, mBoxMax.x );
+	mRNG.fill_uniform( mCount, mYs.data(), mBoxMin.y, mBoxMax.y );
 
-	for( auto& p : mParticles )
-	{
-		p.x = xdist(mRNG);
-		p.y = ydist(mRNG);
-	}
+	// Key for the counter-based random numbers used during updates.
+	mKey = std::uint32_t(mRNG());
+	mStepKey = counter_random_u32( mKey, 0 );
 }
 
 
 void ParticleField::update( Vec2f aDelta ) noexcept
 {
-	// Note: the delta here is reversed -- the particles move in the 
+	begin_update( aDelta );
+
+	auto const chunks = chunk_count();
+	for( std::size_t i = 0; i < chunks; ++i )
+		update_chunk( i );
+}
+
+void ParticleField::begin_update( Vec2f aDelta ) noexcept
+{
+	// Note: the delta here is reversed -- the particles move in the
 	// opposite direction as the "player".
-	auto const delta = -mParticleSpeedMult * aDelta;
+	mDelta = -mParticleSpeedMult * aDelta;
 
-	std::uniform_real_distribution<float> xdist( mBoxMin.x, mBoxMax.x );
-	std::uniform_real_distribution<float> ydist( mBoxMin.y, mBoxMax.y );
+	mRespawnPad.x = std::max( std::abs(aDelta.x), mPadding );
+	mRespawnPad.y = std::max( std::abs(aDelta.y), mPadding );
 
-	float const padX = std::max( std::abs(aDelta.x), mPadding );
-	float const padY = std::max( std::abs(aDelta.y), mPadding );
+	++mStep;
+	mStepKey = counter_random_u32( mKey, mStep );
+}
 
-	std::uniform_real_distribution<float> xpad( 0.f, padX );
-	std::uniform_real_distribution<float> ypad( 0.f, padY );
+std::size_t ParticleField::chunk_count() const noexcept
+{
+	return (mCount + kChunkSize-1) / kChunkSize;
+}
 
+void ParticleField::update_chunk( std::size_t aChunk ) noexcept
+{
+	// The arrays are padded to a multiple of kLanes, so the last (partial)
+	// block can be processed like all others. The padding particles are
+	// updated but never drawn.
+	std::size_t const beg = aChunk * kChunkSize;
+	std::size_t const end = std::min( beg + kChunkSize, mXs.size() );
 
-	for( auto& particle : mParticles )
-	{
-		Vec2f p = particle + delta;
+	assert( beg < end && 0 == (end-beg) % kLanes );
 
-		if( p.x < mBoxMin.x )
-		{
-			p.x = mBoxMax.x - xpad(mRNG);
-			p.y = ydist(mRNG);
-		}
-		else if( p.x > mBoxMax.x )
-		{
-			p.x = mBoxMin.x + xpad(mRNG);
-			p.y = ydist(mRNG);
-		}
+	float const minX = mBoxMin.x, maxX = mBoxMax.x;
+	float const minY = mBoxMin.y, maxY = mBoxMax.y;
+	float const rangeX = maxX - minX, rangeY = maxY - minY;
+	float const padX = mRespawnPad.x, padY = mRespawnPad.y;
+	std::uint32_t const key = mStepKey;
 
-		if( p.y < mBoxMin.y )
-		{
-			p.x = xdist(mRNG);
-			p.y = mBoxMax.y - ypad(mRNG);
-		}
-		else if( p.y > mBoxMax.y )
+	float* const xs = mXs.data();
+	float* const ys = mYs.data();
+
+	for( std::size_t i = beg; i < end; i += kLanes )
+	{
+		// Working on a local copy tells the compiler that xs and ys don't
+		// alias; the fixed-size loops below then map to vector instructions.
+		auto p = load_soa<kLanes>( xs+i, ys+i );
+		p += mDelta;
+
+		for( std::size_t l = 0; l < kLanes; ++l )
 		{
-			p.x = xdist(mRNG);
-			p.y = mBoxMin.y + ypad(mRNG);
+			// Two 16-bit uniform numbers per particle. That is plenty of
+			// resolution for placing a particle along the field's edge.
+			std::uint32_t const bits = counter_random_u32( key, std::uint32_t(i+l) );
+			float const u0 = float(bits & 0xffffu) * kInv65536_;
+			float const u1 = float(bits >> 16) * kInv65536_;
+
+			bool const xlo = p.x[l] < minX;
+			bool const xhi = p.x[l] > maxX;
+			bool const ylo = p.y[l] < minY;
+			bool const yhi = p.y[l] > maxY;
+
+			// Leaving through the left/right side respawns the particle
+			// along the opposite side at a random height. Top/bottom
+			// likewise. Left/right takes precedence.
+			float const xEdge = select_( xlo, maxX - u0*padX, minX + u0*padX );
+			float const yEdge = select_( ylo, maxY - u0*padY, minY + u0*padY );
+			float const xAny = minX + u1*rangeX;
+			float const yAny = minY + u1*rangeY;
+
+			bool const outX = xlo | xhi;
+			bool const outY = ylo | yhi;
+
+			float nx = select_( outY, xAny, p.x[l] );
+			float ny = select_( outY, yEdge, p.y[l] );
+
+			nx = select_( outX, xEdge, nx );
+			ny = select_( outX, yAny, ny );
+
+			p.x[l] = nx;
+			p.y[l] = ny;
 		}
 
-		particle = p;
+		store_soa( p, xs+i, ys+i );
 	}
 }
 
 void ParticleField::draw( Surface& aSurface ) const
 {
-	for( auto const& particle : mParticles )
-	{
-		auto const p = particle + Vec2f{ .5f, .5f };
+	aSurface.draw_points( mCount, mXs.data(), mYs.data(), mColor );
+}
 
-		if( p.x < 0.f || p.y < 0.f )
-			continue;
-		
-		std::uint32_t const xpos = std::uint32_t( p.x + .5f );
-		std::uint32_t const ypos = std::uint32_t( p.y + .5f );
+void ParticleField::capture( Snapshot& aSnapshot ) const
+{
+	// assign() reuses the existing storage; after the first few captures,
+	// this does not allocate.
+	aSnapshot.xs.assign( mXs.begin(), mXs.begin() + mCount );
+	aSnapshot.ys.assign( mYs.begin(), mYs.begin() + mCount );
+	aSnapshot.count = mCount;
+
+	aSnapshot.delta = mDelta;
+	aSnapshot.color = mColor;
+}
 
-		if( xpos < aSurface.get_width() && ypos < aSurface.get_height() )
-			aSurface.set_pixel_srgb( xpos, ypos, mColor );
-	}
+void ParticleField::draw( Surface& aSurface, Snapshot const& aSnapshot, float aInterpolation )
+{
+	Vec2f const offset = -(1.f - aInterpolation) * aSnapshot.delta;
+	aSurface.draw_points( aSnapshot.count, aSnapshot.xs.data(), aSnapshot.ys.data(), aSnapshot.color, offset.x, offset.y );
 }
 
 void ParticleField::resize( std::uint32_t aImageWidth, std::uint32_t aImageHeight )
@@ -113,24 +188,24 @@ void ParticleField::resize( std::uint32_t aImageWidth, std::uint32_t aImageHeigh
 	mBoxMax = mVisibleExtent + Vec2f{ mPadding, mPadding };
 
 	Vec2f const extent = mBoxMax - mBoxMin;
-	
+
 	float const totalArea = extent.x * extent.y;
 	float const particleCountf = totalArea * mParticleDensity;
 	std::size_t const particleCount = std::size_t(particleCountf+0.5f);
 
 	// Remove particles now outside
 	std::size_t activeParticles = 0;
-	for( auto it = mParticles.begin(); it != mParticles.end(); )
+	for( std::size_t i = 0; i < mCount; ++i )
 	{
-		auto const& part = *it;
+		if( mXs[i] > mBoxMax.x || mYs[i] > mBoxMax.y )
+			continue;
 
-		if( part.x > mBoxMax.x || part.y > mBoxMax.y )
-			it = mParticles.erase( it );
-		else
-			++it, ++activeParticles;
+		mXs[activeParticles] = mXs[i];
+		mYs[activeParticles] = mYs[i];
+		++activeParticles;
 	}
 
-	mParticles.resize( particleCount ); // This may kill a few visible particles..
+	resize_arrays_( particleCount ); // This may kill a few visible particles..
 
 	// Add new particles (if necessary)
 	if( activeParticles < particleCount )
@@ -142,29 +217,35 @@ void ParticleField::resize( std::uint32_t aImageWidth, std::uint32_t aImageHeigh
 		float xarea = dd.x * mBoxMax.y;
 		float yarea = dd.y * (mBoxMax.x - dd.x);
 
-		std::uniform_real_distribution<float> area( 0.f, xarea+yarea );
-		std::uniform_real_distribution<float> xax( oldMax.x, oldMax.x+dd.x );
-		std::uniform_real_distribution<float> xay( 0.f, mBoxMax.y );
-		std::uniform_real_distribution<float> yax( 0.f, mBoxMax.x - dd.x );
-		std::uniform_real_distribution<float> yay( oldMax.y, oldMax.y+dd.y );
-
 		for( std::size_t i = activeParticles; i < particleCount; ++i )
 		{
 			Vec2f pos;
 
-			auto const where = area(mRNG);
+			auto const where = mRNG.uniform( 0.f, xarea+yarea );
 			if( where <= xarea )
 			{
-				pos.x = xax( mRNG );
-				pos.y = xay( mRNG );
+				pos.x = mRNG.uniform( oldMax.x, oldMax.x+dd.x );
+				pos.y = mRNG.uniform( 0.f, mBoxMax.y );
 			}
 			else
 			{
-				pos.x = yax( mRNG );
-				pos.y = yay( mRNG );
+				pos.x = mRNG.uniform( 0.f, mBoxMax.x - dd.x );
+				pos.y = mRNG.uniform( oldMax.y, oldMax.y+dd.y );
 			}
 
-			mParticles[i] = pos;
+			mXs[i] = pos.x;
+			mYs[i] = pos.y;
 		}
 	}
 }
+
+void ParticleField::resize_arrays_( std::size_t aCount )
+{
+	// Round up to a multiple of kLanes. The padding particles start out at
+	// the origin, which is inside the field.
+	std::size_t const padded = (aCount + kLanes-1) / kLanes * kLanes;
+
+	mXs.resize( padded, 0.f );
+	mYs.resize( padded, 0.f );
+	mCount = aCount;
+}
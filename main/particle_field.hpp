@@ -3,6 +3,7 @@
 
 #include <vector>
 
+#include <cstdint>
 #include <cstdlib>
 
 #include "../draw2d/forward.hpp"
@@ -12,10 +13,20 @@
 
 #include "defaults.hpp"
 
+/** Particle field
+ *
+ * The particles are stored as a structure of arrays (separate x and y
+ * arrays). The update processes kLanes particles at a time without any
+ * branches: all particles are moved, and particles that leave the field are
+ * respawned with masked selects. Random numbers for respawning are drawn from
+ * a counter-based generator (a hash of the particle index, the update step and
+ * a per-field key), so any particle can be updated independently of all
+ * others. This lets the compiler vectorize the update loop.
+ */
 class ParticleField final
 {
 	public:
-		ParticleField( 
+		ParticleField(
 			RNG& aRNG,
 			std::uint32_t aImageWidth, std::uint32_t aImageHeight,
 			ColorF const& aParticleColor,
@@ -27,12 +38,62 @@ class ParticleField final
 	public:
 		void update( Vec2f aMovementDelta ) noexcept;
 
+		/* The particles are split into fixed-size chunks that can be updated
+		 * independently (and concurrently). begin_update() must be called
+		 * once per update, before any of the chunks are updated. Since the
+		 * random numbers depend only on the particle index and the update
+		 * step, the results are the same regardless of the order in which (or
+		 * the threads on which) chunks are updated. update() simply does all
+		 * of this in order.
+		 */
+		void begin_update( Vec2f aMovementDelta ) noexcept;
+
+		std::size_t chunk_count() const noexcept;
+		void update_chunk( std::size_t aChunk ) noexcept;
+
 		void draw( Surface& ) const;
 
 		void resize( std::uint32_t aImageWidth, std::uint32_t aImageHeight );
-	
+
+		std::size_t particle_count() const noexcept { return mCount; }
+
+	public:
+		/* Copy of the particle positions after an update. A snapshot can be
+		 * drawn while the field itself is being updated further (e.g., on
+		 * another thread).
+		 *
+		 * All particles move by the same delta in an update. Drawing with
+		 * aInterpolation = 0 places particles where they were before the
+		 * update, aInterpolation = 1 where they are after it. (Respawned
+		 * particles are drawn near their new position.)
+		 */
+		struct Snapshot
+		{
+			std::vector<float> xs, ys;
+			std::size_t count = 0;
+
+			Vec2f delta{ 0.f, 0.f };
+			ColorU8_sRGB color{ 0, 0, 0 };
+		};
+
+		void capture( Snapshot& ) const;
+
+		static void draw( Surface&, Snapshot const&, float aInterpolation );
+
+	public:
+		// Number of particles processed together by update_chunk(). The
+		// particle arrays are padded to a multiple of this.
+		static constexpr std::size_t kLanes = 8;
+
+		static constexpr std::size_t kChunkSize = 4096;
+		static_assert( 0 == kChunkSize % kLanes );
+
 	private:
-		std::vector<Vec2f> mParticles;
+		void resize_arrays_( std::size_t );
+
+	private:
+		std::vector<float> mXs, mYs;
+		std::size_t mCount;
 
 		ColorU8_sRGB mColor;
 
@@ -43,6 +104,14 @@ class ParticleField final
 		Vec2f mVisibleExtent;
 		Vec2f mBoxMin, mBoxMax;
 
+		// State for the current update (see begin_update())
+		Vec2f mDelta;
+		Vec2f mRespawnPad;
+
+		std::uint32_t mKey;
+		std::uint32_t mStep;
+		std::uint32_t mStepKey;
+
 		RNG& mRNG;
 };
 
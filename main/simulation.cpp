@@ -0,0 +1,194 @@
+#include "simulation.hpp"
+
+#include <algorithm>
+
+#include <cassert>
+
+#include "../support/jobs.hpp"
+#include "../support/profiler.hpp"
+
+namespace
+{
+	// If the simulation falls behind by more than this many steps (e.g.,
+	// because the window was being dragged), the remaining steps are
+	// skipped instead of trying to catch up.
+	constexpr std::size_t kMaxStepsPerAdvance = 8;
+}
+
+Simulation::Simulation( RNG& aRNG, JobSystem& aJobs, std::uint32_t aWidth, std::uint32_t aHeight, float aStepsPerSecond, float aStarDensityScale, std::size_t aAsteroidSpriteRotations )
+	: mJobs( aJobs )
+	, mBackground( aRNG, aWidth, aHeight, aStarDensityScale )
+	, mAsteroids( aRNG, aWidth, aHeight, aAsteroidSpriteRotations )
+	, mStepDuration( std::chrono::duration_cast<Clock::duration>( Secondsf( 1.f / aStepsPerSecond ) ) )
+	, mStepSeconds( 1.f / aStepsPerSecond )
+{
+	assert( aStepsPerSecond > 0.f );
+
+	// Initial snapshot, so that there is always something to draw.
+	auto const now = Clock::now();
+	mNextStepTime = now + mStepDuration;
+
+	mBackground.capture( mSnapshots[mFront].background );
+	mAsteroids.capture( mSnapshots[mFront].asteroids );
+	mSnapshots[mFront].time = now;
+}
+
+Simulation::~Simulation()
+{
+	if( mThread.joinable() )
+	{
+		mStop = true;
+		mThread.join();
+	}
+}
+
+
+void Simulation::advance( Clock::time_point aNow )
+{
+	// Pick up input and resizes
+	SimulationInput input;
+	bool resize = false;
+	std::uint32_t width = 0, height = 0;
+	{
+		std::lock_guard<std::mutex> lock( mInputMutex );
+		input = mInput;
+
+		if( mResizePending )
+		{
+			resize = true;
+			width = mPendingWidth;
+			height = mPendingHeight;
+			mResizePending = false;
+		}
+	}
+
+	if( resize )
+	{
+		mBackground.resize( width, height );
+		mAsteroids.resize( width, height );
+	}
+
+	mState.player.angle = input.angle;
+	mState.player.accelerationMagnitude = input.accelerationMagnitude;
+
+	// Run the steps that are due
+	std::size_t steps = 0;
+	for( ; mNextStepTime <= aNow && steps < kMaxStepsPerAdvance; ++steps )
+	{
+		step_();
+		mNextStepTime += mStepDuration;
+	}
+
+	if( mNextStepTime <= aNow )
+		mNextStepTime = aNow + mStepDuration;
+
+	if( steps || resize )
+		publish_( mNextStepTime - mStepDuration );
+}
+
+void Simulation::start_thread()
+{
+	assert( !mThread.joinable() );
+
+	mNextStepTime = Clock::now() + mStepDuration;
+	mThread = std::thread( [this] { thread_(); } );
+}
+
+void Simulation::set_input( SimulationInput const& aInput )
+{
+	std::lock_guard<std::mutex> lock( mInputMutex );
+	mInput = aInput;
+}
+
+SimulationInput Simulation::input() const
+{
+	std::lock_guard<std::mutex> lock( mInputMutex );
+	return mInput;
+}
+
+void Simulation::resize( std::uint32_t aWidth, std::uint32_t aHeight )
+{
+	std::lock_guard<std::mutex> lock( mInputMutex );
+	mResizePending = true;
+	mPendingWidth = aWidth;
+	mPendingHeight = aHeight;
+}
+
+void Simulation::draw( Surface& aSurface, Clock::time_point aNow )
+{
+	{
+		std::lock_guard<std::mutex> lock( mErrorMutex );
+		if( mThreadError )
+			std::rethrow_exception( mThreadError );
+	}
+
+	// Take the ready snapshot if it is newer than ours. Otherwise keep drawing
+	// ours; it is still the most recent one.
+	if( mReady.load( std::memory_order_relaxed ) & kReadyFresh )
+		mFront = mReady.exchange( mFront, std::memory_order_acq_rel ) & kReadyIndex;
+
+	auto const& snap = mSnapshots[mFront];
+
+	float const elapsed = std::chrono::duration_cast<Secondsf>( aNow - snap.time ).count();
+	float const alpha = std::clamp( elapsed / mStepSeconds, 0.f, 1.f );
+
+	Background::draw( aSurface, snap.background, alpha );
+	AsteroidField::draw( aSurface, snap.asteroids, alpha );
+}
+
+std::uint64_t Simulation::step_count() const noexcept
+{
+	return mStepCount.load( std::memory_order_relaxed );
+}
+
+
+void Simulation::step_()
+{
+	PROFILE_ZONE( "Simulation::step" );
+
+	state_update( mState, mStepSeconds );
+
+	// The particle fields and the asteroid field are independent of each
+	// other; update them in parallel.
+	JobGroup updates;
+	mBackground.update( mJobs, updates, mState.player.position, mState.thisFrame.movement );
+	mJobs.spawn( updates, [this] {
+		mAsteroids.update( mState.thisFrame.dt, mState.thisFrame.movement );
+	} );
+	mJobs.wait( updates );
+
+	mStepCount.fetch_add( 1, std::memory_order_relaxed );
+}
+
+void Simulation::publish_( Clock::time_point aStepTime )
+{
+	// The back buffer is never read by draw(), so it can be filled without
+	// any synchronization.
+	auto& back = mSnapshots[mBack];
+	mBackground.capture( back.background );
+	mAsteroids.capture( back.asteroids );
+	back.time = aStepTime;
+
+	// Make it the ready buffer, and continue with the previous ready one. If
+	// draw() has not taken that, it is simply overwritten next time.
+	mBack = mReady.exchange( mBack | kReadyFresh, std::memory_order_acq_rel ) & kReadyIndex;
+}
+
+void Simulation::thread_()
+{
+	PROFILE_THREAD_NAME( "simulation" );
+
+	try
+	{
+		while( !mStop )
+		{
+			advance( Clock::now() );
+			std::this_thread::sleep_until( mNextStepTime );
+		}
+	}
+	catch( ... )
+	{
+		std::lock_guard<std::mutex> lock( mErrorMutex );
+		mThreadError = std::current_exception();
+	}
+}
@@ -0,0 +1,145 @@
+#ifndef SIMULATION_HPP_A9654964_60B5_4568_B2D4_4216425B3308
+#define SIMULATION_HPP_A9654964_60B5_4568_B2D4_4216425B3308
+
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <exception>
+
+#include <cstdint>
+#include <cstdlib>
+
+#include "../draw2d/forward.hpp"
+
+#include "defaults.hpp"
+#include "state.hpp"
+#include "background.hpp"
+#include "asteroid_field.hpp"
+
+class JobSystem;
+
+// Player input that affects the simulation. Written by the input callbacks,
+// and picked up at the start of each simulation step.
+struct SimulationInput
+{
+	float angle = 0.f;
+	float accelerationMagnitude = 0.f;
+};
+
+/** Simulation - fixed-timestep updates of the scene
+ *
+ * The simulation owns the background and the asteroid field, and advances
+ * them in fixed steps of 1/aStepsPerSecond seconds. The amount of work per
+ * step is therefore independent of the frame rate, and the results only
+ * depend on the seed and on the input.
+ *
+ * Rendering draws from snapshots. After running one or more steps, the
+ * simulation captures its state into a triple-buffered snapshot: it fills its
+ * own buffer and then exchanges it with the ready one, which draw() picks up
+ * the next time it runs. Neither side ever waits for the other, and draw()
+ * always gets the most recent snapshot. The snapshot is drawn one step "in the
+ * past": the current state is interpolated with the state before the most
+ * recent step, based on the time that has elapsed since that step. Motion is
+ * therefore smooth even if the frame rate and the step rate differ.
+ *
+ * The steps can either run on the calling thread (call advance() once per
+ * frame) or on a separate simulation thread (call start_thread()). In the
+ * latter case, slow simulation steps never delay drawing and presenting a
+ * frame; draw() just uses the most recent complete snapshot.
+ */
+class Simulation final
+{
+	public:
+		Simulation(
+			RNG&,
+			JobSystem&,
+			std::uint32_t aWidth, std::uint32_t aHeight,
+			float aStepsPerSecond = 120.f,
+			float aStarDensityScale = 1.f,
+			std::size_t aAsteroidSpriteRotations = 0
+		);
+		~Simulation();
+
+		Simulation( Simulation const& ) = delete;
+		Simulation& operator= (Simulation const&) = delete;
+
+	public:
+		/* Runs the steps that are due at time aNow. Must not be used after
+		 * start_thread().
+		 */
+		void advance( Clock::time_point aNow );
+
+		// Run steps on a separate thread from now on.
+		void start_thread();
+
+		/* Input and resizes may be submitted from any thread. They take effect
+		 * at the start of the next step.
+		 */
+		void set_input( SimulationInput const& );
+		SimulationInput input() const;
+
+		void resize( std::uint32_t aWidth, std::uint32_t aHeight );
+
+		/* Draws the most recent snapshot, interpolated for time aNow. If the
+		 * simulation thread has failed with an exception, the exception is
+		 * rethrown here.
+		 */
+		void draw( Surface&, Clock::time_point aNow );
+
+		std::uint64_t step_count() const noexcept;
+
+	private:
+		struct Snapshot_
+		{
+			Background::Snapshot background;
+			AsteroidField::Snapshot asteroids;
+
+			Clock::time_point time; // time of the most recent step
+		};
+
+	private:
+		void step_();
+		void publish_( Clock::time_point );
+
+		void thread_();
+
+	private:
+		JobSystem& mJobs;
+
+		// Simulation state. Only accessed by the thread that runs the steps.
+		State mState;
+		Background mBackground;
+		AsteroidField mAsteroids;
+
+		Clock::duration mStepDuration;
+		float mStepSeconds;
+		Clock::time_point mNextStepTime;
+
+		std::atomic<std::uint64_t> mStepCount{ 0 };
+
+		// Pending input and resize
+		mutable std::mutex mInputMutex;
+		SimulationInput mInput;
+		bool mResizePending = false;
+		std::uint32_t mPendingWidth = 0, mPendingHeight = 0;
+
+		// Triple-buffered snapshot. mBack belongs to the simulation and mFront
+		// to draw(). mReady holds the index of the third buffer, plus
+		// kReadyFresh if the simulation has published it since draw() last
+		// took it. Either side exchanges its own buffer with the ready one.
+		static constexpr std::uint32_t kReadyFresh = 0x4;
+		static constexpr std::uint32_t kReadyIndex = 0x3;
+
+		Snapshot_ mSnapshots[3];
+		std::uint32_t mBack = 2;
+		std::uint32_t mFront = 0;
+		std::atomic<std::uint32_t> mReady{ 1 };
+
+		// Simulation thread
+		std::mutex mErrorMutex;
+		std::thread mThread;
+		std::atomic<bool> mStop{ false };
+		std::exception_ptr mThreadError;
+};
+
+#endif // SIMULATION_HPP_A9654964_60B5_4568_B2D4_4216425B3308
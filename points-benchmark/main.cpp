@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <cstdint>
+
+#include "../draw2d/surface-ex.hpp"
+
+namespace
+{
+	// Random star positions. Like the particle fields in the main program,
+	// the stars cover the surface plus a padding region around it, so a part
+	// of the points ends up outside of the surface.
+	struct Stars_
+	{
+		std::vector<float> xs, ys;
+	};
+
+	Stars_ make_stars_( std::size_t aCount, std::uint32_t aWidth, std::uint32_t aHeight, float aPadding = 50.f )
+	{
+		std::minstd_rand rng( 1234 );
+		std::uniform_real_distribution<float> xdist( -aPadding, aWidth + aPadding );
+		std::uniform_real_distribution<float> ydist( -aPadding, aHeight + aPadding );
+
+		Stars_ ret;
+		ret.xs.resize( aCount );
+		ret.ys.resize( aCount );
+
+		for( std::size_t i = 0; i < aCount; ++i )
+		{
+			ret.xs[i] = xdist( rng );
+			ret.ys[i] = ydist( rng );
+		}
+
+		return ret;
+	}
+
+	// Reference: one set_pixel_srgb() per point, with per-point conversion
+	// and bounds checks. This is what ParticleField::draw() used to do.
+	void points_set_pixel_( benchmark::State& aState )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const count = std::size_t(aState.range(2));
+
+		SurfaceEx surface( width, height );
+		surface.clear();
+
+		auto const stars = make_stars_( count, width, height );
+
+		for( auto _ : aState )
+		{
+			for( std::size_t i = 0; i < count; ++i )
+			{
+				float const x = stars.xs[i] + .5f;
+				float const y = stars.ys[i] + .5f;
+
+				if( x < 0.f || y < 0.f )
+					continue;
+
+				auto const xpos = std::uint32_t( x );
+				auto const ypos = std::uint32_t( y );
+
+				if( xpos < width && ypos < height )
+					surface.set_pixel_srgb( xpos, ypos, { 255, 255, 255 } );
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( count * aState.iterations() );
+	}
+
+	void points_draw_points_( benchmark::State& aState )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const count = std::size_t(aState.range(2));
+
+		SurfaceEx surface( width, height );
+		surface.clear();
+
+		auto const stars = make_stars_( count, width, height );
+
+		for( auto _ : aState )
+		{
+			surface.draw_points( count, stars.xs.data(), stars.ys.data(), { 255, 255, 255 } );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( count * aState.iterations() );
+	}
+}
+
+// The default background at 3840x2160 has roughly 3k stars. The larger counts
+// correspond to --stardensity=10 and beyond.
+BENCHMARK( points_set_pixel_ )
+	->Args( { 1920, 1080, 10000 } )
+	->Args( { 3840, 2160, 100000 } )
+	->Args( { 3840, 2160, 400000 } )
+	->Args( { 3840, 2160, 1600000 } )
+;
+
+BENCHMARK( points_draw_points_ )
+	->Args( { 1920, 1080, 10000 } )
+	->Args( { 3840, 2160, 100000 } )
+	->Args( { 3840, 2160, 400000 } )
+	->Args( { 3840, 2160, 1600000 } )
+;
+
+BENCHMARK_MAIN();
@@ -1,9 +1,18 @@
+newoption {
+	trigger = "profiler",
+	description = "Compile in the zone profiler (see support/profiler.hpp)"
+}
+newoption {
+	trigger = "overdraw",
+	description = "Count pixel writes per surface (see draw2d/overdraw.hpp)"
+}
+
 workspace "COMP3811-cw1"
 	language "C++"
 	cppdialect "C++20"
 
 	platforms { "x64" }
-	configurations { "debug", "release" }
+	configurations { "debug", "release", "release-lto", "release-pgo-gen", "release-pgo" }
 
 	flags "NoPCH"
 	flags "MultiProcessorCompile"
@@ -17,7 +26,11 @@ workspace "COMP3811-cw1"
 	-- Default toolset options
 	filter "toolset:gcc or toolset:clang"
 		linkoptions { "-pthread" }
-		buildoptions { "-march=native", "-Wall", "-pthread" }
+		buildoptions { "-Wall", "-pthread" }
+
+		-- No -march=native: binaries must run on any CPU of the target
+		-- architecture. The draw2d kernels are compiled for several
+		-- instruction sets and selected at runtime (see draw2d/kernels.hpp).
 
 		-- Varriable-length arrays (VLAs) are an extension that GCC and clang
 		-- have long supported. However, they are not part of the C++ standard.
@@ -34,6 +47,16 @@ workspace "COMP3811-cw1"
 	
 	filter "*"
 
+	-- zone profiler
+	filter "options:profiler"
+		defines { "SUPPORT_CFG_PROFILER=1" }
+
+	-- overdraw statistics
+	filter "options:overdraw"
+		defines { "DRAW2D_CFG_OVERDRAW=1" }
+
+	filter "*"
+
 	-- default libraries
 	filter "system:linux"
 		links "dl"
@@ -58,12 +81,54 @@ workspace "COMP3811-cw1"
 		symbols "On"
 		defines { "_DEBUG=1" }
 
-	filter "release"
+	filter "release*"
 		optimize "On"
 		defines { "NDEBUG=1" }
 
 	filter "*"
 
+	-- Link-time optimization: release-lto and release-pgo. Much of the pixel
+	-- code (e.g., Surface::set_pixel_srgb()) is called across the boundaries
+	-- of the static libraries; with LTO, it can be inlined there as well.
+	-- Plain "ar" is used for the libraries. This requires an ar with the LTO
+	-- plugin (GNU binutils 2.25 or newer; the Apple/Xcode ar). Elsewhere, run
+	-- make with AR=gcc-ar or AR=llvm-ar.
+	filter { "release-lto or release-pgo", "toolset:gcc" }
+		buildoptions { "-flto=auto" }
+		linkoptions { "-flto=auto" }
+	filter { "release-lto or release-pgo", "toolset:clang" }
+		buildoptions { "-flto" }
+		linkoptions { "-flto" }
+	filter { "release-lto or release-pgo", "toolset:msc-*" }
+		flags { "LinkTimeOptimization" }
+
+	filter "*"
+
+	-- Profile-guided optimization, in two phases (see readme.md):
+	--  1. build release-pgo-gen and run the training workloads; the
+	--     instrumented binaries write their profiles to _build_/pgo-<toolset>
+	--  2. build release-pgo, which optimizes using these profiles
+	-- All projects are located one directory below the workspace, hence the
+	-- "../". GCC names the profiles after the object files; stripping the
+	-- configuration-specific part of the object directory (everything but the
+	-- project's directory; -fprofile-prefix-path) makes the names of the two
+	-- phases match. -fprofile-update=atomic keeps the counters of the worker
+	-- threads intact. Clang's raw profiles must be merged with llvm-profdata
+	-- before phase 2.
+	filter { "release-pgo-gen", "toolset:gcc" }
+		buildoptions { "-fprofile-generate=$(abspath ../_build_/pgo-gcc)", "-fprofile-prefix-path=$(CURDIR)/$(dir $(OBJDIR))", "-fprofile-update=atomic" }
+		linkoptions { "-fprofile-generate=$(abspath ../_build_/pgo-gcc)" }
+	filter { "release-pgo", "toolset:gcc" }
+		buildoptions { "-fprofile-use=$(abspath ../_build_/pgo-gcc)", "-fprofile-prefix-path=$(CURDIR)/$(dir $(OBJDIR))", "-fprofile-partial-training", "-fprofile-correction", "-Wno-missing-profile" }
+
+	filter { "release-pgo-gen", "toolset:clang" }
+		buildoptions { "-fprofile-generate=$(abspath ../_build_/pgo-clang)" }
+		linkoptions { "-fprofile-generate=$(abspath ../_build_/pgo-clang)" }
+	filter { "release-pgo", "toolset:clang" }
+		buildoptions { "-fprofile-use=$(abspath ../_build_/pgo-clang)/default.profdata", "-Wno-profile-instr-unprofiled", "-Wno-profile-instr-out-of-date" }
+
+	filter "*"
+
 
 -- Third party dependencies
 include "third_party" 
@@ -82,9 +147,9 @@ project "main"
 
 	files( sources )
 
-	links "vmlib"
 	links "support"
 	links "draw2d"
+	links "vmlib"
 
 	links "x-stb"
 	links "x-glad"
@@ -103,15 +168,32 @@ project "draw2d"
 
 	files( sources )
 
+	-- The kernel variants for different instruction sets (and the scalar
+	-- code around them) must produce exactly the same pixels; see
+	-- draw2d/kernels.cpp. Fused multiply-adds would round differently.
+	filter "toolset:gcc or toolset:clang"
+		buildoptions { "-ffp-contract=off" }
+
+	filter "*"
+
 project "support"
 	local sources = { 
 		"support/checkpoint.cpp",
 		--"support/context.cpp", -- separate implementation on Apple
 		"support/error.cpp",
+		"support/hwcounters.cpp",
+		"support/jobs.cpp",
+		"support/profiler.cpp",
 		"support/runconfig.cpp",
 		"support/checkpoint.hpp",
 		"support/context.hpp",
 		"support/error.hpp",
+		"support/hwcounters.hpp",
+		"support/jobs.hpp",
+		"support/jobs.inl",
+		"support/profiler.hpp",
+		"support/random.hpp",
+		"support/random.inl",
 		"support/runconfig.hpp",
 	}
 
@@ -156,9 +238,9 @@ project "lines-sandbox"
 
 	files( sources )
 
-	links "vmlib"
 	links "support"
 	links "draw2d"
+	links "vmlib"
 
 	links "x-glad"
 	links "x-glfw"
@@ -176,8 +258,8 @@ project "lines-test"
 
 	files( sources )
 
-	links "vmlib"
 	links "draw2d"
+	links "vmlib"
 
 	links "x-catch2"
 
@@ -195,9 +277,9 @@ project "triangles-sandbox"
 
 	files( sources )
 
-	links "vmlib"
 	links "support"
 	links "draw2d"
+	links "vmlib"
 
 	links "x-glad"
 	links "x-glfw"
@@ -215,11 +297,30 @@ project "triangles-test"
 
 	files( sources )
 
-	links "vmlib"
 	links "draw2d"
+	links "vmlib"
 
 	links "x-catch2"
 
+project "golden-test"
+	local sources = { 
+		"golden-test/**.cpp",
+		"golden-test/**.hpp",
+		"golden-test/**.hxx",
+		"golden-test/**.inl"
+	}
+
+	kind "ConsoleApp"
+	location "golden-test"
+
+	files( sources )
+
+	links "draw2d"
+	links "support"
+	links "vmlib"
+
+	links "x-stb"
+
 project "blit-benchmark"
 	local sources = { 
 		"blit-benchmark/**.cpp",
@@ -233,9 +334,9 @@ project "blit-benchmark"
 
 	files( sources )
 
-	links "vmlib"
 	links "draw2d"
 	links "support"
+	links "vmlib"
 
 	links "x-stb"
 	links "x-benchmark"
@@ -253,9 +354,124 @@ project "lines-benchmark"
 
 	files( sources )
 
+	links "draw2d"
+	links "support"
 	links "vmlib"
+
+	links "x-benchmark"
+
+project "points-benchmark"
+	local sources = { 
+		"points-benchmark/**.cpp",
+		"points-benchmark/**.hpp",
+		"points-benchmark/**.hxx",
+		"points-benchmark/**.inl"
+	}
+
+	kind "ConsoleApp"
+	location "points-benchmark"
+
+	files( sources )
+
 	links "draw2d"
+	links "vmlib"
+
+	links "x-benchmark"
+
+project "rng-benchmark"
+	local sources = { 
+		"rng-benchmark/**.cpp",
+		"rng-benchmark/**.hpp",
+		"rng-benchmark/**.hxx",
+		"rng-benchmark/**.inl"
+	}
 
+	kind "ConsoleApp"
+	location "rng-benchmark"
+
+	files( sources )
+
+	links "x-benchmark"
+
+project "rotation-benchmark"
+	local sources = { 
+		"rotation-benchmark/**.cpp",
+		"rotation-benchmark/**.hpp",
+		"rotation-benchmark/**.hxx",
+		"rotation-benchmark/**.inl"
+	}
+
+	kind "ConsoleApp"
+	location "rotation-benchmark"
+
+	files( sources )
+
+	links "vmlib"
+
+	links "x-benchmark"
+
+project "triangles-benchmark"
+	local sources = { 
+		"triangles-benchmark/**.cpp",
+		"triangles-benchmark/**.hpp",
+		"triangles-benchmark/**.hxx",
+		"triangles-benchmark/**.inl"
+	}
+
+	kind "ConsoleApp"
+	location "triangles-benchmark"
+
+	files( sources )
+
+	links "draw2d"
+	links "support"
+	links "vmlib"
+
+	links "x-benchmark"
+
+project "scene-benchmark"
+	local sources = { 
+		"scene-benchmark/**.cpp",
+		"scene-benchmark/**.hpp",
+		"scene-benchmark/**.hxx",
+		"scene-benchmark/**.inl",
+
+		-- The scene itself, without the windowing parts (main.cpp)
+		"main/**.cpp",
+		"main/**.hpp"
+	}
+
+	kind "ConsoleApp"
+	location "scene-benchmark"
+
+	files( sources )
+	removefiles( "main/main.cpp" )
+
+	links "draw2d"
+	links "support"
+	links "vmlib"
+
+	links "x-stb"
+	links "x-benchmark"
+
+project "scaling-benchmark"
+	local sources = { 
+		"scaling-benchmark/**.cpp",
+		"scaling-benchmark/**.hpp",
+		"scaling-benchmark/**.hxx",
+		"scaling-benchmark/**.inl"
+	}
+
+	kind "ConsoleApp"
+	location "scaling-benchmark"
+
+	files( sources )
+
+	links "draw2d"
+	links "support"
+	links "vmlib"
+
+	links "x-stb"
 	links "x-benchmark"
 
 --EOF
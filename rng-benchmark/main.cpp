@@ -0,0 +1,128 @@
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+#include <cstdint>
+
+#include "../support/random.hpp"
+
+namespace
+{
+	// Number of values generated per benchmark iteration. Roughly the number
+	// of stars at 4K with --stardensity=10.
+	constexpr std::size_t kCount = 32*1024;
+
+	// std::minstd_rand with the standard library distributions. This is what
+	// the main program used previously.
+	void rng_minstd_uniform_( benchmark::State& aState )
+	{
+		std::minstd_rand rng( 1234 );
+		std::uniform_real_distribution<float> dist( -50.f, 3890.f );
+
+		std::vector<float> out( kCount );
+		for( auto _ : aState )
+		{
+			for( auto& x : out )
+				x = dist( rng );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( kCount * aState.iterations() );
+	}
+	void rng_minstd_normal_( benchmark::State& aState )
+	{
+		std::minstd_rand rng( 1234 );
+		std::normal_distribution<float> dist( 0.f, 5.f );
+
+		std::vector<float> out( kCount );
+		for( auto _ : aState )
+		{
+			for( auto& x : out )
+				x = dist( rng );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( kCount * aState.iterations() );
+	}
+
+	// Xoshiro128, one value at a time.
+	void rng_xoshiro_uniform_( benchmark::State& aState )
+	{
+		Xoshiro128 rng( 1234 );
+
+		std::vector<float> out( kCount );
+		for( auto _ : aState )
+		{
+			for( auto& x : out )
+				x = rng.uniform( -50.f, 3890.f );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( kCount * aState.iterations() );
+	}
+	void rng_xoshiro_normal_( benchmark::State& aState )
+	{
+		Xoshiro128 rng( 1234 );
+
+		std::vector<float> out( kCount );
+		for( auto _ : aState )
+		{
+			for( auto& x : out )
+				x = rng.normal( 0.f, 5.f );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( kCount * aState.iterations() );
+	}
+
+	// Xoshiro128, block fills.
+	void rng_xoshiro_fill_uniform_( benchmark::State& aState )
+	{
+		Xoshiro128 rng( 1234 );
+
+		std::vector<float> out( kCount );
+		for( auto _ : aState )
+		{
+			rng.fill_uniform( out.size(), out.data(), -50.f, 3890.f );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( kCount * aState.iterations() );
+	}
+	void rng_xoshiro_fill_normal_( benchmark::State& aState )
+	{
+		Xoshiro128 rng( 1234 );
+
+		std::vector<float> out( kCount );
+		for( auto _ : aState )
+		{
+			rng.fill_normal( out.size(), out.data(), 0.f, 5.f );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( kCount * aState.iterations() );
+	}
+}
+
+BENCHMARK( rng_minstd_uniform_ );
+BENCHMARK( rng_xoshiro_uniform_ );
+BENCHMARK( rng_xoshiro_fill_uniform_ );
+
+BENCHMARK( rng_minstd_normal_ );
+BENCHMARK( rng_xoshiro_normal_ );
+BENCHMARK( rng_xoshiro_fill_normal_ );
+
+BENCHMARK_MAIN();
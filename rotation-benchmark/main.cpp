@@ -0,0 +1,174 @@
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <vector>
+#include <algorithm>
+
+#include <cstdint>
+
+#include "../vmlib/mat22.hpp"
+#include "../vmlib/sincos.hpp"
+#include "../vmlib/transform.hpp"
+
+#include "../support/random.hpp"
+
+// Compares rotation matrices built with std::sin()/std::cos() (libm) against
+// fast_sincos(), one at a time and in bulk with make_rotations_2d().
+//
+// Each benchmark reports "maxerr", the largest absolute error of any matrix
+// element, compared to sin/cos evaluated in double precision.
+//
+// The angles are uniform in [-max, max]. max = 7 covers the asteroids'
+// rotations (in [0, 2pi), see AsteroidField); max = 2^20 checks the range
+// reduction of fast_sincos() with large angles.
+namespace
+{
+	// Uniform in [-aMax, aMax]
+	std::vector<float> make_angles_( std::size_t aCount, float aMax )
+	{
+		Xoshiro128 rng( 1234 );
+
+		std::vector<float> ret( aCount );
+		rng.fill_uniform( aCount, ret.data(), -aMax, aMax );
+		return ret;
+	}
+
+	double max_error_( std::vector<float> const& aAngles, std::vector<Mat22f> const& aRots )
+	{
+		double ret = 0.0;
+		for( std::size_t i = 0; i < aAngles.size(); ++i )
+		{
+			double const s = std::sin( double(aAngles[i]) );
+			double const c = std::cos( double(aAngles[i]) );
+
+			auto const& r = aRots[i];
+			ret = std::max( ret, std::abs( r._00 - c ) );
+			ret = std::max( ret, std::abs( r._01 + s ) );
+			ret = std::max( ret, std::abs( r._10 - s ) );
+			ret = std::max( ret, std::abs( r._11 - c ) );
+		}
+		return ret;
+	}
+
+	// make_rotation_2d() as it was before: std::cos() and std::sin()
+	Mat22f make_rotation_2d_libm_( float aAngle ) noexcept
+	{
+		float const c = std::cos( aAngle );
+		float const s = std::sin( aAngle );
+		return Mat22f{ c, -s, s, c };
+	}
+
+	void rotations_libm_( benchmark::State& aState )
+	{
+		auto const count = std::size_t(aState.range(0));
+		auto const angles = make_angles_( count, float(aState.range(1)) );
+
+		std::vector<Mat22f> out( count );
+		for( auto _ : aState )
+		{
+			for( std::size_t i = 0; i < count; ++i )
+				out[i] = make_rotation_2d_libm_( angles[i] );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( count * aState.iterations() );
+		aState.counters["maxerr"] = max_error_( angles, out );
+	}
+
+	void rotations_fast_( benchmark::State& aState )
+	{
+		auto const count = std::size_t(aState.range(0));
+		auto const angles = make_angles_( count, float(aState.range(1)) );
+
+		std::vector<Mat22f> out( count );
+		for( auto _ : aState )
+		{
+			for( std::size_t i = 0; i < count; ++i )
+				out[i] = make_rotation_2d( angles[i] );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( count * aState.iterations() );
+		aState.counters["maxerr"] = max_error_( angles, out );
+	}
+
+	void rotations_bulk_( benchmark::State& aState )
+	{
+		auto const count = std::size_t(aState.range(0));
+		auto const angles = make_angles_( count, float(aState.range(1)) );
+
+		std::vector<Mat22f> out( count );
+		for( auto _ : aState )
+		{
+			make_rotations_2d( angles, out );
+
+			benchmark::DoNotOptimize( out.data() );
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( count * aState.iterations() );
+		aState.counters["maxerr"] = max_error_( angles, out );
+	}
+
+
+	// Drift: repeatedly applying a small rotation step, as AsteroidField does
+	// each update. Reports how far the result is from a pure rotation
+	// ("drift": |det - 1|) after aState.range(0) steps, with and without
+	// re-orthonormalizing every 256 steps.
+	void rotation_drift_( benchmark::State& aState, bool aOrthonormalize )
+	{
+		auto const steps = std::size_t(aState.range(0));
+		Mat22f const step = make_rotation_2d( 1.5f / 120.f );
+
+		Mat22f rot{};
+		for( auto _ : aState )
+		{
+			rot = make_rotation_2d( 0.25f );
+			for( std::size_t i = 0; i < steps; ++i )
+			{
+				rot = step * rot;
+				if( aOrthonormalize && 255 == i % 256 )
+					rot = orthonormalize_rotation_2d( rot );
+			}
+
+			benchmark::DoNotOptimize( rot );
+		}
+
+		double const det = double(rot._00)*rot._11 - double(rot._01)*rot._10;
+
+		aState.SetItemsProcessed( steps * aState.iterations() );
+		aState.counters["drift"] = std::abs( det - 1.0 );
+	}
+}
+
+BENCHMARK( rotations_libm_ )
+	->ArgNames( { "n", "max" } )
+	->Args( { 64, 7 } )
+	->Args( { 4096, 7 } )
+	->Args( { 4096, 1 << 20 } )
+;
+BENCHMARK( rotations_fast_ )
+	->ArgNames( { "n", "max" } )
+	->Args( { 64, 7 } )
+	->Args( { 4096, 7 } )
+	->Args( { 4096, 1 << 20 } )
+;
+BENCHMARK( rotations_bulk_ )
+	->ArgNames( { "n", "max" } )
+	->Args( { 64, 7 } )
+	->Args( { 4096, 7 } )
+	->Args( { 4096, 1 << 20 } )
+;
+
+BENCHMARK_CAPTURE( rotation_drift_, plain, false )
+	->Arg( 1'000'000 )
+;
+BENCHMARK_CAPTURE( rotation_drift_, orthonormalized, true )
+	->Arg( 1'000'000 )
+;
+
+BENCHMARK_MAIN();
@@ -0,0 +1,328 @@
+#include <benchmark/benchmark.h>
+
+#include <map>
+#include <tuple>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstring>
+#include <cassert>
+
+#include "../draw2d/draw.hpp"
+#include "../draw2d/image.hpp"
+#include "../draw2d/surface-ex.hpp"
+
+#include "../support/random.hpp"
+
+// Multithreaded scaling of lines, triangles and blits. All threads draw into
+// one shared surface, each into its own horizontal band: the rows of
+// kCell x kCell cells are split evenly between the threads (so with more
+// threads than rows of cells, some threads draw nothing). Each cell holds one
+// primitive that stays within the cell:
+//  - lines:  a segment between two random points in the cell
+//  - solid:  draw_triangle_solid() of half the cell, cut along a diagonal
+//  - interp: the same with draw_triangle_interp()
+//  - blit:   blit_masked() of a kCell x kCell part of the earth's limb,
+//            with both opaque and transparent pixels
+//
+// Every iteration draws all cells of the surface once, no matter the number
+// of threads (strong scaling). The time is wall-clock time (UseRealTime), so
+// items_per_second is the aggregate fill rate of all threads in pixels/s, and
+// bytes_per_second the rate at which the surface is written (4 bytes per
+// pixel; the blit source is small enough to stay in the cache). Pixels are
+// counted exactly, once per thread before the timed loop; cells don't
+// overlap, so no pixel is counted twice.
+//
+// "efficiency" is the parallel efficiency: the aggregate rate divided by the
+// number of threads times the single-threaded rate of the same case. It is
+// reported only if the single-threaded case ran earlier in the same process
+// (i.e., was not filtered out). Where the efficiency drops off as threads are
+// added to a memory-bound case (solid, blit) but not to a compute-bound one
+// (interp, lines), memory bandwidth has saturated.
+//
+// Each thread is the first to write to the memory of its band, which places
+// that memory on the thread's NUMA node (with the default first-touch policy
+// on Linux).
+//
+// Note: the blits load assets/earth.png, so the benchmark must run from the
+// repository's root directory.
+namespace
+{
+	enum class Kind_
+	{
+		lines,
+		solid,
+		interp,
+		blit
+	};
+
+	constexpr std::int32_t kCell = 64;
+	constexpr std::uint32_t kSeed = 1234;
+
+	ColorF const kTriangleColors[3] = { { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f } };
+
+	using Clock_ = std::chrono::steady_clock;
+
+	// A square part of a larger image
+	class ImageTile_ final : public ImageRGBA
+	{
+		public:
+			ImageTile_( ImageRGBA const& aSource, Index aX, Index aY, Index aSize )
+				: mPixels( std::size_t(aSize) * aSize * 4 )
+			{
+				assert( aX + aSize <= aSource.get_width() && aY + aSize <= aSource.get_height() );
+				for( Index y = 0; y < aSize; ++y )
+				{
+					std::memcpy(
+						mPixels.data() + std::size_t(y) * aSize * 4,
+						aSource.get_image_ptr() + std::size_t(aSource.get_linear_index( aX, aY + y )) * 4,
+						std::size_t(aSize) * 4
+					);
+				}
+
+				mWidth = aSize;
+				mHeight = aSize;
+				mData = mPixels.data();
+			}
+
+		private:
+			std::vector<std::uint8_t> mPixels;
+	};
+
+	// State shared by the threads of a run. The surface and the tile are
+	// created by setup_() before the threads start.
+	struct Shared_
+	{
+		std::unique_ptr<SurfaceEx> surface;
+		std::unique_ptr<ImageRGBA> tile;
+
+		// Pixels drawn per iteration, summed over all threads
+		std::atomic<std::int64_t> pixels{ 0 };
+
+		// Aggregate pixels/s of the single-threaded runs
+		std::map<std::tuple<Kind_, std::int64_t, std::int64_t>, double> singleThreadRate;
+	};
+
+	Shared_& shared_()
+	{
+		static Shared_ shared;
+		return shared;
+	}
+
+	void setup_( benchmark::State const& aState )
+	{
+		auto& shared = shared_();
+		shared.surface = std::make_unique<SurfaceEx>( std::uint32_t(aState.range(0)), std::uint32_t(aState.range(1)) );
+		shared.pixels = 0;
+	}
+	void setup_blit_( benchmark::State const& aState )
+	{
+		setup_( aState );
+
+		auto const earth = load_image( "assets/earth.png" );
+		assert( earth && earth->get_width() >= 4*kCell && earth->get_height() >= 4*kCell );
+
+		// On the limb, at 45 degrees to the upper left of the center (the
+		// disk's radius is about 0.44 of the image's size)
+		auto const x = std::uint32_t(.19f * earth->get_width()) - kCell/2;
+		auto const y = std::uint32_t(.19f * earth->get_height()) - kCell/2;
+		shared_().tile = std::make_unique<ImageTile_>( *earth, x, y, kCell );
+	}
+
+	void teardown_( benchmark::State const& )
+	{
+		auto& shared = shared_();
+		shared.surface.reset();
+		shared.tile.reset();
+	}
+
+
+	struct Band_
+	{
+		std::int32_t y0, y1; // rows [y0, y1)
+	};
+
+	Band_ get_band_( benchmark::State const& aState, std::uint32_t aHeight )
+	{
+		std::int32_t const rows = std::int32_t(aHeight) / kCell;
+		std::int32_t const index = aState.thread_index(), count = aState.threads();
+		return Band_{ rows * index / count * kCell, rows * (index+1) / count * kCell };
+	}
+
+	// Lines use p[0] and p[1], blits p[0] only.
+	struct Cell_
+	{
+		Vec2f p[3];
+	};
+
+	std::vector<Cell_> make_cells_( Kind_ aKind, std::uint32_t aWidth, Band_ const& aBand, std::uint32_t aSeed )
+	{
+		Xoshiro128 rng( aSeed );
+
+		std::vector<Cell_> ret;
+		for( std::int32_t y = aBand.y0; y < aBand.y1; y += kCell )
+		{
+			for( std::int32_t x = 0; x + kCell <= std::int32_t(aWidth); x += kCell )
+			{
+				// Centers of the cell's outermost pixels
+				float const x0 = x + .5f, x1 = x + kCell - .5f;
+				float const y0 = y + .5f, y1 = y + kCell - .5f;
+
+				Cell_ cell{};
+				switch( aKind )
+				{
+					case Kind_::lines:
+						cell.p[0] = Vec2f{ rng.uniform( x0, x1 ), rng.uniform( y0, y1 ) };
+						cell.p[1] = Vec2f{ rng.uniform( x0, x1 ), rng.uniform( y0, y1 ) };
+						break;
+
+					case Kind_::solid:
+					case Kind_::interp:
+					{
+						// Three of the four corners; this picks one of the two
+						// diagonals and one of its sides.
+						Vec2f const corners[4] = { { x0, y0 }, { x1, y0 }, { x1, y1 }, { x0, y1 } };
+						auto const skip = std::size_t(rng.uniform() * 4.f) % 4;
+						for( std::size_t i = 0; i < 3; ++i )
+							cell.p[i] = corners[(skip + 1 + i) % 4];
+						break;
+					}
+
+					case Kind_::blit:
+						cell.p[0] = Vec2f{ float(x), float(y) };
+						break;
+				}
+
+				ret.emplace_back( cell );
+			}
+		}
+
+		return ret;
+	}
+
+	void draw_( Kind_ aKind, Surface& aSurface, ImageRGBA const* aTile, Cell_ const& aCell )
+	{
+		switch( aKind )
+		{
+			case Kind_::lines:
+				draw_line_solid( aSurface, aCell.p[0], aCell.p[1], { 255, 255, 255 } );
+				break;
+			case Kind_::solid:
+				draw_triangle_solid( aSurface, aCell.p[0], aCell.p[1], aCell.p[2], { 255, 255, 255 } );
+				break;
+			case Kind_::interp:
+				draw_triangle_interp( aSurface, aCell.p[0], aCell.p[1], aCell.p[2], kTriangleColors[0], kTriangleColors[1], kTriangleColors[2] );
+				break;
+			case Kind_::blit:
+				blit_masked( aSurface, *aTile, aCell.p[0] );
+				break;
+		}
+	}
+
+	// Pixels written when drawing all cells of the band. The Surface write
+	// functions clear the padding byte, which marks the written pixels.
+	std::int64_t count_pixels_( Kind_ aKind, SurfaceEx& aSurface, ImageRGBA const* aTile, Band_ const& aBand, std::vector<Cell_> const& aCells )
+	{
+		std::uint8_t* const band = aSurface.get_surface_ptr() + std::size_t(aBand.y0) * aSurface.get_width() * 4;
+		std::size_t const bytes = std::size_t(aBand.y1 - aBand.y0) * aSurface.get_width() * 4;
+		std::memset( band, 0xff, bytes );
+
+		for( auto const& cell : aCells )
+			draw_( aKind, aSurface, aTile, cell );
+
+		std::int64_t ret = 0;
+		for( std::size_t i = 3; i < bytes; i += 4 )
+			ret += (0 == band[i]);
+
+		return ret;
+	}
+
+	void scaling_( benchmark::State& aState, Kind_ aKind )
+	{
+		auto& shared = shared_();
+		auto& surface = *shared.surface;
+		auto const* tile = shared.tile.get();
+
+		auto const band = get_band_( aState, surface.get_height() );
+		auto const cells = make_cells_( aKind, surface.get_width(), band, kSeed + std::uint32_t(aState.thread_index()) );
+
+		auto const pixels = count_pixels_( aKind, surface, tile, band, cells );
+		shared.pixels += pixels;
+
+		// All threads start the loop together and wait for each other at its
+		// end, so the time from the first iteration to the end of the loop
+		// is the wall-clock time of the run.
+		Clock_::time_point begin{};
+		for( auto _ : aState )
+		{
+			if( Clock_::time_point{} == begin )
+				begin = Clock_::now();
+
+			for( auto const& cell : cells )
+				draw_( aKind, surface, tile, cell );
+
+			benchmark::ClobberMemory();
+		}
+
+		auto const elapsed = std::chrono::duration<double>( Clock_::now() - begin ).count();
+
+		aState.SetItemsProcessed( pixels * aState.iterations() );
+		aState.SetBytesProcessed( 4 * pixels * aState.iterations() );
+		aState.counters["cells"] = double(cells.size());
+
+		if( 0 == aState.thread_index() && elapsed > 0.0 )
+		{
+			double const rate = double(shared.pixels) * aState.iterations() / elapsed;
+			auto const key = std::make_tuple( aKind, aState.range(0), aState.range(1) );
+
+			if( 1 == aState.threads() )
+				shared.singleThreadRate[key] = rate;
+
+			// Counters are summed over the threads; only this one sets it.
+			if( auto const it = shared.singleThreadRate.find( key ); it != shared.singleThreadRate.end() && it->second > 0.0 )
+				aState.counters["efficiency"] = rate / (aState.threads() * it->second);
+		}
+	}
+
+	// 1, 2, 4, ... up to the number of hardware threads (which is always
+	// included), at 1920x1080 (8 MB, mostly in the cache of large CPUs) and
+	// 7680x4320 (133 MB).
+	void cases_( benchmark::internal::Benchmark* aBench )
+	{
+		aBench->ArgNames( { "w", "h" } );
+		aBench->Args( { 1920, 1080 } );
+		aBench->Args( { 7680, 4320 } );
+
+		aBench->ThreadRange( 1, int(std::max( 1u, std::thread::hardware_concurrency() )) );
+		aBench->UseRealTime();
+		aBench->Unit( benchmark::kMillisecond );
+	}
+}
+
+BENCHMARK_CAPTURE( scaling_, lines, Kind_::lines )
+	->Apply( cases_ )
+	->Setup( setup_ )
+	->Teardown( teardown_ )
+;
+BENCHMARK_CAPTURE( scaling_, solid, Kind_::solid )
+	->Apply( cases_ )
+	->Setup( setup_ )
+	->Teardown( teardown_ )
+;
+BENCHMARK_CAPTURE( scaling_, interp, Kind_::interp )
+	->Apply( cases_ )
+	->Setup( setup_ )
+	->Teardown( teardown_ )
+;
+BENCHMARK_CAPTURE( scaling_, blit, Kind_::blit )
+	->Apply( cases_ )
+	->Setup( setup_blit_ )
+	->Teardown( teardown_ )
+;
+
+BENCHMARK_MAIN();
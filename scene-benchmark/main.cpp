@@ -0,0 +1,149 @@
+#include <benchmark/benchmark.h>
+
+#include <chrono>
+
+#include <cstdint>
+
+#include "../draw2d/shape.hpp"
+#include "../draw2d/surface-ex.hpp"
+
+#include "../support/jobs.hpp"
+
+#include "../vmlib/mat22.hpp"
+
+#include "../main/defaults.hpp"
+#include "../main/spaceship.hpp"
+#include "../main/simulation.hpp"
+
+// End-to-end frames: the scene of the main program (background, asteroids and
+// the spaceship), without a window. Each iteration renders one frame like
+// render_frame() in main/main.cpp: advance the simulation, clear, draw the
+// simulation's snapshot, draw the spaceship.
+//
+// Everything is deterministic: the RNG has a fixed seed, the simulation is
+// driven by a synthetic clock (60 frames per second, 120 simulation steps per
+// second), and the player input is replayed from a fixed trace. All updates
+// run on the calling thread.
+//
+// Arguments are the surface size, the star density (percent of the default)
+// and the number of asteroid sprite rotations (0 = exact asteroids). Besides
+// the total time per frame, "update_ms" and "draw_ms" report the average time
+// per frame spent in the simulation steps and in drawing, respectively.
+//
+// Note: the background loads assets/earth.png, so the benchmark must run from
+// the repository's root directory.
+namespace
+{
+	constexpr float kFramesPerSecond = 60.f;
+	constexpr float kStepsPerSecond = 120.f;
+	constexpr std::uint32_t kSeed = 1234;
+
+	// Recorded input: at frame 'frame', the player's angle and acceleration
+	// change to the given values (as with the mouse and the right mouse
+	// button in piloting mode). The trace is 8 seconds long and loops.
+	struct InputEvent_
+	{
+		std::uint32_t frame;
+		SimulationInput input;
+	};
+
+	constexpr InputEvent_ kInputTrace_[] = {
+		{   0, {  0.00f,   0.f } },
+		{  30, {  0.35f, 500.f } },
+		{  75, {  0.90f, 500.f } },
+		{ 110, {  1.60f,   0.f } },
+		{ 150, {  2.40f, 500.f } },
+		{ 200, {  3.10f, 500.f } },
+		{ 240, { -2.70f,   0.f } },
+		{ 290, { -1.90f, 500.f } },
+		{ 330, { -1.20f, 500.f } },
+		{ 380, { -0.40f,   0.f } },
+		{ 420, {  0.20f, 500.f } },
+		{ 460, {  0.00f,   0.f } },
+	};
+	constexpr std::uint32_t kTraceFrames_ = 480;
+
+	SimulationInput input_at_( std::uint32_t aFrame ) noexcept
+	{
+		auto const frame = aFrame % kTraceFrames_;
+
+		SimulationInput ret{};
+		for( auto const& ev : kInputTrace_ )
+		{
+			if( ev.frame <= frame )
+				ret = ev.input;
+		}
+		return ret;
+	}
+
+	void scene_( benchmark::State& aState )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const density = float(aState.range(2)) / 100.f;
+		auto const sprites = std::size_t(aState.range(3));
+
+		RNG rng( kSeed );
+		JobSystem jobs( 1 );
+
+		Simulation simulation( rng, jobs, width, height, kStepsPerSecond, density, sprites );
+		auto const spaceship = make_spaceship_shape();
+
+		SurfaceEx surface( width, height );
+
+		// Synthetic clock. Frames are placed half a step after the steps
+		// that are due, so each frame runs exactly two steps.
+		auto const frameDuration = std::chrono::duration_cast<Clock::duration>( Secondsf( 1.f / kFramesPerSecond ) );
+		auto const halfStep = std::chrono::duration_cast<Clock::duration>( Secondsf( .5f / kStepsPerSecond ) );
+		auto const start = Clock::now() + halfStep;
+
+		std::uint32_t frame = 0;
+		Clock::duration updateTime{}, drawTime{};
+
+		for( auto _ : aState )
+		{
+			auto const now = start + frame * frameDuration;
+
+			auto const t0 = Clock::now();
+
+			simulation.set_input( input_at_( frame ) );
+			simulation.advance( now );
+
+			auto const t1 = Clock::now();
+
+			surface.clear();
+			simulation.draw( surface, now );
+
+			auto const rot = make_rotation_2d( simulation.input().angle );
+			auto const offs = Vec2f{ width * 0.5f, height * 0.5f };
+			spaceship.draw( surface, { 0.2f, 0.4f, 0.7f }, rot, offs );
+
+			benchmark::ClobberMemory();
+
+			auto const t2 = Clock::now();
+
+			updateTime += t1 - t0;
+			drawTime += t2 - t1;
+			++frame;
+		}
+
+		using Ms = std::chrono::duration<double, std::milli>;
+		aState.counters["update_ms"] = benchmark::Counter( Ms( updateTime ).count(), benchmark::Counter::kAvgIterations );
+		aState.counters["draw_ms"] = benchmark::Counter( Ms( drawTime ).count(), benchmark::Counter::kAvgIterations );
+		aState.counters["steps"] = benchmark::Counter( double(simulation.step_count()), benchmark::Counter::kAvgIterations );
+		aState.SetItemsProcessed( aState.iterations() );
+	}
+}
+
+BENCHMARK( scene_ )
+	->ArgNames( { "w", "h", "stars%", "sprites" } )
+	->Args( { 1280, 720, 100, 0 } )
+	->Args( { 1920, 1080, 100, 0 } )
+	->Args( { 3840, 2160, 100, 0 } )
+	->Args( { 1920, 1080, 25, 0 } )
+	->Args( { 1920, 1080, 400, 0 } )
+	->Args( { 1920, 1080, 100, 64 } )
+	->Unit( benchmark::kMillisecond )
+;
+
+BENCHMARK_MAIN();
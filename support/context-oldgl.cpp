@@ -9,6 +9,7 @@
 
 #include "error.hpp"
 #include "checkpoint.hpp"
+#include "profiler.hpp"
 
 #include "../draw2d/surface.hpp"
 
@@ -106,6 +107,8 @@ Context::~Context()
 
 void Context::draw( Surface const& aSurface )
 {
+	PROFILE_ZONE( "Context::draw" );
+
 	OGL_CHECKPOINT_DEBUG();
 
 	// Upload texture image
@@ -9,6 +9,7 @@
 
 #include "error.hpp"
 #include "checkpoint.hpp"
+#include "profiler.hpp"
 
 #include "../draw2d/surface.hpp"
 
@@ -122,6 +123,8 @@ Context::~Context()
 
 void Context::draw( Surface const& aSurface )
 {
+	PROFILE_ZONE( "Context::draw" );
+
 	OGL_CHECKPOINT_DEBUG();
 
 	// Calling glInvalidateFramebuffer() seems tempting at this point, to
@@ -0,0 +1,129 @@
+#include "hwcounters.hpp"
+
+#if defined(__linux__)
+#	include <linux/perf_event.h>
+#	include <sys/ioctl.h>
+#	include <sys/syscall.h>
+#	include <unistd.h>
+#endif
+
+#if defined(__linux__)
+namespace
+{
+	constexpr std::uint64_t kEvents_[] = {
+		PERF_COUNT_HW_INSTRUCTIONS,
+		PERF_COUNT_HW_CPU_CYCLES,
+		PERF_COUNT_HW_CACHE_MISSES
+	};
+
+	int open_counter_( std::uint64_t aEvent, int aLeader ) noexcept
+	{
+		perf_event_attr attr{};
+		attr.size = sizeof(attr);
+		attr.type = PERF_TYPE_HARDWARE;
+		attr.config = aEvent;
+		attr.disabled = (-1 == aLeader); // the group is enabled via the leader
+		attr.exclude_kernel = 1;
+		attr.exclude_hv = 1;
+		attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID;
+
+		// This thread, any CPU
+		return int(syscall( SYS_perf_event_open, &attr, 0, -1, aLeader, 0 ));
+	}
+}
+
+HwCounters::HwCounters()
+{
+	for( int i = 0; i < kCounterCount; ++i )
+	{
+		mFds[i] = open_counter_( kEvents_[i], mLeader );
+		if( -1 == mLeader )
+			mLeader = mFds[i];
+	}
+}
+
+HwCounters::~HwCounters()
+{
+	for( int fd : mFds )
+	{
+		if( -1 != fd )
+			close( fd );
+	}
+}
+
+bool HwCounters::available() const noexcept
+{
+	return -1 != mLeader;
+}
+
+void HwCounters::start() noexcept
+{
+	if( -1 != mLeader )
+		ioctl( mLeader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP );
+}
+void HwCounters::stop() noexcept
+{
+	if( -1 != mLeader )
+		ioctl( mLeader, PERF_EVENT_IOC_DISABLE, PERF_IOC_FLAG_GROUP );
+}
+void HwCounters::reset() noexcept
+{
+	if( -1 != mLeader )
+		ioctl( mLeader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP );
+}
+
+HwCounters::Counts HwCounters::counts() const noexcept
+{
+	Counts ret;
+	if( -1 == mLeader )
+		return ret;
+
+	// PERF_FORMAT_GROUP | PERF_FORMAT_ID: the number of counters, followed
+	// by a (value, id) pair for each counter in the group.
+	std::uint64_t buffer[1 + 2*kCounterCount] = {};
+	if( read( mLeader, buffer, sizeof(buffer) ) < ssize_t(sizeof(std::uint64_t)) )
+		return ret;
+
+	std::uint64_t* const out[kCounterCount] = { &ret.instructions, &ret.cycles, &ret.cacheMisses };
+	for( int i = 0; i < kCounterCount; ++i )
+	{
+		if( -1 == mFds[i] )
+			continue;
+
+		std::uint64_t id = 0;
+		if( ioctl( mFds[i], PERF_EVENT_IOC_ID, &id ) < 0 )
+			continue;
+
+		for( std::uint64_t j = 0; j < buffer[0] && j < std::uint64_t(kCounterCount); ++j )
+		{
+			if( buffer[2 + 2*j] == id )
+				*out[i] = buffer[1 + 2*j];
+		}
+	}
+
+	return ret;
+}
+
+#else // !__linux__
+
+HwCounters::HwCounters() = default;
+HwCounters::~HwCounters() = default;
+
+bool HwCounters::available() const noexcept
+{
+	return false;
+}
+
+void HwCounters::start() noexcept
+{}
+void HwCounters::stop() noexcept
+{}
+void HwCounters::reset() noexcept
+{}
+
+HwCounters::Counts HwCounters::counts() const noexcept
+{
+	return Counts{};
+}
+
+#endif // ~ __linux__
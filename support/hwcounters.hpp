@@ -0,0 +1,87 @@
+#ifndef HWCOUNTERS_HPP_740C93A7_9EA0_47E2_8D52_CB59A93BF596
+#define HWCOUNTERS_HPP_740C93A7_9EA0_47E2_8D52_CB59A93BF596
+
+#include <string>
+
+#include <cstdint>
+
+/** HwCounters - hardware performance counters of the calling thread
+ *
+ * Counts retired instructions, CPU cycles and last-level cache misses in
+ * user mode. The counters are opened as one group with perf_event_open() on
+ * Linux, so that all of them cover exactly the same code:
+ *
+ *   HwCounters hw;
+ *   hw.start();
+ *   draw_many_things();
+ *   hw.stop();
+ *   auto const c = hw.counts(); // c.instructions, c.cycles, c.cacheMisses
+ *
+ * Counts accumulate over several start()/stop() pairs until reset().
+ *
+ * The counters are not always available: not on other systems, not in most
+ * virtual machines, and not with kernel.perf_event_paranoid set above 2. In
+ * that case available() returns false, and all counts remain zero. Counters
+ * that the CPU lacks (e.g. cache misses on some cores) are zero, too.
+ */
+class HwCounters final
+{
+	public:
+		struct Counts
+		{
+			std::uint64_t instructions = 0;
+			std::uint64_t cycles = 0;
+			std::uint64_t cacheMisses = 0;
+		};
+
+	public:
+		HwCounters();
+		~HwCounters();
+
+		HwCounters( HwCounters const& ) = delete;
+		HwCounters& operator= (HwCounters const&) = delete;
+
+	public:
+		bool available() const noexcept;
+
+		void start() noexcept;
+		void stop() noexcept;
+		void reset() noexcept;
+
+		Counts counts() const noexcept;
+
+	private:
+		static constexpr int kCounterCount = 3;
+
+		// File descriptors; the first valid one leads the group.
+		int mFds[kCounterCount] = { -1, -1, -1 };
+		int mLeader = -1;
+};
+
+/* Adds the counts as user counters of a benchmark, normalized by aItems
+ * (e.g., the number of pixels written in all iterations):
+ *   - "insn/<item>": instructions per item
+ *   - "miss/<item>": last-level cache misses per item
+ *   - "IPC": instructions per cycle
+ * Rasterizers that are compute-bound show many instructions and a high IPC;
+ * memory-bound blits and fills show cache misses and a low IPC.
+ *
+ * tState is benchmark::State (Google Benchmark); this header does not
+ * depend on the benchmark library itself. Nothing is added if the counters
+ * are not available.
+ */
+template< class tState >
+void add_hw_counters( tState& aState, HwCounters const& aCounters, double aItems, char const* aItemName = "px" )
+{
+	if( !aCounters.available() || !(aItems > 0.0) )
+		return;
+
+	auto const c = aCounters.counts();
+	aState.counters["insn/" + std::string(aItemName)] = double(c.instructions) / aItems;
+	aState.counters["miss/" + std::string(aItemName)] = double(c.cacheMisses) / aItems;
+
+	if( c.cycles )
+		aState.counters["IPC"] = double(c.instructions) / double(c.cycles);
+}
+
+#endif // HWCOUNTERS_HPP_740C93A7_9EA0_47E2_8D52_CB59A93BF596
@@ -0,0 +1,167 @@
+#include "jobs.hpp"
+
+#include <string>
+#include <utility>
+#include <algorithm>
+
+#include <cassert>
+
+#include "profiler.hpp"
+
+namespace
+{
+	// Identifies the worker (if any) that the current thread belongs to. Used
+	// to pick the queue that spawn() pushes to and that wait() pops from.
+	thread_local JobSystem const* tCurrentSystem_ = nullptr;
+	thread_local std::size_t tCurrentQueue_ = 0;
+}
+
+JobGroup::~JobGroup()
+{
+	assert( 0 == mPending.load() );
+}
+
+
+JobSystem::JobSystem( std::size_t aThreadCount )
+{
+	if( 0 == aThreadCount )
+		aThreadCount = std::max( 1u, std::thread::hardware_concurrency() );
+
+	mQueues.reserve( aThreadCount );
+	for( std::size_t i = 0; i < aThreadCount; ++i )
+		mQueues.emplace_back( std::make_unique<Queue_>() );
+
+	mWorkers.reserve( aThreadCount-1 );
+	for( std::size_t i = 1; i < aThreadCount; ++i )
+		mWorkers.emplace_back( [this, i] { worker_( i ); } );
+}
+
+JobSystem::~JobSystem()
+{
+	{
+		std::lock_guard<std::mutex> lock( mSleepMutex );
+		mStop = true;
+	}
+	mSleepCV.notify_all();
+
+	for( auto& worker : mWorkers )
+		worker.join();
+
+	// All groups must have been waited on before the system is destroyed.
+	assert( 0 == mQueued.load() );
+}
+
+
+void JobSystem::spawn( JobGroup& aGroup, Job aJob )
+{
+	assert( aJob );
+
+	// Single threaded: just run the job.
+	if( mWorkers.empty() )
+	{
+		aJob();
+		return;
+	}
+
+	aGroup.mPending.fetch_add( 1, std::memory_order_relaxed );
+
+	// Count the job before it becomes visible in a queue, so that the count
+	// never drops below zero when a job is stolen immediately. Taking the
+	// sleep mutex avoids a lost wake-up: a worker that has just checked
+	// mQueued (under the mutex) cannot miss the notification.
+	{
+		std::lock_guard<std::mutex> lock( mSleepMutex );
+		mQueued.fetch_add( 1, std::memory_order_relaxed );
+	}
+
+	auto& queue = *mQueues[queue_index_()];
+	{
+		std::lock_guard<std::mutex> lock( queue.mutex );
+		queue.entries.emplace_back( Entry_{ std::move(aJob), &aGroup } );
+	}
+
+	mSleepCV.notify_one();
+}
+
+void JobSystem::wait( JobGroup& aGroup )
+{
+	auto const self = queue_index_();
+
+	while( 0 != aGroup.mPending.load( std::memory_order_acquire ) )
+	{
+		if( !try_run_one_( self ) )
+			std::this_thread::yield();
+	}
+}
+
+
+bool JobSystem::try_run_one_( std::size_t aSelf )
+{
+	if( 0 == mQueued.load( std::memory_order_acquire ) )
+		return false;
+
+	Entry_ entry{ {}, nullptr };
+
+	// Own queue first (LIFO)...
+	{
+		auto& own = *mQueues[aSelf];
+		std::lock_guard<std::mutex> lock( own.mutex );
+		if( !own.entries.empty() )
+		{
+			entry = std::move(own.entries.back());
+			own.entries.pop_back();
+		}
+	}
+
+	// ... then try to steal from the others (FIFO). Start with the queue after
+	// our own, so that workers spread out instead of all hitting queue 0.
+	auto const count = mQueues.size();
+	for( std::size_t i = 1; !entry.group && i < count; ++i )
+	{
+		auto& other = *mQueues[(aSelf+i) % count];
+		std::lock_guard<std::mutex> lock( other.mutex );
+		if( !other.entries.empty() )
+		{
+			entry = std::move(other.entries.front());
+			other.entries.pop_front();
+		}
+	}
+
+	if( !entry.group )
+		return false;
+
+	mQueued.fetch_sub( 1, std::memory_order_relaxed );
+
+	entry.job();
+
+	entry.group->mPending.fetch_sub( 1, std::memory_order_release );
+	return true;
+}
+
+std::size_t JobSystem::queue_index_() const noexcept
+{
+	return this == tCurrentSystem_ ? tCurrentQueue_ : 0;
+}
+
+
+void JobSystem::worker_( std::size_t aQueueIndex )
+{
+	tCurrentSystem_ = this;
+	tCurrentQueue_ = aQueueIndex;
+
+	PROFILE_THREAD_NAME( ("job worker " + std::to_string( aQueueIndex )).c_str() );
+
+	while( true )
+	{
+		if( try_run_one_( aQueueIndex ) )
+			continue;
+
+		std::unique_lock<std::mutex> lock( mSleepMutex );
+		mSleepCV.wait( lock, [this] {
+			return mStop || 0 != mQueued.load( std::memory_order_acquire );
+		} );
+
+		if( mStop )
+			break;
+	}
+}
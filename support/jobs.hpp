@@ -0,0 +1,121 @@
+#ifndef JOBS_HPP_C39C3369_209D_48C1_89F0_D30495CD9744
+#define JOBS_HPP_C39C3369_209D_48C1_89F0_D30495CD9744
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include <cstdlib>
+
+/** JobGroup - a set of jobs that can be waited on
+ *
+ * Jobs are spawned into a group with JobSystem::spawn(). JobSystem::wait()
+ * returns once all jobs in the group (including any jobs that were spawned
+ * into the group by other jobs) have completed. This gives a simple fork-join
+ * model:
+ *
+ *   JobGroup group;
+ *   jobs.spawn( group, [&] { do_a(); } );
+ *   jobs.spawn( group, [&] { do_b(); } );
+ *   jobs.wait( group ); // do_a() and do_b() have both completed here
+ *
+ * A group must not be destroyed while it has pending jobs.
+ */
+class JobGroup final
+{
+	public:
+		JobGroup() = default;
+		~JobGroup();
+
+		JobGroup( JobGroup const& ) = delete;
+		JobGroup& operator= (JobGroup const&) = delete;
+
+	private:
+		friend class JobSystem;
+		std::atomic<std::size_t> mPending{ 0 };
+};
+
+/** JobSystem - a small work-stealing job system
+ *
+ * The job system owns a number of worker threads. Each worker has its own
+ * queue. Workers take jobs from the back of their own queue (newest first,
+ * which tends to be cache friendly when jobs spawn further jobs), and steal
+ * from the front of other queues when their own queue runs dry. Jobs spawned
+ * from outside of the job system (e.g., from the main thread) go to a shared
+ * queue that all workers steal from.
+ *
+ * A thread that calls wait() helps out by running queued jobs until the group
+ * it is waiting on has completed. The calling thread is therefore counted as
+ * one of the threads: JobSystem( 4 ) starts three workers.
+ *
+ * With a thread count of one, no workers are started and spawn() runs each
+ * job immediately on the calling thread. This is the single-threaded
+ * fall-back. (A thread count of zero picks the number of hardware threads.)
+ *
+ * Jobs must not throw. An exception escaping from a job on a worker thread
+ * will terminate the program.
+ */
+class JobSystem final
+{
+	public:
+		using Job = std::function<void()>;
+
+	public:
+		explicit JobSystem( std::size_t aThreadCount = 0 );
+		~JobSystem();
+
+		JobSystem( JobSystem const& ) = delete;
+		JobSystem& operator= (JobSystem const&) = delete;
+
+	public:
+		void spawn( JobGroup&, Job );
+		void wait( JobGroup& );
+
+		/* Split the index range [0, aCount) into chunks of (at most) aGrain
+		 * indices and call aFunc( begin, end ) for each chunk. Chunks are
+		 * spawned into the provided group; use wait() to join.
+		 */
+		template< typename tFunc >
+		void spawn_range( JobGroup&, std::size_t aCount, std::size_t aGrain, tFunc&& aFunc );
+
+		// Number of threads that execute jobs, including the calling thread.
+		std::size_t thread_count() const noexcept;
+
+	private:
+		struct Entry_
+		{
+			Job job;
+			JobGroup* group;
+		};
+		struct Queue_
+		{
+			std::mutex mutex;
+			std::deque<Entry_> entries;
+		};
+
+	private:
+		bool try_run_one_( std::size_t aQueueIndex );
+		std::size_t queue_index_() const noexcept;
+
+		void worker_( std::size_t aQueueIndex );
+
+	private:
+		// Queue 0 is the shared queue used by non-worker threads. Queue i > 0
+		// belongs to worker thread i.
+		std::vector<std::unique_ptr<Queue_>> mQueues;
+		std::vector<std::thread> mWorkers;
+
+		std::atomic<std::size_t> mQueued{ 0 };
+
+		std::mutex mSleepMutex;
+		std::condition_variable mSleepCV;
+		bool mStop = false;
+};
+
+#include "jobs.inl"
+#endif // JOBS_HPP_C39C3369_209D_48C1_89F0_D30495CD9744
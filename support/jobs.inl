@@ -0,0 +1,27 @@
+#include <memory>
+#include <utility>
+#include <algorithm>
+#include <type_traits>
+
+template< typename tFunc > inline
+void JobSystem::spawn_range( JobGroup& aGroup, std::size_t aCount, std::size_t aGrain, tFunc&& aFunc )
+{
+	if( 0 == aGrain )
+		aGrain = 1;
+
+	// The chunks share a single copy of the function object. The caller may
+	// pass a temporary, which would be gone by the time the jobs run.
+	auto const func = std::make_shared<std::decay_t<tFunc>>( std::forward<tFunc>(aFunc) );
+
+	for( std::size_t beg = 0; beg < aCount; beg += aGrain )
+	{
+		std::size_t const end = std::min( beg + aGrain, aCount );
+		spawn( aGroup, [beg, end, func] { (*func)( beg, end ); } );
+	}
+}
+
+inline
+std::size_t JobSystem::thread_count() const noexcept
+{
+	return mWorkers.size() + 1;
+}
@@ -0,0 +1,111 @@
+#include "profiler.hpp"
+
+#include <algorithm>
+
+#include <cstdio>
+#include <cinttypes>
+
+#include "error.hpp"
+
+namespace
+{
+	void write_string_( std::FILE*, char const* );
+}
+
+std::size_t write_chrome_trace( char const* aPath )
+{
+	if constexpr( !kProfilerEnabled )
+	{
+		(void)aPath;
+		return 0;
+	}
+
+	auto& registry = detail::profile_registry();
+	std::lock_guard<std::mutex> lock( registry.mutex );
+
+	// Ticks per microsecond, measured against steady_clock over the lifetime
+	// of the registry.
+	double ticksPerUs = 1000.0;
+	if constexpr( SUPPORT_PROFILER_RDTSC_ )
+	{
+		auto const ticks = detail::profile_now() - registry.startTicks;
+		auto const elapsed = std::chrono::duration<double, std::micro>( std::chrono::steady_clock::now() - registry.startTime ).count();
+		if( ticks && elapsed > 0.0 )
+			ticksPerUs = double(ticks) / elapsed;
+	}
+
+	// Timestamps are relative to the earliest zone that is still in any of
+	// the buffers.
+	std::uint64_t origin = ~std::uint64_t(0);
+	for( auto const& thread : registry.threads )
+	{
+		auto const count = thread->count.load( std::memory_order_acquire );
+		auto const first = count > detail::ProfileThread::kCapacity ? count - detail::ProfileThread::kCapacity : 0;
+		for( auto i = first; i < count; ++i )
+			origin = std::min( origin, thread->events[i % detail::ProfileThread::kCapacity].begin );
+	}
+
+	std::FILE* fout = std::fopen( aPath, "wb" );
+	if( !fout )
+		throw Error( "Unable to open '%s' for writing", aPath );
+
+	std::fprintf( fout, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n" );
+
+	std::size_t written = 0;
+	char const* separator = "";
+	for( auto const& thread : registry.threads )
+	{
+		// Thread names (metadata events)
+		std::fprintf( fout, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%" PRIu32 ",\"args\":{\"name\":", separator, thread->index );
+		if( !thread->name.empty() )
+			write_string_( fout, thread->name.c_str() );
+		else
+			std::fprintf( fout, "\"thread %" PRIu32 "\"", thread->index );
+		std::fprintf( fout, "}}" );
+		separator = ",\n";
+
+		// Zones ("complete" events), in microseconds
+		auto const count = thread->count.load( std::memory_order_acquire );
+		auto const first = count > detail::ProfileThread::kCapacity ? count - detail::ProfileThread::kCapacity : 0;
+		for( auto i = first; i < count; ++i )
+		{
+			auto const& event = thread->events[i % detail::ProfileThread::kCapacity];
+
+			std::fprintf( fout, "%s{\"name\":", separator );
+			write_string_( fout, event.name );
+			std::fprintf( fout, ",\"ph\":\"X\",\"pid\":1,\"tid\":%" PRIu32 ",\"ts\":%.3f,\"dur\":%.3f}",
+				thread->index,
+				double(event.begin - origin) / ticksPerUs,
+				double(event.end - event.begin) / ticksPerUs
+			);
+			++written;
+		}
+	}
+
+	std::fprintf( fout, "\n]}\n" );
+
+	bool const ok = !std::ferror( fout );
+	if( 0 != std::fclose( fout ) || !ok )
+		throw Error( "Error while writing '%s'", aPath );
+
+	return written;
+}
+
+
+namespace
+{
+	void write_string_( std::FILE* aOut, char const* aString )
+	{
+		std::fputc( '"', aOut );
+		for( char const* ch = aString; *ch; ++ch )
+		{
+			if( '"' == *ch || '\\' == *ch )
+				std::fprintf( aOut, "\\%c", *ch );
+			else if( static_cast<unsigned char>(*ch) < 0x20 )
+				std::fprintf( aOut, "\\u%04x", unsigned(static_cast<unsigned char>(*ch)) );
+			else
+				std::fputc( *ch, aOut );
+		}
+		std::fputc( '"', aOut );
+	}
+}
@@ -0,0 +1,220 @@
+#ifndef PROFILER_HPP_4FB2732A_5338_408C_AA69_1A29580DF2BD
+#define PROFILER_HPP_4FB2732A_5338_408C_AA69_1A29580DF2BD
+
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <cstdint>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#	include <intrin.h>
+#	define SUPPORT_PROFILER_RDTSC_ 1
+#elif defined(__x86_64__) || defined(__i386__)
+#	include <x86intrin.h>
+#	define SUPPORT_PROFILER_RDTSC_ 1
+#else
+#	define SUPPORT_PROFILER_RDTSC_ 0
+#endif
+
+/* Compile-time configuration:
+ * The zone profiler is compiled in only if SUPPORT_CFG_PROFILER is non-zero.
+ * Otherwise, the PROFILE_*() macros expand to nothing and cost nothing. Enable
+ * it with
+ *
+ *   premake5 gmake2 --profiler
+ *
+ * (or define SUPPORT_CFG_PROFILER=1 for all projects by other means).
+ */
+#if !defined(SUPPORT_CFG_PROFILER)
+#	define SUPPORT_CFG_PROFILER 0
+#endif
+
+/* Zones:
+ * PROFILE_ZONE( "name" ) records the time from the macro to the end of the
+ * enclosing scope as a zone of the calling thread. Zones nest. The name must
+ * be a string literal (or otherwise outlive the program).
+ *
+ *   void draw_things( Surface& aSurface )
+ *   {
+ *     PROFILE_ZONE( "draw_things" );
+ *     ...
+ *   }
+ *
+ * PROFILE_THREAD_NAME( name ) names the calling thread in the trace. The name
+ * is copied; without a name, threads are numbered in the order in which they
+ * first record a zone.
+ *
+ * Each thread records into its own ring buffer, which holds the most recent
+ * ProfileThread::kCapacity zones. Recording a zone takes two timestamps and
+ * one store to the buffer; no locks are taken except when a thread's buffer
+ * is created. That happens in PROFILE_THREAD_NAME(), or else when the thread
+ * enters its first zone, before the zone's start time is taken (so the
+ * allocation is not part of the zone, and a failure to allocate throws from
+ * PROFILE_ZONE() rather than from a destructor). Timestamps are read with RDTSC on x86 (about half
+ * the cost of std::chrono::steady_clock) and converted to nanoseconds on
+ * export; this assumes an invariant TSC, which all recent x86 CPUs have.
+ * Elsewhere, steady_clock is used directly.
+ *
+ * write_chrome_trace() exports all buffers in the Chrome trace event format
+ * (JSON), which chrome://tracing and https://ui.perfetto.dev display as one
+ * timeline per thread.
+ *
+ * The recording part is header-only, so that draw2d can contain zones without
+ * linking against the support library.
+ */
+#if SUPPORT_CFG_PROFILER
+#	define PROFILE_ZONE( name ) \
+		::ProfileZone const PROFILE_CONCAT_( profileZone_, __LINE__ ){ name } \
+		/*ENDM*/
+#	define PROFILE_THREAD_NAME( name ) \
+		::profile_set_thread_name( name ) \
+		/*ENDM*/
+#else
+#	define PROFILE_ZONE( name )        do {} while(0)
+#	define PROFILE_THREAD_NAME( name ) do {} while(0)
+#endif
+
+#define PROFILE_CONCAT_( a, b ) PROFILE_CONCAT_IMPL_( a, b )
+#define PROFILE_CONCAT_IMPL_( a, b ) a##b
+
+constexpr bool kProfilerEnabled = (0 != SUPPORT_CFG_PROFILER);
+
+
+namespace detail
+{
+	struct ProfileThread;
+}
+
+/** ProfileZone - records one zone; use PROFILE_ZONE()
+ */
+class ProfileZone final
+{
+	public:
+		explicit ProfileZone( char const* aName );
+		~ProfileZone();
+
+		ProfileZone( ProfileZone const& ) = delete;
+		ProfileZone& operator= (ProfileZone const&) = delete;
+
+	private:
+		detail::ProfileThread* mThread;
+		char const* mName;
+		std::uint64_t mBegin;
+};
+
+void profile_set_thread_name( char const* aName );
+
+/* Writes the zones of all threads to aPath as Chrome trace JSON. Throws Error
+ * if the file cannot be written. Call this only while no zones are being
+ * recorded (e.g., after all other threads have stopped); a buffer that is
+ * written to during the export may show torn zones.
+ *
+ * Returns the number of zones written. (Zero if the profiler is not compiled
+ * in; no file is written in that case.)
+ */
+std::size_t write_chrome_trace( char const* aPath );
+
+
+namespace detail
+{
+	struct ProfileEvent
+	{
+		char const* name;
+		std::uint64_t begin; // profile_now() ticks
+		std::uint64_t end;
+	};
+
+	struct ProfileThread
+	{
+		static constexpr std::size_t kCapacity = std::size_t(1) << 18;
+
+		std::uint32_t index;
+		std::string name;
+
+		// Total number of zones recorded; zone i is in events[i % kCapacity].
+		std::atomic<std::uint64_t> count{ 0 };
+		ProfileEvent events[kCapacity];
+	};
+
+	inline
+	std::uint64_t profile_now() noexcept
+	{
+#		if SUPPORT_PROFILER_RDTSC_
+		return __rdtsc();
+#		else
+		using Ns_ = std::chrono::nanoseconds;
+		return std::uint64_t(std::chrono::duration_cast<Ns_>( std::chrono::steady_clock::now().time_since_epoch() ).count());
+#		endif
+	}
+
+	struct ProfileRegistry
+	{
+		std::mutex mutex;
+		std::vector<std::unique_ptr<ProfileThread>> threads;
+
+		// Reference point for converting profile_now() ticks to time
+		std::uint64_t startTicks = profile_now();
+		std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+	};
+
+	inline
+	ProfileRegistry& profile_registry()
+	{
+		static ProfileRegistry registry;
+		return registry;
+	}
+
+	// The buffer of the calling thread. Buffers belong to the registry and
+	// outlive their threads, so that the zones of threads that have already
+	// exited are still exported.
+	inline
+	ProfileThread& profile_thread()
+	{
+		thread_local ProfileThread* thread = nullptr;
+		if( !thread )
+		{
+			auto& registry = profile_registry();
+			std::lock_guard<std::mutex> lock( registry.mutex );
+
+			auto& added = registry.threads.emplace_back( std::make_unique<ProfileThread>() );
+			added->index = std::uint32_t(registry.threads.size() - 1);
+			thread = added.get();
+		}
+
+		return *thread;
+	}
+}
+
+
+inline
+ProfileZone::ProfileZone( char const* aName )
+	: mThread( &detail::profile_thread() )
+	, mName( aName )
+	, mBegin( detail::profile_now() )
+{}
+
+inline
+ProfileZone::~ProfileZone()
+{
+	auto const end = detail::profile_now();
+
+	auto& thread = *mThread;
+	auto const index = thread.count.load( std::memory_order_relaxed );
+	thread.events[index % detail::ProfileThread::kCapacity] = { mName, mBegin, end };
+	thread.count.store( index + 1, std::memory_order_release );
+}
+
+inline
+void profile_set_thread_name( char const* aName )
+{
+	auto& thread = detail::profile_thread();
+
+	std::lock_guard<std::mutex> lock( detail::profile_registry().mutex );
+	thread.name = aName;
+}
+
+#endif // PROFILER_HPP_4FB2732A_5338_408C_AA69_1A29580DF2BD
@@ -0,0 +1,91 @@
+#ifndef RANDOM_HPP_DC3894EE_3BD5_453A_8C86_B3FBD0A1B0C4
+#define RANDOM_HPP_DC3894EE_3BD5_453A_8C86_B3FBD0A1B0C4
+
+#include <limits>
+
+#include <cstdint>
+#include <cstdlib>
+
+/** Xoshiro128 - small and fast pseudo-random number generator
+ *
+ * Implements xoshiro128+ (Blackman & Vigna). The generator has 128 bits of
+ * state and produces 32 bits per call using only a handful of shifts, xors
+ * and one addition. The lowest bits of xoshiro128+ are weaker than the rest;
+ * the floating point helpers below only use the upper 24 bits.
+ *
+ * The class is a UniformRandomBitGenerator, so it works with the standard
+ * library distributions. However, those are comparatively slow, and their
+ * output differs between standard library implementations. The uniform() and
+ * normal() methods are faster and are implemented here in terms of basic
+ * floating point operations, so they produce the same sequence everywhere
+ * (for the same seed and the same floating point settings).
+ *
+ * The fill_uniform() method generates a block of numbers from a counter-based
+ * stream (see counter_random_u32()), where each output depends only on its
+ * index. The loop has no dependencies between iterations and vectorizes.
+ */
+class Xoshiro128 final
+{
+	public:
+		using result_type = std::uint32_t;
+
+	public:
+		explicit Xoshiro128( std::uint64_t aSeed = 0 ) noexcept;
+
+		void seed( std::uint64_t ) noexcept;
+
+	public:
+		result_type operator() () noexcept;
+
+		static constexpr result_type min() noexcept;
+		static constexpr result_type max() noexcept;
+
+	public:
+		// Uniform in [0, 1)
+		float uniform() noexcept;
+		// Uniform in [aMin, aMax)
+		float uniform( float aMin, float aMax ) noexcept;
+
+		// Normal with mean 0 and standard deviation 1
+		float normal() noexcept;
+		float normal( float aMean, float aStddev ) noexcept;
+
+		/* Fill aOut[0 ... aCount) with uniform numbers in [aMin, aMax). This
+		 * advances the generator by one step (regardless of aCount), which is
+		 * used as the key of the counter-based stream.
+		 */
+		void fill_uniform( std::size_t aCount, float* aOut, float aMin = 0.f, float aMax = 1.f ) noexcept;
+
+		/* Fill aOut[0 ... aCount) with normally distributed numbers. Equivalent
+		 * to calling normal() aCount times.
+		 */
+		void fill_normal( std::size_t aCount, float* aOut, float aMean = 0.f, float aStddev = 1.f ) noexcept;
+
+	private:
+		std::uint32_t mState[4];
+
+		// The polar method generates normal numbers in pairs; the second one
+		// is kept for the next call.
+		float mSpareNormal;
+		bool mHasSpareNormal;
+};
+
+/* Counter-based random numbers
+ *
+ * Returns 32 random bits for a given key and counter. Consecutive counters
+ * are spread with a Weyl sequence and then mixed with a 32-bit integer hash
+ * ("lowbias32", by Chris Wellons); this is the 32-bit analogue of SplitMix.
+ *
+ * There is no sequential state, so any element of the stream can be computed
+ * independently. This is useful when many items are processed in parallel
+ * (by SIMD lanes or by different threads).
+ */
+constexpr std::uint32_t counter_random_u32( std::uint32_t aKey, std::uint32_t aCounter ) noexcept;
+
+/* Convert 32 random bits to a float uniformly distributed in [0, 1). Uses the
+ * upper 24 bits, which is the full precision of a float in [0.5, 1).
+ */
+constexpr float unit_float_from_u32( std::uint32_t ) noexcept;
+
+#include "random.inl"
+#endif // RANDOM_HPP_DC3894EE_3BD5_453A_8C86_B3FBD0A1B0C4
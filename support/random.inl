@@ -0,0 +1,201 @@
+#include <bit>
+
+#include <cmath>
+
+namespace detail
+{
+	constexpr
+	std::uint64_t splitmix64( std::uint64_t& aState ) noexcept
+	{
+		std::uint64_t z = (aState += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+
+	/* Natural logarithm for normal, positive floats. std::log() is not
+	 * guaranteed to be correctly rounded, and different C libraries return
+	 * different results in the last bit. This version only uses basic
+	 * arithmetic, so its results are the same everywhere. The polynomial is
+	 * the one from the Cephes logf(); the error is a few ulp, which is more
+	 * than enough for generating normal numbers.
+	 */
+	inline
+	float log_positive( float aX ) noexcept
+	{
+		// aX = m * 2^e with m in [sqrt(1/2), sqrt(2))
+		std::uint32_t const bits = std::bit_cast<std::uint32_t>( aX );
+		// The mantissa is compared as an integer: the outcome is essentially
+		// random here, so this should not become a branch.
+		std::uint32_t const high = (bits & 0x7fffffu) > 0x3504f3u ? 1u : 0u;
+		int const e = int((bits >> 23) & 0xffu) - 127 + int(high);
+		float const m = std::bit_cast<float>( (bits & 0x7fffffu) | ((0x7fu - high) << 23) );
+
+		float const x = m - 1.f;
+		float const z = x*x;
+
+		float y = 7.0376836292e-2f;
+		y = y*x - 1.1514610310e-1f;
+		y = y*x + 1.1676998740e-1f;
+		y = y*x - 1.2420140846e-1f;
+		y = y*x + 1.4249322787e-1f;
+		y = y*x - 1.6668057665e-1f;
+		y = y*x + 2.0000714765e-1f;
+		y = y*x - 2.4999993993e-1f;
+		y = y*x + 3.3333331174e-1f;
+		y = y*x*z;
+
+		// ln(2) is split in two parts to keep float(e)*ln(2) accurate
+		float const fe = float(e);
+		y += -2.12194440e-4f * fe;
+		y -= 0.5f * z;
+		return x + y + 0.693359375f * fe;
+	}
+}
+
+inline
+Xoshiro128::Xoshiro128( std::uint64_t aSeed ) noexcept
+{
+	seed( aSeed );
+}
+
+inline
+void Xoshiro128::seed( std::uint64_t aSeed ) noexcept
+{
+	// Expand the seed with SplitMix64, as recommended by the xoshiro authors.
+	// The resulting state is never all zero in practice.
+	std::uint64_t sm = aSeed;
+	std::uint64_t const a = detail::splitmix64( sm );
+	std::uint64_t const b = detail::splitmix64( sm );
+
+	mState[0] = std::uint32_t(a);
+	mState[1] = std::uint32_t(a >> 32);
+	mState[2] = std::uint32_t(b);
+	mState[3] = std::uint32_t(b >> 32);
+
+	mSpareNormal = 0.f;
+	mHasSpareNormal = false;
+}
+
+inline
+Xoshiro128::result_type Xoshiro128::operator() () noexcept
+{
+	std::uint32_t const result = mState[0] + mState[3];
+	std::uint32_t const t = mState[1] << 9;
+
+	mState[2] ^= mState[0];
+	mState[3] ^= mState[1];
+	mState[1] ^= mState[2];
+	mState[0] ^= mState[3];
+
+	mState[2] ^= t;
+	mState[3] = std::rotl( mState[3], 11 );
+
+	return result;
+}
+
+constexpr
+Xoshiro128::result_type Xoshiro128::min() noexcept
+{
+	return std::numeric_limits<result_type>::min();
+}
+constexpr
+Xoshiro128::result_type Xoshiro128::max() noexcept
+{
+	return std::numeric_limits<result_type>::max();
+}
+
+inline
+float Xoshiro128::uniform() noexcept
+{
+	return unit_float_from_u32( (*this)() );
+}
+inline
+float Xoshiro128::uniform( float aMin, float aMax ) noexcept
+{
+	return aMin + (aMax-aMin) * uniform();
+}
+
+inline
+float Xoshiro128::normal() noexcept
+{
+	if( mHasSpareNormal )
+	{
+		mHasSpareNormal = false;
+		return mSpareNormal;
+	}
+
+	// Marsaglia's polar method. Compared to Box-Muller, it avoids sin() and
+	// cos() at the cost of rejecting about 21% of the candidate points.
+	float u, v, s;
+	do
+	{
+		u = 2.f * uniform() - 1.f;
+		v = 2.f * uniform() - 1.f;
+		s = u*u + v*v;
+	} while( s >= 1.f || s == 0.f );
+
+	float const factor = std::sqrt( -2.f * detail::log_positive( s ) / s );
+
+	mSpareNormal = v * factor;
+	mHasSpareNormal = true;
+	return u * factor;
+}
+inline
+float Xoshiro128::normal( float aMean, float aStddev ) noexcept
+{
+	return aMean + aStddev * normal();
+}
+
+inline
+void Xoshiro128::fill_uniform( std::size_t aCount, float* aOut, float aMin, float aMax ) noexcept
+{
+	std::uint32_t const key = (*this)();
+	float const range = aMax - aMin;
+
+	// Blocks of fixed size map directly to vector instructions. (Compilers
+	// are more reluctant to vectorize a loop with an arbitrary trip count.)
+	constexpr std::size_t kLanes = 8;
+
+	std::size_t i = 0;
+	for( ; i + kLanes <= aCount; i += kLanes )
+	{
+		float block[kLanes];
+		for( std::size_t l = 0; l < kLanes; ++l )
+			block[l] = aMin + range * unit_float_from_u32( counter_random_u32( key, std::uint32_t(i+l) ) );
+
+		for( std::size_t l = 0; l < kLanes; ++l )
+			aOut[i+l] = block[l];
+	}
+
+	for( ; i < aCount; ++i )
+		aOut[i] = aMin + range * unit_float_from_u32( counter_random_u32( key, std::uint32_t(i) ) );
+}
+
+inline
+void Xoshiro128::fill_normal( std::size_t aCount, float* aOut, float aMean, float aStddev ) noexcept
+{
+	for( std::size_t i = 0; i < aCount; ++i )
+		aOut[i] = normal( aMean, aStddev );
+}
+
+
+constexpr
+std::uint32_t counter_random_u32( std::uint32_t aKey, std::uint32_t aCounter ) noexcept
+{
+	std::uint32_t x = aKey + aCounter * 0x9e3779b9u;
+	x ^= x >> 16;
+	x *= 0x7feb352du;
+	x ^= x >> 15;
+	x *= 0x846ca68bu;
+	x ^= x >> 16;
+	return x;
+}
+
+constexpr
+float unit_float_from_u32( std::uint32_t aBits ) noexcept
+{
+	// The shifted value fits in a signed integer; signed conversions are
+	// cheaper than unsigned ones on most SIMD instruction sets.
+	return float(std::int32_t(aBits >> 8)) * (1.f / 16777216.f);
+}
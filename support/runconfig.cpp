@@ -5,6 +5,7 @@
 #include <cstring>
 
 #include "error.hpp"
+#include "profiler.hpp"
 
 namespace
 {
@@ -18,7 +19,7 @@ RuntimeConfig parse_command_line( int aArgc, char const* const* aArgv )
 	for( int i = 1; i < aArgc; ++i )
 	{
 		char name[128], value[128];
-		int ret = std::sscanf( aArgv[i], "--%127[a-zA-Z0-9_]=%127s", name, value );
+		int ret = std::sscanf( aArgv[i], "--%127[a-zA-Z0-9_-]=%127s", name, value );
 
 		if( ret == 1 )
 		{
@@ -27,6 +28,10 @@ RuntimeConfig parse_command_line( int aArgc, char const* const* aArgv )
 				synopsis_( aArgv[0] );
 				std::exit( 0 );
 			}
+			else if( 0 == std::strcmp( "simthread", name ) )
+			{
+				config.simulationThread = true;
+			}
 			else
 			{
 				throw Error( "Error while parsing command line\n" 
@@ -63,6 +68,98 @@ RuntimeConfig parse_command_line( int aArgc, char const* const* aArgv )
 				config.initialWindowWidth = width;
 				config.initialWindowHeight = height;
 			}
+			else if( 0 == std::strcmp( "threads", name ) )
+			{
+				unsigned threads = 0;
+				if( 1 != std::sscanf( value, "%u%c", &threads, &dummy ) )
+				{
+					throw Error( "Error while parsing command line\n" 
+						"Value '%s' not valid for --threads; expected unsigned integer\n"
+						"Use --help to print available command line options", value );
+				}
+
+				config.threadCount = threads;
+			}
+			else if( 0 == std::strcmp( "stardensity", name ) )
+			{
+				float scale = 0.f;
+				if( 1 != std::sscanf( value, "%f%c", &scale, &dummy ) || !(scale >= 0.f) )
+				{
+					throw Error( "Error while parsing command line\n" 
+						"Value '%s' not valid for --stardensity; expected non-negative number\n"
+						"Use --help to print available command line options", value );
+				}
+
+				config.starDensityScale = scale;
+			}
+			else if( 0 == std::strcmp( "seed", name ) )
+			{
+				unsigned seed = 0;
+				if( 1 != std::sscanf( value, "%u%c", &seed, &dummy ) )
+				{
+					throw Error( "Error while parsing command line\n" 
+						"Value '%s' not valid for --seed; expected unsigned integer\n"
+						"Use --help to print available command line options", value );
+				}
+
+				config.fixedSeed = true;
+				config.randomSeed = seed;
+			}
+			else if( 0 == std::strcmp( "simrate", name ) )
+			{
+				float rate = 0.f;
+				if( 1 != std::sscanf( value, "%f%c", &rate, &dummy ) || !(rate > 0.f) )
+				{
+					throw Error( "Error while parsing command line\n" 
+						"Value '%s' not valid for --simrate; expected positive number\n"
+						"Use --help to print available command line options", value );
+				}
+
+				config.simulationRate = rate;
+			}
+			else if( 0 == std::strcmp( "pipeline", name ) )
+			{
+				unsigned depth = 0;
+				if( 1 != std::sscanf( value, "%u%c", &depth, &dummy ) || (0 != depth && 2 != depth && 3 != depth) )
+				{
+					throw Error( "Error while parsing command line\n" 
+						"Value '%s' not valid for --pipeline; expected 0, 2 or 3\n"
+						"Use --help to print available command line options", value );
+				}
+
+				config.pipelineDepth = depth;
+			}
+			else if( 0 == std::strcmp( "asteroidsprites", name ) )
+			{
+				unsigned rotations = 0;
+				if( 1 != std::sscanf( value, "%u%c", &rotations, &dummy ) )
+				{
+					throw Error( "Error while parsing command line\n" 
+						"Value '%s' not valid for --asteroidsprites; expected unsigned integer\n"
+						"Use --help to print available command line options", value );
+				}
+
+				config.asteroidSpriteRotations = rotations;
+			}
+			else if( 0 == std::strcmp( "kernel-isa", name ) )
+			{
+				config.kernelIsa = value;
+			}
+			else if( 0 == std::strcmp( "trace", name ) )
+			{
+				if( !kProfilerEnabled )
+				{
+					throw Error( "Error while parsing command line\n" 
+						"--trace requires a build with the profiler (premake5 --profiler)\n"
+						"Use --help to print available command line options" );
+				}
+
+				config.traceFile = value;
+			}
+			else if( 0 == std::strcmp( "overdraw", name ) )
+			{
+				config.overdrawHeatmap = value;
+			}
 			else
 			{
 				throw Error( "Error while parsing command line\n" 
@@ -88,10 +185,20 @@ namespace
 
 Where <flag> may be one off the following
   help         : print this help and exit successfully
+  simthread    : run the simulation on a separate thread
 
 and where <option> and <value> may be the following
   geometry    <width>x<height>    set initial window size to (width, height)
   fbshift     <shift>             scale framebuffer by 2^-<shift> (unsigned int)
+  threads     <count>             use <count> threads for updates (0 = auto, 1 = single threaded)
+  stardensity <scale>             scale density of background stars by <scale> (float)
+  seed        <seed>              seed random number generator with <seed> (unsigned int)
+  simrate     <rate>              run <rate> simulation steps per second (float, default 120)
+  pipeline    <surfaces>          render on a separate thread with 2 or 3 surfaces (0 = off)
+  asteroidsprites <rotations>     draw asteroids from sprites pre-rendered at <rotations> angles (0 = off)
+  kernel-isa  <isa>               draw with the kernels for <isa>: auto (default), generic, sse2, avx2, avx512, neon
+  trace       <file>              write profiler zones to <file> on exit (default trace.json; profiler builds only)
+  overdraw    <file>              count pixel writes, print them and write a heatmap to <file> (PNG) on exit (overdraw builds only)
 
 Example:
   %s --geometry=1920x1080 --fbshift=1
@@ -1,6 +1,8 @@
 #ifndef RUNCONFIG_HPP_6700ED29_C137_4C7A_8BE7_00D6C7CDD0D1
 #define RUNCONFIG_HPP_6700ED29_C137_4C7A_8BE7_00D6C7CDD0D1
 
+#include <string>
+
 namespace cfg
 {
 	constexpr unsigned kInitialWindowWidth = 1280;
@@ -13,6 +15,49 @@ struct RuntimeConfig
 	unsigned initialWindowHeight = cfg::kInitialWindowHeight;
 
 	unsigned framebufferScaleShift = 0;
+
+	// Number of threads used for updates. Zero picks the number of hardware
+	// threads, one runs everything on the main thread.
+	unsigned threadCount = 0;
+
+	// Scale factor for the density of the background's particle fields.
+	float starDensityScale = 1.f;
+
+	// Seed for the random number generator. Without a fixed seed, a random
+	// seed is picked at startup.
+	bool fixedSeed = false;
+	unsigned randomSeed = 0;
+
+	// The simulation advances in fixed steps of 1/simulationRate seconds,
+	// independently of the frame rate. With simulationThread, the steps run
+	// on a separate thread.
+	float simulationRate = 120.f;
+	bool simulationThread = false;
+
+	// Number of Surfaces rotated between the render thread and the main
+	// (OpenGL) thread. Zero disables the pipeline: frames are rendered and
+	// presented on the main thread.
+	unsigned pipelineDepth = 0;
+
+	// Asteroids are drawn from sprites that are pre-rendered at this many
+	// rotation angles. Zero draws the exact shapes each frame.
+	unsigned asteroidSpriteRotations = 0;
+
+	// Instruction set of the draw2d kernels, by name (see parse_kernel_isa()
+	// in draw2d/kernels.hpp). The value is not checked here; the programs
+	// that draw do so when selecting the kernels. The default picks the best
+	// one that the CPU supports; others are mainly useful to compare the
+	// kernel versions.
+	std::string kernelIsa = "auto";
+
+	// Chrome trace file that the zone profiler writes on exit. Requires a
+	// build with the profiler (see support/profiler.hpp).
+	std::string traceFile = "trace.json";
+
+	// PNG file for the overdraw heatmap; empty disables the overdraw
+	// statistics. Requires a build with DRAW2D_CFG_OVERDRAW (see
+	// draw2d/overdraw.hpp), which main checks.
+	std::string overdrawHeatmap;
 };
 
 RuntimeConfig parse_command_line( int aArgc, char const* const* aArgv );
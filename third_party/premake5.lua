@@ -19,6 +19,19 @@ filter "system:macosx"
 	};
 filter "*"
 
+-- Google Benchmark reads hardware performance counters through libpfm
+-- (--benchmark_perf_counters=CYCLES,INSTRUCTIONS,...). Enable this when
+-- building for Linux on a host that has libpfm installed (libpfm4-dev or
+-- libpfm-devel). Elsewhere, the option only prints a warning. The custom
+-- counters in support/hwcounters.hpp do not need libpfm.
+local haveLibpfm = os.istarget( "linux" )
+	and os.findheader( "perfmon/pfmlib.h" ) ~= nil
+	and os.findlib( "pfm" ) ~= nil
+
+if haveLibpfm then
+	links "pfm"
+end
+
 
 project( "x-stb" )
 	kind "StaticLib"
@@ -144,6 +157,10 @@ project( "x-benchmark" )
 
 	filter "system:linux"
 		defines { "BENCHMARK_HAS_PTHREAD_AFFINITY=1" }
+
+		if haveLibpfm then
+			defines { "HAVE_LIBPFM=1" }
+		end
 	filter "system:windows"
 		links { "shlwapi" }
 	--filter "system:macosx"
@@ -0,0 +1,180 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <numbers>
+#include <algorithm>
+
+#include <cmath>
+#include <cstdint>
+
+#include "../draw2d/draw.hpp"
+#include "../draw2d/shape.hpp"
+#include "../draw2d/surface-ex.hpp"
+
+#include "../vmlib/transform.hpp"
+
+#include "../support/random.hpp"
+
+// Asteroid-like triangle fans (18 outer vertices, radius ~30 pixels) at
+// random positions and rotations on the surface. Items are asteroids.
+namespace
+{
+	constexpr std::size_t kShapeCount = 16;
+
+	// Similar to make_asteroid() in the main program
+	TriangleFan make_rock_( Xoshiro128& aRNG, std::size_t aPoints = 18, float aRadius = 30.f )
+	{
+		float const radius = aRNG.normal( aRadius, 5.f );
+		float const squish = aRNG.normal( 1.f, 0.2f );
+		float const base = std::clamp( 0.3f + aRNG.normal( 0.f, 0.2f ), 0.1f, 1.f );
+
+		std::vector<Vec2f> verts{ Vec2f{ 0.f, 0.f } };
+		std::vector<ColorF> colors{ ColorF{ base, base, base } };
+
+		float const step = 2.f*std::numbers::pi_v<float> / aPoints;
+		for( std::size_t i = 0; i < aPoints; ++i )
+		{
+			float const r = radius + aRNG.normal( 0.f, 2.5f );
+			verts.emplace_back( Vec2f{ squish * r * std::cos( i*step ), r * std::sin( i*step ) } );
+
+			float const c = std::clamp( base + aRNG.uniform( -0.05f, 0.05f ), 0.f, 1.f );
+			colors.emplace_back( ColorF{ c, c, c } );
+		}
+
+		return TriangleFan( verts.size(), verts.data(), colors.data() );
+	}
+
+	struct Placement_
+	{
+		Vec2f pos;
+		Mat22f rot;
+	};
+
+	struct Scene_
+	{
+		std::vector<TriangleFan> shapes;
+		std::vector<Placement_> placements;
+	};
+
+	Scene_ make_scene_( std::size_t aCount, std::uint32_t aWidth, std::uint32_t aHeight )
+	{
+		Xoshiro128 rng( 1234 );
+
+		Scene_ ret;
+		for( std::size_t i = 0; i < kShapeCount; ++i )
+			ret.shapes.emplace_back( make_rock_( rng ) );
+
+		for( std::size_t i = 0; i < aCount; ++i )
+		{
+			ret.placements.emplace_back( Placement_{
+				Vec2f{ rng.uniform( 0.f, float(aWidth) ), rng.uniform( 0.f, float(aHeight) ) },
+				make_rotation_2d( rng.uniform( 0.f, 2.f*std::numbers::pi_v<float> ) )
+			} );
+		}
+
+		return ret;
+	}
+
+	template< typename tDraw >
+	void asteroids_( benchmark::State& aState, tDraw&& aDraw )
+	{
+		auto const width = std::uint32_t(aState.range(0));
+		auto const height = std::uint32_t(aState.range(1));
+		auto const count = std::size_t(aState.range(2));
+
+		SurfaceEx surface( width, height );
+		surface.clear();
+
+		auto const scene = make_scene_( count, width, height );
+
+		for( auto _ : aState )
+		{
+			for( std::size_t i = 0; i < count; ++i )
+			{
+				auto const& pl = scene.placements[i];
+				aDraw( surface, scene.shapes[i % kShapeCount], pl );
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		aState.SetItemsProcessed( count * aState.iterations() );
+		aState.counters["per_asteroid"] = benchmark::Counter( double(count), benchmark::Counter::kIsIterationInvariantRate | benchmark::Counter::kInvert );
+	}
+
+
+	// Filled asteroids: one draw_triangle_interp() per triangle, each with
+	// its own setup, against TriangleFan::draw(), which shares the setup of
+	// the spokes between the triangles (draw_triangle_fan_interp()). Both
+	// write the same spans with set_row_linear().
+	void asteroids_per_triangle_( benchmark::State& aState )
+	{
+		std::vector<Vec2f> verts;
+
+		asteroids_( aState, [&verts] ( Surface& aSurface, TriangleFan const& aFan, Placement_ const& aPl ) {
+			auto const count = aFan.vertex_count();
+			verts.resize( count );
+			transform_points( aPl.rot, aPl.pos, { aFan.vertices(), count }, verts );
+
+			// Flat colors; the shading does not change the amount of work.
+			ColorF const color{ 0.5f, 0.5f, 0.5f };
+			for( std::size_t i = 2; i < count; ++i )
+				draw_triangle_interp( aSurface, verts[0], verts[i-1], verts[i], color, color, color );
+
+			draw_triangle_interp( aSurface, verts[0], verts[count-1], verts[1], color, color, color );
+		} );
+	}
+
+	void asteroids_fan_( benchmark::State& aState )
+	{
+		asteroids_( aState, [] ( Surface& aSurface, TriangleFan const& aFan, Placement_ const& aPl ) {
+			aFan.draw( aSurface, aPl.rot, aPl.pos );
+		} );
+	}
+
+
+	// Wireframes: one draw_triangle_wireframe() per triangle of the fan,
+	// which draws every shared edge twice, against TriangleFan's wireframe
+	// mode, which draws each edge once.
+	void wireframe_per_triangle_( benchmark::State& aState )
+	{
+		std::vector<Vec2f> verts;
+
+		asteroids_( aState, [&verts] ( Surface& aSurface, TriangleFan const& aFan, Placement_ const& aPl ) {
+			auto const count = aFan.vertex_count();
+			verts.resize( count );
+			transform_points( aPl.rot, aPl.pos, { aFan.vertices(), count }, verts );
+
+			ColorU8_sRGB const color{ 255, 255, 255 };
+			for( std::size_t i = 2; i < count; ++i )
+				draw_triangle_wireframe( aSurface, verts[0], verts[i-1], verts[i], color );
+
+			draw_triangle_wireframe( aSurface, verts[0], verts[count-1], verts[1], color );
+		} );
+
+		aState.counters["lines"] = 3. * 18;
+	}
+
+	void wireframe_fan_( benchmark::State& aState )
+	{
+		asteroids_( aState, [] ( Surface& aSurface, TriangleFan const& aFan, Placement_ const& aPl ) {
+			aFan.draw_wireframe( aSurface, { 1.f, 1.f, 1.f }, aPl.rot, aPl.pos );
+		} );
+
+		aState.counters["lines"] = 2. * 18;
+	}
+}
+
+BENCHMARK( asteroids_per_triangle_ )
+	->Args( { 1920, 1080, 64 } )
+;
+BENCHMARK( asteroids_fan_ )
+	->Args( { 1920, 1080, 64 } )
+;
+
+BENCHMARK( wireframe_per_triangle_ )
+	->Args( { 1920, 1080, 64 } )
+;
+BENCHMARK( wireframe_fan_ )
+	->Args( { 1920, 1080, 64 } )
+;
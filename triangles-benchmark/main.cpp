@@ -0,0 +1,365 @@
+#include <benchmark/benchmark.h>
+
+#include <vector>
+#include <numbers>
+#include <algorithm>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "../draw2d/draw.hpp"
+#include "../draw2d/shape.hpp"
+#include "../draw2d/raster.hpp"
+#include "../draw2d/surface-ex.hpp"
+
+#include "../vmlib/mat22.hpp"
+#include "../vmlib/transform.hpp"
+
+#include "../support/random.hpp"
+#include "../support/hwcounters.hpp"
+
+// Fill rate of draw_triangle_solid(), draw_triangle_interp() and
+// TriangleFan::draw() over a matrix of cases. The arguments are
+//  - w, h:   surface resolution
+//  - size:   shape size in pixels (triangles: legs of a right triangle;
+//            fans: diameter). Zero is one triangle covering the whole surface.
+//  - aspect: ratio of the longer to the shorter leg (or axis, for fans), at
+//            the same area. Shapes are rotated randomly.
+//  - clip%:  percentage of each shape's bounding box that lies outside of the
+//            surface (100 = entirely outside, i.e., culled)
+//  - cover%: screen coverage. Each iteration draws as many shapes as needed
+//            to cover this percentage of the surface (with overdraw beyond
+//            100). Zero draws a fixed batch of 64 shapes.
+//
+// Items are covered pixels (counted exactly, including overdraw), so
+// items_per_second is the fill rate in pixels/s. Where hardware counters are
+// available, instructions and cache misses per pixel and the IPC are reported
+// as well.
+namespace
+{
+	enum class Kind_
+	{
+		solid,
+		interp,
+		fan
+	};
+
+	constexpr std::size_t kBatch = 64;
+
+	struct Placement_
+	{
+		Mat22f xform;
+		Vec2f pos;
+	};
+
+	struct Case_
+	{
+		std::uint32_t width, height;
+		float size, aspect;
+		float clip, cover;
+	};
+
+	Case_ get_case_( benchmark::State const& aState )
+	{
+		return Case_{
+			std::uint32_t(aState.range(0)), std::uint32_t(aState.range(1)),
+			float(aState.range(2)), float(aState.range(3)),
+			float(aState.range(4)) / 100.f, float(aState.range(5)) / 100.f
+		};
+	}
+
+	// Unit shapes, centered on the origin, scaled by Placement_::xform.
+	Vec2f const kUnitTriangle[3] = { { -.5f, -.5f }, { .5f, -.5f }, { -.5f, .5f } };
+	ColorF const kTriangleColors[3] = { { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f } };
+
+	TriangleFan make_unit_fan_()
+	{
+		// Asteroid-like: 18 outer vertices with a slightly bumpy outline
+		constexpr std::size_t kPoints = 18;
+
+		std::vector<Vec2f> verts{ Vec2f{ 0.f, 0.f } };
+		std::vector<ColorF> colors{ ColorF{ .5f, .5f, .5f } };
+
+		for( std::size_t i = 0; i < kPoints; ++i )
+		{
+			float const angle = 2.f*std::numbers::pi_v<float> * i / kPoints;
+			float const r = (i % 2) ? .46f : .5f;
+
+			verts.emplace_back( Vec2f{ r * std::cos( angle ), r * std::sin( angle ) } );
+			colors.emplace_back( ColorF{ .4f + .02f*(i%5), .4f, .4f + .03f*(i%3) } );
+		}
+
+		return TriangleFan( verts.size(), verts.data(), colors.data() );
+	}
+
+	std::vector<Placement_> make_placements_( Kind_ aKind, Case_ const& aCase )
+	{
+		float const w = float(aCase.width), h = float(aCase.height);
+
+		if( aCase.size <= 0.f )
+		{
+			// One triangle that contains the whole surface
+			return { Placement_{ Mat22f{ 4.f*w, 0.f, 0.f, 4.f*h }, Vec2f{ 2.f*w, 2.f*h } } };
+		}
+
+		float const sa = std::sqrt( aCase.aspect );
+		float const sx = aCase.size * sa, sy = aCase.size / sa;
+
+		// Area of one shape, used to pick the number of shapes for a given
+		// screen coverage. Only approximate for fans.
+		float const area = (Kind_::fan == aKind) ? .7f * sx * sy : .5f * sx * sy;
+
+		std::size_t count = kBatch;
+		if( aCase.cover > 0.f )
+			count = std::max( std::size_t(1), std::size_t(std::ceil( aCase.cover * w * h / area )) );
+
+		Xoshiro128 rng( 1234 );
+
+		std::vector<Placement_> ret;
+		ret.reserve( count );
+		for( std::size_t i = 0; i < count; ++i )
+		{
+			Mat22f const xform = make_rotation_2d( rng.uniform( 0.f, 2.f*std::numbers::pi_v<float> ) ) * Mat22f{ sx, 0.f, 0.f, sy };
+
+			// Half the size of the (axis-aligned) bounding box
+			float const rx = .5f * (std::abs( xform._00 ) + std::abs( xform._01 ));
+			float const ry = .5f * (std::abs( xform._10 ) + std::abs( xform._11 ));
+
+			Vec2f pos{ rng.uniform( rx, std::max( rx, w - rx ) ), rng.uniform( ry, std::max( ry, h - ry ) ) };
+
+			// Push the shape over one of the surface's edges, such that the
+			// requested fraction of its bounding box is outside.
+			if( aCase.clip > 0.f )
+			{
+				switch( i % 4 )
+				{
+					case 0: pos.x = rx - 2.f*rx*aCase.clip; break;
+					case 1: pos.x = w - rx + 2.f*rx*aCase.clip; break;
+					case 2: pos.y = ry - 2.f*ry*aCase.clip; break;
+					case 3: pos.y = h - ry + 2.f*ry*aCase.clip; break;
+				}
+			}
+
+			ret.emplace_back( Placement_{ xform, pos } );
+		}
+
+		return ret;
+	}
+
+	void draw_( Kind_ aKind, Surface& aSurface, TriangleFan const& aFan, Placement_ const& aPl )
+	{
+		if( Kind_::fan == aKind )
+		{
+			aFan.draw( aSurface, aPl.xform, aPl.pos );
+			return;
+		}
+
+		Vec2f v[3];
+		transform_points( aPl.xform, aPl.pos, kUnitTriangle, v );
+
+		if( Kind_::solid == aKind )
+			draw_triangle_solid( aSurface, v[0], v[1], v[2], { 255, 255, 255 } );
+		else
+			draw_triangle_interp( aSurface, v[0], v[1], v[2], kTriangleColors[0], kTriangleColors[1], kTriangleColors[2] );
+	}
+
+	// Pixels written when drawing all placements, including overdraw. Each
+	// shape is drawn on its own; set_pixel_srgb() and fill_row_srgb() clear
+	// the padding byte, which marks the covered pixels.
+	std::int64_t count_pixels_( Kind_ aKind, Case_ const& aCase, TriangleFan const& aFan, std::vector<Placement_> const& aPlacements )
+	{
+		SurfaceEx surface( aCase.width, aCase.height );
+		std::uint8_t* const ptr = surface.get_surface_ptr();
+		std::memset( ptr, 0xff, std::size_t(aCase.width)*aCase.height*4 );
+
+		std::int64_t ret = 0;
+		for( auto const& pl : aPlacements )
+		{
+			draw_( aKind, surface, aFan, pl );
+
+			// Scan (and reset) the bounding box of the shape
+			float const rx = .5f * (std::abs( pl.xform._00 ) + std::abs( pl.xform._01 )) + 1.f;
+			float const ry = .5f * (std::abs( pl.xform._10 ) + std::abs( pl.xform._11 )) + 1.f;
+
+			auto const x0 = std::uint32_t(std::clamp( pl.pos.x - rx, 0.f, float(aCase.width) ));
+			auto const x1 = std::uint32_t(std::clamp( pl.pos.x + rx, 0.f, float(aCase.width) ));
+			auto const y0 = std::uint32_t(std::clamp( pl.pos.y - ry, 0.f, float(aCase.height) ));
+			auto const y1 = std::uint32_t(std::clamp( pl.pos.y + ry, 0.f, float(aCase.height) ));
+
+			for( std::uint32_t y = y0; y < y1; ++y )
+			{
+				std::uint8_t* row = ptr + (std::size_t(y)*aCase.width + x0)*4;
+				for( std::uint32_t x = x0; x < x1; ++x, row += 4 )
+				{
+					ret += (0 == row[3]);
+					std::memset( row, 0xff, 4 );
+				}
+			}
+		}
+
+		return ret;
+	}
+
+	void triangles_( benchmark::State& aState, Kind_ aKind )
+	{
+		auto const cs = get_case_( aState );
+		auto const fan = make_unit_fan_();
+		auto const placements = make_placements_( aKind, cs );
+
+		SurfaceEx surface( cs.width, cs.height );
+		surface.clear();
+
+		HwCounters hw;
+		hw.start();
+
+		for( auto _ : aState )
+		{
+			for( auto const& pl : placements )
+				draw_( aKind, surface, fan, pl );
+
+			benchmark::ClobberMemory();
+		}
+
+		hw.stop();
+
+		auto const pixels = count_pixels_( aKind, cs, fan, placements );
+		aState.SetItemsProcessed( pixels * aState.iterations() );
+		add_hw_counters( aState, hw, double(pixels) * aState.iterations() );
+		aState.counters["shapes"] = double(placements.size());
+		aState.counters["px/shape"] = double(pixels) / placements.size();
+	}
+
+
+	// Reference: the same setup and coverage as draw_triangle_solid(), but
+	// with the edge functions tested at each pixel of the bounding box and
+	// one set_pixel_srgb() per covered pixel. This is what
+	// draw_triangle_solid() did before it switched to spans.
+	void draw_solid_per_pixel_( Surface& aSurface, Vec2f aP0, Vec2f aP1, Vec2f aP2 )
+	{
+		detail::TriangleSetup tri;
+		if( !detail::setup_triangle( tri, aP0, aP1, aP2, aSurface.get_width(), aSurface.get_height() ) )
+			return;
+
+		auto const& e0 = tri.edges[0];
+		auto const& e1 = tri.edges[1];
+		auto const& e2 = tri.edges[2];
+
+		std::int64_t row0 = e0.start, row1 = e1.start, row2 = e2.start;
+		for( std::int32_t y = tri.minY; y <= tri.maxY; ++y )
+		{
+			std::int64_t w0 = row0, w1 = row1, w2 = row2;
+			for( std::int32_t x = tri.minX; x <= tri.maxX; ++x )
+			{
+				if( (w0 | w1 | w2) >= 0 )
+					aSurface.set_pixel_srgb( x, y, { 255, 255, 255 } );
+
+				w0 += e0.stepX;
+				w1 += e1.stepX;
+				w2 += e2.stepX;
+			}
+
+			row0 += e0.stepY;
+			row1 += e1.stepY;
+			row2 += e2.stepY;
+		}
+	}
+
+	void triangle_solid_per_pixel_( benchmark::State& aState )
+	{
+		auto const cs = get_case_( aState );
+		auto const placements = make_placements_( Kind_::solid, cs );
+
+		SurfaceEx surface( cs.width, cs.height );
+		surface.clear();
+
+		HwCounters hw;
+		hw.start();
+
+		for( auto _ : aState )
+		{
+			for( auto const& pl : placements )
+			{
+				Vec2f v[3];
+				transform_points( pl.xform, pl.pos, kUnitTriangle, v );
+				draw_solid_per_pixel_( surface, v[0], v[1], v[2] );
+			}
+
+			benchmark::ClobberMemory();
+		}
+
+		hw.stop();
+
+		auto const pixels = count_pixels_( Kind_::solid, cs, make_unit_fan_(), placements );
+		aState.SetItemsProcessed( pixels * aState.iterations() );
+		add_hw_counters( aState, hw, double(pixels) * aState.iterations() );
+		aState.counters["shapes"] = double(placements.size());
+		aState.counters["px/shape"] = double(pixels) / placements.size();
+	}
+
+
+	// The benchmark matrix. Each dimension is varied on its own, around the
+	// base case of 64-pixel shapes on a 1920x1080 surface.
+	void sizes_( benchmark::internal::Benchmark* aBench, bool aFullScreen )
+	{
+		for( std::int64_t size : { 4, 16, 64, 256, 1024 } )
+			aBench->Args( { 1920, 1080, size, 1, 0, 0 } );
+
+		if( aFullScreen )
+			aBench->Args( { 1920, 1080, 0, 1, 0, 0 } );
+	}
+
+	void matrix_( benchmark::internal::Benchmark* aBench, bool aFullScreen )
+	{
+		aBench->ArgNames( { "w", "h", "size", "aspect", "clip%", "cover%" } );
+
+		sizes_( aBench, aFullScreen );
+
+		for( std::int64_t aspect : { 4, 16, 64 } )
+			aBench->Args( { 1920, 1080, 64, aspect, 0, 0 } );
+
+		for( std::int64_t clip : { 25, 50, 90, 100 } )
+			aBench->Args( { 1920, 1080, 64, 1, clip, 0 } );
+
+		for( std::int64_t cover : { 10, 100, 400 } )
+			aBench->Args( { 1920, 1080, 32, 1, 0, cover } );
+
+		std::int64_t const resolutions[][2] = { { 320, 240 }, { 1280, 720 }, { 3840, 2160 }, { 7680, 4320 } };
+		for( auto const& res : resolutions )
+		{
+			aBench->Args( { res[0], res[1], 64, 1, 0, 100 } );
+			if( aFullScreen )
+				aBench->Args( { res[0], res[1], 0, 1, 0, 0 } );
+		}
+	}
+
+	void triangle_matrix_( benchmark::internal::Benchmark* aBench )
+	{
+		matrix_( aBench, true );
+	}
+	void fan_matrix_( benchmark::internal::Benchmark* aBench )
+	{
+		matrix_( aBench, false );
+	}
+	void reference_sizes_( benchmark::internal::Benchmark* aBench )
+	{
+		aBench->ArgNames( { "w", "h", "size", "aspect", "clip%", "cover%" } );
+		sizes_( aBench, true );
+	}
+}
+
+BENCHMARK_CAPTURE( triangles_, solid, Kind_::solid )
+	->Apply( triangle_matrix_ )
+;
+BENCHMARK_CAPTURE( triangles_, interp, Kind_::interp )
+	->Apply( triangle_matrix_ )
+;
+BENCHMARK_CAPTURE( triangles_, fan, Kind_::fan )
+	->Apply( fan_matrix_ )
+;
+
+BENCHMARK( triangle_solid_per_pixel_ )
+	->Apply( reference_sizes_ )
+;
+
+BENCHMARK_MAIN();
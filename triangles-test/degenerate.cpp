@@ -1,5 +1,8 @@
 #include <catch2/catch_amalgamated.hpp>
 
+#include <cstdint>
+#include <cstdlib>
+
 #include "helpers.hpp"
 
 #include "../draw2d/surface.hpp"
@@ -58,3 +61,154 @@ TEST_CASE( "Degenerate", "[special][!mayfail]" )
 		REQUIRE( 0 == int(col.b) );
 	}
 }
+
+
+namespace
+{
+	// Number of pixels that are not black
+	std::size_t count_covered_( Surface const& aSurface )
+	{
+		std::size_t ret = 0;
+
+		auto const* ptr = aSurface.get_surface_ptr();
+		auto const count = std::size_t(aSurface.get_width()) * aSurface.get_height();
+		for( std::size_t i = 0; i < count; ++i )
+		{
+			if( ptr[i*4+0] || ptr[i*4+1] || ptr[i*4+2] )
+				++ret;
+		}
+
+		return ret;
+	}
+
+	bool is_covered_( Surface const& aSurface, std::uint32_t aX, std::uint32_t aY )
+	{
+		auto const* ptr = aSurface.get_surface_ptr() + aSurface.get_linear_index( aX, aY )*4;
+		return ptr[0] || ptr[1] || ptr[2];
+	}
+
+	// True if the two surfaces have the same pixels covered (non-black)
+	bool same_coverage_( Surface const& aA, Surface const& aB )
+	{
+		for( std::uint32_t y = 0; y < aA.get_height(); ++y )
+		{
+			for( std::uint32_t x = 0; x < aA.get_width(); ++x )
+			{
+				if( is_covered_( aA, x, y ) != is_covered_( aB, x, y ) )
+					return false;
+			}
+		}
+
+		return true;
+	}
+}
+
+TEST_CASE( "Thin triangles", "[special][fixedpoint]" )
+{
+	// A sliver with an area of only 19 pixels. Its long edges run on either
+	// side of the centers of the pixels in row 10. Even though it is thin,
+	// it covers about 95 pixel centers, and they must be drawn.
+	Surface surface( 320, 240 );
+	surface.clear();
+
+	Vec2f const p0{ 10.f, 10.4f }, p1{ 200.f, 10.6f }, p2{ 10.f, 10.6f };
+
+	SECTION( "solid" )
+	{
+		draw_triangle_solid( surface, p0, p1, p2, { 255, 255, 255 } );
+
+		REQUIRE( is_covered_( surface, 10, 10 ) );
+		REQUIRE( is_covered_( surface, 100, 10 ) );
+		REQUIRE( !is_covered_( surface, 150, 10 ) );
+		REQUIRE( !is_covered_( surface, 100, 9 ) );
+		REQUIRE( !is_covered_( surface, 100, 11 ) );
+	}
+
+	SECTION( "interpolated" )
+	{
+		draw_triangle_interp( surface, p0, p1, p2,
+			{ 1.f, 1.f, 1.f },
+			{ 1.f, 1.f, 1.f },
+			{ 1.f, 1.f, 1.f }
+		);
+
+		REQUIRE( is_covered_( surface, 10, 10 ) );
+		REQUIRE( is_covered_( surface, 100, 10 ) );
+		REQUIRE( !is_covered_( surface, 150, 10 ) );
+	}
+}
+
+TEST_CASE( "Top-left fill rule", "[special][fixedpoint]" )
+{
+	// A 10x10 square whose edges pass exactly through pixel centers, split
+	// into two triangles. The top and left edges are included; the bottom
+	// and right edges are not. Pixels along the diagonal are covered by one
+	// of the two triangles.
+	Surface surface( 64, 64 );
+	surface.clear();
+
+	Vec2f const tl{ 10.5f, 10.5f }, tr{ 20.5f, 10.5f };
+	Vec2f const bl{ 10.5f, 20.5f }, br{ 20.5f, 20.5f };
+
+	SECTION( "solid" )
+	{
+		draw_triangle_solid( surface, tl, tr, br, { 255, 0, 0 } );
+		draw_triangle_solid( surface, tl, br, bl, { 255, 0, 0 } );
+	}
+	SECTION( "interpolated" )
+	{
+		draw_triangle_interp( surface, tl, tr, br, { 1.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, { 1.f, 0.f, 0.f } );
+		draw_triangle_interp( surface, tl, br, bl, { 1.f, 0.f, 0.f }, { 1.f, 0.f, 0.f }, { 1.f, 0.f, 0.f } );
+	}
+	SECTION( "reversed winding" )
+	{
+		draw_triangle_solid( surface, tl, br, tr, { 255, 0, 0 } );
+		draw_triangle_solid( surface, tl, bl, br, { 255, 0, 0 } );
+	}
+
+	REQUIRE( 100 == count_covered_( surface ) );
+	REQUIRE( is_covered_( surface, 10, 10 ) );
+	REQUIRE( is_covered_( surface, 19, 19 ) );
+	REQUIRE( !is_covered_( surface, 20, 10 ) );
+	REQUIRE( !is_covered_( surface, 10, 20 ) );
+}
+
+TEST_CASE( "Shared edges", "[special][fixedpoint]" )
+{
+	// A convex quad with vertices off the pixel grid. Splitting it along
+	// either diagonal must cover exactly the same pixels, and the two halves
+	// must never overlap (no gaps and no double coverage along the shared
+	// edge).
+	Vec2f const a{ 10.3f, 7.7f }, b{ 90.1f, 12.2f }, c{ 100.2f, 80.3f }, d{ 40.6f, 70.9f };
+
+	Surface first( 128, 96 ), second( 128, 96 );
+	Surface abc( 128, 96 ), acd( 128, 96 );
+
+	first.clear();
+	second.clear();
+	abc.clear();
+	acd.clear();
+
+	draw_triangle_solid( first, a, b, c, { 255, 0, 0 } );
+	draw_triangle_solid( first, a, c, d, { 255, 0, 0 } );
+
+	draw_triangle_solid( second, a, b, d, { 255, 0, 0 } );
+	draw_triangle_solid( second, b, c, d, { 255, 0, 0 } );
+
+	draw_triangle_solid( abc, a, b, c, { 255, 0, 0 } );
+	draw_triangle_solid( acd, a, c, d, { 255, 0, 0 } );
+
+	REQUIRE( same_coverage_( first, second ) );
+	REQUIRE( count_covered_( abc ) + count_covered_( acd ) == count_covered_( first ) );
+
+	SECTION( "interpolated matches solid" )
+	{
+		Surface interp( 128, 96 );
+		interp.clear();
+
+		draw_triangle_interp( interp, a, b, c, { 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f } );
+		draw_triangle_interp( interp, a, c, d, { 1.f, 0.f, 0.f }, { 0.f, 0.f, 1.f }, { 1.f, 1.f, 1.f } );
+
+		REQUIRE( same_coverage_( first, interp ) );
+	}
+}
@@ -0,0 +1,128 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <vector>
+#include <numbers>
+#include <algorithm>
+
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+#include "../draw2d/fan.hpp"
+
+// draw_triangle_fan_interp() must cover exactly the pixels that drawing each
+// triangle of the fan with draw_triangle_interp() covers. Colors are computed
+// differently (per fan instead of per triangle), so they may differ by one
+// step due to rounding.
+
+namespace
+{
+	struct Fan_
+	{
+		std::vector<Vec2f> verts;
+		std::vector<ColorF> colors;
+	};
+
+	Fan_ make_fan_( Vec2f aCenter, std::size_t aPoints, float aRadius, bool aReverse )
+	{
+		Fan_ ret;
+		ret.verts.emplace_back( aCenter );
+		ret.colors.emplace_back( ColorF{ 1.f, 1.f, 1.f } );
+
+		for( std::size_t i = 0; i < aPoints; ++i )
+		{
+			float const angle = (aReverse ? -1.f : 1.f) * 2.f*std::numbers::pi_v<float> * i / aPoints;
+			float const radius = aRadius * (i % 2 ? 0.8f : 1.f); // star-shaped, not convex
+
+			ret.verts.emplace_back( aCenter + radius * Vec2f{ std::cos( angle ), std::sin( angle ) } );
+			ret.colors.emplace_back( ColorF{ 0.2f + 0.6f*(i % 3)/2.f, 0.5f, 0.2f + 0.6f*(i % 5)/4.f } );
+		}
+
+		return ret;
+	}
+
+	void draw_per_triangle_( Surface& aSurface, Fan_ const& aFan )
+	{
+		auto const& v = aFan.verts;
+		auto const& c = aFan.colors;
+		for( std::size_t i = 2; i < v.size(); ++i )
+			draw_triangle_interp( aSurface, v[0], v[i-1], v[i], c[0], c[i-1], c[i] );
+
+		auto const last = v.size()-1;
+		draw_triangle_interp( aSurface, v[0], v[last], v[1], c[0], c[last], c[1] );
+	}
+
+	// Returns the number of pixels covered in aA and not in aB or vice versa;
+	// aMaxColorDiff receives the largest color difference of pixels covered
+	// in both.
+	std::size_t compare_( Surface const& aA, Surface const& aB, int& aMaxColorDiff )
+	{
+		auto const* pa = aA.get_surface_ptr();
+		auto const* pb = aB.get_surface_ptr();
+
+		std::size_t mismatches = 0;
+		aMaxColorDiff = 0;
+
+		for( std::size_t i = 0; i < std::size_t(aA.get_width())*aA.get_height(); ++i )
+		{
+			bool const ca = pa[i*4+0] || pa[i*4+1] || pa[i*4+2];
+			bool const cb = pb[i*4+0] || pb[i*4+1] || pb[i*4+2];
+
+			if( ca != cb )
+				++mismatches;
+			else if( ca )
+			{
+				for( int ch = 0; ch < 3; ++ch )
+					aMaxColorDiff = std::max( aMaxColorDiff, std::abs( int(pa[i*4+ch]) - int(pb[i*4+ch]) ) );
+			}
+		}
+
+		return mismatches;
+	}
+}
+
+TEST_CASE( "Fan matches triangles", "[fan]" )
+{
+	Surface expected( 320, 240 );
+	expected.clear();
+
+	Surface actual( 320, 240 );
+	actual.clear();
+
+	Fan_ fan;
+
+	SECTION( "clockwise" )
+	{
+		fan = make_fan_( { 160.3f, 120.7f }, 18, 60.f, false );
+	}
+	SECTION( "counter-clockwise" )
+	{
+		fan = make_fan_( { 160.3f, 120.7f }, 18, 60.f, true );
+	}
+	SECTION( "on pixel centers" )
+	{
+		// Center and spokes pass exactly through pixel centers, which
+		// exercises the fill rule on the shared spokes.
+		fan.verts = { { 100.5f, 100.5f }, { 150.5f, 100.5f }, { 100.5f, 150.5f }, { 50.5f, 100.5f }, { 100.5f, 50.5f } };
+		fan.colors.assign( 5, ColorF{ 0.5f, 0.5f, 0.5f } );
+	}
+	SECTION( "partially outside" )
+	{
+		fan = make_fan_( { 10.f, 230.f }, 12, 50.f, false );
+	}
+	SECTION( "not star-shaped" )
+	{
+		// The center lies outside of the rim, so some triangles overlap.
+		fan = make_fan_( { 160.f, 120.f }, 8, 60.f, false );
+		fan.verts[0] = Vec2f{ 250.f, 120.f };
+	}
+
+	draw_per_triangle_( expected, fan );
+	draw_triangle_fan_interp( actual, fan.verts.size(), fan.verts.data(), fan.colors.data() );
+
+	int maxColorDiff = 0;
+	REQUIRE( 0 == compare_( expected, actual, maxColorDiff ) );
+	REQUIRE( maxColorDiff <= 1 );
+}
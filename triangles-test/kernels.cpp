@@ -0,0 +1,216 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <vector>
+#include <iterator>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstring>
+
+#include "../draw2d/surface.hpp"
+#include "../draw2d/kernels.hpp"
+#include "../draw2d/draw.hpp"
+#include "../draw2d/fan.hpp"
+
+// Every version of the draw2d kernels must produce exactly the same pixels as
+// the scalar definitions (linear_to_srgb() etc.). The versions that the CPU
+// does not support are skipped.
+
+namespace
+{
+	std::vector<KernelIsa> supported_isas_()
+	{
+		std::vector<KernelIsa> ret;
+		for( auto const isa : { KernelIsa::generic, KernelIsa::sse2, KernelIsa::avx2, KernelIsa::avx512, KernelIsa::neon } )
+		{
+			if( kernel_isa_supported( isa ) )
+				ret.emplace_back( isa );
+		}
+		return ret;
+	}
+
+	// Restores the kernels that were active before
+	struct KernelScope_
+	{
+		explicit KernelScope_( KernelIsa aIsa )
+			: previous( kernels().isa )
+		{
+			REQUIRE( select_kernels( aIsa ) );
+		}
+		~KernelScope_()
+		{
+			select_kernels( previous );
+		}
+
+		KernelIsa previous;
+	};
+
+	ColorU8_sRGB pixel_( Surface const& aSurface, Surface::Index aX, Surface::Index aY )
+	{
+		auto const* ptr = aSurface.get_surface_ptr() + std::size_t(aSurface.get_linear_index( aX, aY ))*4;
+		REQUIRE( 0 == int(ptr[3]) );
+		return { ptr[0], ptr[1], ptr[2] };
+	}
+}
+
+TEST_CASE( "Kernel versions", "[kernels][sRGB]" )
+{
+	auto const isas = supported_isas_();
+	REQUIRE( !isas.empty() );
+
+	SECTION( "linear rows match linear_to_srgb()" )
+	{
+		// Rows of all lengths up to 40 (vector blocks plus remainders), and
+		// colors that go below zero and above one.
+		Surface surface( 64, 1 );
+
+		for( auto const isa : isas )
+		{
+			KernelScope_ scope( isa );
+
+			for( Surface::Index count = 1; count <= 40; ++count )
+			{
+				ColorF const first{ -0.1f, 0.5f, 1.1f };
+				ColorF const step{ 0.031f, -0.0123f, -0.029f };
+
+				surface.fill( { 1, 2, 3 } );
+				surface.set_row_linear( 3, 0, count, first, step );
+
+				for( Surface::Index i = 0; i < count; ++i )
+				{
+					float const fi = float(std::int32_t(i));
+					auto const expected = linear_to_srgb( ColorF{
+						std::clamp( first.r + fi * step.r, 0.f, 1.f ),
+						std::clamp( first.g + fi * step.g, 0.f, 1.f ),
+						std::clamp( first.b + fi * step.b, 0.f, 1.f )
+					} );
+
+					auto const actual = pixel_( surface, 3 + i, 0 );
+					REQUIRE( int(expected.r) == int(actual.r) );
+					REQUIRE( int(expected.g) == int(actual.g) );
+					REQUIRE( int(expected.b) == int(actual.b) );
+				}
+
+				// Neighbours are untouched
+				REQUIRE( 1 == int(pixel_( surface, 2, 0 ).r) );
+				REQUIRE( 1 == int(pixel_( surface, 3 + count, 0 ).r) );
+			}
+		}
+	}
+
+	SECTION( "sRGB conversion over [0,1]" )
+	{
+		// The kernels convert with a table, which assumes that
+		// linear_to_srgb() is monotonic and increases slowly (see
+		// kernels.cpp). Check a dense sweep of values: every 256th float in
+		// [0,1] (about four million values).
+		float one = 1.f;
+		std::uint32_t oneBits;
+		std::memcpy( &oneBits, &one, sizeof(oneBits) );
+
+		Surface surface( 1, 1 );
+
+		auto const isa = isas.back(); // the widest version
+		KernelScope_ scope( isa );
+
+		std::size_t mismatches = 0, decreasing = 0;
+		std::uint8_t previous = 0;
+		for( std::uint32_t bits = 0; bits <= oneBits; bits += 256 )
+		{
+			float value;
+			std::memcpy( &value, &bits, sizeof(value) );
+
+			// One pixel per value; a zero step keeps the value exact.
+			surface.set_row_linear( 0, 0, 1, ColorF{ value, value, value }, ColorF{ 0.f, 0.f, 0.f } );
+
+			auto const expected = linear_to_srgb( value );
+			mismatches += (expected != surface.get_surface_ptr()[0]);
+			decreasing += (expected < previous);
+			previous = expected;
+		}
+
+		REQUIRE( 0 == mismatches );
+		REQUIRE( 0 == decreasing );
+	}
+
+	SECTION( "masked rows" )
+	{
+		constexpr Surface::Index kCount = 37;
+
+		std::vector<std::uint8_t> rgba( kCount*4 );
+		for( std::size_t i = 0; i < kCount; ++i )
+		{
+			rgba[i*4+0] = std::uint8_t(i);
+			rgba[i*4+1] = std::uint8_t(100 + i);
+			rgba[i*4+2] = std::uint8_t(200 + i);
+			rgba[i*4+3] = std::uint8_t(i * 41); // mixed, including 127 and 128
+		}
+
+		for( auto const isa : isas )
+		{
+			KernelScope_ scope( isa );
+
+			Surface surface( kCount + 2, 1 );
+			surface.fill( { 7, 8, 9 } );
+			surface.set_row_srgba_masked( 1, 0, kCount, rgba.data() );
+
+			for( Surface::Index i = 0; i < kCount; ++i )
+			{
+				auto const actual = pixel_( surface, 1 + i, 0 );
+				if( rgba[i*4+3] >= 128 )
+				{
+					REQUIRE( int(rgba[i*4+0]) == int(actual.r) );
+					REQUIRE( int(rgba[i*4+1]) == int(actual.g) );
+					REQUIRE( int(rgba[i*4+2]) == int(actual.b) );
+				}
+				else
+				{
+					REQUIRE( 7 == int(actual.r) );
+					REQUIRE( 8 == int(actual.g) );
+					REQUIRE( 9 == int(actual.b) );
+				}
+			}
+
+			REQUIRE( 7 == int(pixel_( surface, 0, 0 ).r) );
+			REQUIRE( 7 == int(pixel_( surface, kCount + 1, 0 ).r) );
+		}
+	}
+
+	SECTION( "same triangles and fans with every version" )
+	{
+		auto const draw = [] ( Surface& aSurface ) {
+			aSurface.clear();
+			draw_triangle_interp( aSurface,
+				{ -20.f, 10.f }, { 90.5f, -8.f }, { 40.f, 77.25f },
+				{ 1.f, 0.f, 0.f }, { 0.f, 1.f, 0.f }, { 0.f, 0.f, 1.f }
+			);
+			draw_triangle_interp( aSurface,
+				{ 3.3f, 60.f }, { 61.f, 12.7f }, { 70.f, 70.f },
+				{ 0.2f, 0.4f, 0.6f }, { 0.9f, 0.1f, 0.5f }, { 0.f, 1.f, 1.f }
+			);
+			draw_triangle_solid( aSurface, { 5.f, 5.f }, { 30.f, 8.f }, { 12.f, 40.f }, { 255, 128, 0 } );
+
+			// Fans (asteroids) are shaded by the same kernels
+			Vec2f const fanVerts[] = { { 40.3f, 30.7f }, { 60.f, 31.f }, { 52.f, 50.5f }, { 30.f, 55.f }, { 22.f, 28.f }, { 41.f, 10.f } };
+			ColorF const fanColors[] = { { 1.f, 1.f, 1.f }, { 0.9f, 0.1f, 0.2f }, { 0.1f, 0.8f, 0.3f }, { 0.2f, 0.3f, 0.9f }, { 0.6f, 0.6f, 0.f }, { 0.f, 0.5f, 0.5f } };
+			draw_triangle_fan_interp( aSurface, std::size(fanVerts), fanVerts, fanColors );
+		};
+
+		Surface reference( 64, 64 );
+		{
+			KernelScope_ scope( isas.front() );
+			draw( reference );
+		}
+
+		auto const bytes = std::size_t(64) * 64 * 4;
+		for( auto const isa : isas )
+		{
+			KernelScope_ scope( isa );
+
+			Surface surface( 64, 64 );
+			draw( surface );
+
+			REQUIRE( 0 == std::memcmp( reference.get_surface_ptr(), surface.get_surface_ptr(), bytes ) );
+		}
+	}
+}
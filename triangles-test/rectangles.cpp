@@ -0,0 +1,196 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <limits>
+#include <vector>
+#include <algorithm>
+
+#include <cstdint>
+#include <cstring>
+
+#include "../draw2d/surface.hpp"
+#include "../draw2d/draw.hpp"
+#include "../draw2d/draw-ex.hpp"
+#include "../draw2d/overdraw.hpp"
+
+// Rectangles cover the pixels whose centers lie inside of them, with the min
+// edges inclusive and the max edges exclusive. Outlines are the outermost
+// pixels of the same rectangle. Each case lists the (unclipped) pixels
+// [x0,x1) x [y0,y1) that the corners should map to.
+
+namespace
+{
+	constexpr Surface::Index kWidth = 64, kHeight = 48;
+
+	constexpr float kNaN = std::numeric_limits<float>::quiet_NaN();
+	constexpr float kInf = std::numeric_limits<float>::infinity();
+
+	struct Case_
+	{
+		Vec2f a, b;
+		std::int32_t x0, y0, x1, y1;
+	};
+
+	bool written_( Surface const& aSurface, std::int32_t aX, std::int32_t aY )
+	{
+		auto const* ptr = aSurface.get_surface_ptr() + std::size_t(aSurface.get_linear_index( Surface::Index(aX), Surface::Index(aY) ))*4;
+		return ptr[0] || ptr[1] || ptr[2];
+	}
+
+	bool in_rect_( Case_ const& aCase, std::int32_t aX, std::int32_t aY )
+	{
+		return aX >= aCase.x0 && aX < aCase.x1 && aY >= aCase.y0 && aY < aCase.y1;
+	}
+	bool on_border_( Case_ const& aCase, std::int32_t aX, std::int32_t aY )
+	{
+		return in_rect_( aCase, aX, aY )
+			&& (aX == aCase.x0 || aX == aCase.x1-1 || aY == aCase.y0 || aY == aCase.y1-1)
+		;
+	}
+
+	// Returns the number of pixels where the surface differs from the
+	// expected coverage.
+	template< class tExpected >
+	std::size_t mismatches_( Surface const& aSurface, tExpected&& aExpected )
+	{
+		std::size_t ret = 0;
+		for( std::int32_t y = 0; y < std::int32_t(aSurface.get_height()); ++y )
+		{
+			for( std::int32_t x = 0; x < std::int32_t(aSurface.get_width()); ++x )
+				ret += (written_( aSurface, x, y ) != aExpected( x, y ));
+		}
+		return ret;
+	}
+
+	std::vector<Case_> const kCases_ = {
+		// On pixel centers: min edge inclusive, max edge exclusive
+		{ { 10.5f, 20.5f }, { 30.5f, 40.5f }, 10, 20, 30, 40 },
+		// On pixel corners
+		{ { 10.f, 20.f }, { 30.f, 40.f }, 10, 20, 30, 40 },
+		// In between
+		{ { 10.2f, 20.7f }, { 30.6f, 40.4f }, 10, 21, 31, 40 },
+		// One pixel, one row, one column
+		{ { 5.f, 6.f }, { 6.f, 7.f }, 5, 6, 6, 7 },
+		{ { 5.f, 6.f }, { 25.f, 7.f }, 5, 6, 25, 7 },
+		{ { 5.f, 6.f }, { 6.f, 26.f }, 5, 6, 6, 26 },
+		// Partially off-screen, on each side
+		{ { -10.f, -5.f }, { 20.f, 15.f }, -1, -1, 20, 15 },
+		{ { 50.f, 40.f }, { 100.f, 90.f }, 50, 40, 65, 49 },
+		{ { -1e30f, 10.f }, { 1e30f, 12.f }, -1, 10, 65, 12 },
+		{ { -kInf, -kInf }, { kInf, kInf }, -1, -1, 65, 49 },
+		// Fully off-screen
+		{ { -50.f, -50.f }, { -10.f, -10.f }, 0, 0, 0, 0 },
+		{ { 80.f, 10.f }, { 90.f, 20.f }, 0, 0, 0, 0 },
+		{ { 10.f, 60.f }, { 20.f, 70.f }, 0, 0, 0, 0 },
+		{ { 10.f, -20.f }, { 20.f, -.6f }, 0, 0, 0, 0 },
+		// Zero area, or no pixel center inside
+		{ { 10.f, 10.f }, { 10.f, 20.f }, 0, 0, 0, 0 },
+		{ { 10.6f, 10.f }, { 11.4f, 20.f }, 0, 0, 0, 0 },
+		// Inverted corners
+		{ { 30.5f, 40.5f }, { 10.5f, 20.5f }, 10, 20, 30, 40 },
+		{ { 30.f, 20.f }, { 10.f, 40.f }, 10, 20, 30, 40 },
+		// NaNs draw nothing
+		{ { kNaN, 20.f }, { 30.f, 40.f }, 0, 0, 0, 0 },
+		{ { 10.f, kNaN }, { 30.f, 40.f }, 0, 0, 0, 0 },
+		{ { 10.f, 20.f }, { kNaN, 40.f }, 0, 0, 0, 0 },
+		{ { 10.f, 20.f }, { 30.f, kNaN }, 0, 0, 0, 0 },
+	};
+}
+
+TEST_CASE( "Rectangle coverage", "[rectangle]" )
+{
+	Surface surface( kWidth, kHeight );
+
+	for( std::size_t i = 0; i < kCases_.size(); ++i )
+	{
+		auto const& c = kCases_[i];
+		CAPTURE( i, c.a.x, c.a.y, c.b.x, c.b.y );
+
+		surface.clear();
+		draw_rectangle_solid( surface, c.a, c.b, { 255, 255, 255 } );
+		REQUIRE( 0 == mismatches_( surface, [&] (std::int32_t aX, std::int32_t aY) { return in_rect_( c, aX, aY ); } ) );
+
+		// The outline is exactly the border of the solid rectangle. Border
+		// pixels that lie outside of the surface are not drawn.
+		surface.clear();
+		draw_rectangle_outline( surface, c.a, c.b, { 255, 255, 255 } );
+		REQUIRE( 0 == mismatches_( surface, [&] (std::int32_t aX, std::int32_t aY) { return on_border_( c, aX, aY ); } ) );
+	}
+}
+
+TEST_CASE( "Rectangle pixels are written once", "[rectangle][overdraw]" )
+{
+	if constexpr( !kOverdrawEnabled )
+		SKIP( "requires DRAW2D_CFG_OVERDRAW" );
+
+	Surface surface( kWidth, kHeight );
+	surface.clear();
+
+	for( std::size_t i = 0; i < kCases_.size(); ++i )
+	{
+		auto const& c = kCases_[i];
+		CAPTURE( i, c.a.x, c.a.y, c.b.x, c.b.y );
+
+		// Outline corners are shared by a row and a column, but must be
+		// written only once.
+		for( bool const outline : { false, true } )
+		{
+			OverdrawStats overdraw;
+			overdraw.begin_frame( surface );
+			if( outline )
+				draw_rectangle_outline( surface, c.a, c.b, { 255, 255, 255 } );
+			else
+				draw_rectangle_solid( surface, c.a, c.b, { 255, 255, 255 } );
+			overdraw.end_frame();
+
+			for( std::int32_t y = 0; y < std::int32_t(kHeight); ++y )
+			{
+				for( std::int32_t x = 0; x < std::int32_t(kWidth); ++x )
+				{
+					bool const expected = outline ? on_border_( c, x, y ) : in_rect_( c, x, y );
+					REQUIRE( (expected ? 1u : 0u) == overdraw.pixel_writes( std::uint32_t(x), std::uint32_t(y) ) );
+				}
+			}
+		}
+	}
+}
+
+TEST_CASE( "Rectangle batches match single rectangles", "[rectangle]" )
+{
+	// All cases at once, with overlaps, in different colors; later rectangles
+	// must be drawn over earlier ones.
+	std::vector<ColoredRectangle> rects;
+	for( std::size_t i = 0; i < kCases_.size(); ++i )
+	{
+		auto const& c = kCases_[i];
+		auto const v = std::uint8_t(40 + 9*i);
+		rects.emplace_back( ColoredRectangle{ c.a, c.b, { v, std::uint8_t(255-v), std::uint8_t(3*i) } } );
+	}
+
+	Surface expected( kWidth, kHeight );
+	expected.clear();
+
+	Surface actual( kWidth, kHeight );
+	actual.clear();
+
+	SECTION( "solid" )
+	{
+		for( auto const& r : rects )
+			draw_rectangle_solid( expected, r.minCorner, r.maxCorner, r.color );
+
+		draw_rectangles_solid( actual, rects );
+	}
+	SECTION( "outline" )
+	{
+		for( auto const& r : rects )
+			draw_rectangle_outline( expected, r.minCorner, r.maxCorner, r.color );
+
+		draw_rectangles_outline( actual, rects );
+	}
+	SECTION( "empty batch" )
+	{
+		draw_rectangles_solid( actual, {} );
+		draw_rectangles_outline( actual, {} );
+	}
+
+	REQUIRE( 0 == std::memcmp( expected.get_surface_ptr(), actual.get_surface_ptr(), std::size_t(kWidth)*kHeight*4 ) );
+}
@@ -0,0 +1,220 @@
+#include <catch2/catch_amalgamated.hpp>
+
+#include <vector>
+#include <numbers>
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+
+#include "../draw2d/surface.hpp"
+#include "../draw2d/shape.hpp"
+#include "../draw2d/color.hpp"
+#include "../draw2d/draw.hpp"
+#include "../draw2d/overdraw.hpp"
+
+// draw_triangle_wireframe() draws the three edges with draw_line_solid().
+// TriangleFan::draw_wireframe() draws each spoke and rim edge once, which
+// covers the same pixels as the wireframes of the individual triangles.
+//
+// The fan's vertices are transformed with matrices whose elements are 0, 1 or
+// -1, so that transforming the vertices here gives exactly the same results.
+
+namespace
+{
+	constexpr Surface::Index kWidth = 320, kHeight = 240;
+
+	struct Fan_
+	{
+		std::vector<Vec2f> verts;
+		std::vector<ColorF> colors;
+	};
+
+	Fan_ make_fan_( std::size_t aPoints, float aRadius )
+	{
+		Fan_ ret;
+		ret.verts.emplace_back( Vec2f{ 0.f, 0.f } );
+		ret.colors.emplace_back( ColorF{ 1.f, 1.f, 1.f } );
+
+		for( std::size_t i = 0; i < aPoints; ++i )
+		{
+			float const angle = 2.f*std::numbers::pi_v<float> * i / aPoints;
+			float const radius = aRadius * (i % 2 ? 0.6f : 1.f); // star-shaped, not convex
+
+			ret.verts.emplace_back( radius * Vec2f{ std::cos( angle ), std::sin( angle ) } );
+			ret.colors.emplace_back( ColorF{ 1.f, 1.f, 1.f } );
+		}
+
+		return ret;
+	}
+
+	std::vector<Vec2f> transform_( Fan_ const& aFan, Mat22f const& aRotation, Vec2f aTranslation )
+	{
+		std::vector<Vec2f> ret;
+		for( auto const& v : aFan.verts )
+			ret.emplace_back( aRotation * v + aTranslation );
+		return ret;
+	}
+
+	bool written_( Surface const& aSurface, std::size_t aIndex )
+	{
+		auto const* ptr = aSurface.get_surface_ptr() + aIndex*4;
+		return ptr[0] || ptr[1] || ptr[2];
+	}
+
+	// Adds the writes to each pixel that were recorded by aStats
+	void add_writes_( std::vector<std::uint64_t>& aWrites, OverdrawStats const& aStats )
+	{
+		for( std::uint32_t y = 0; y < kHeight; ++y )
+		{
+			for( std::uint32_t x = 0; x < kWidth; ++x )
+				aWrites[std::size_t(y)*kWidth + x] += aStats.pixel_writes( x, y );
+		}
+	}
+
+	struct Placement_
+	{
+		Mat22f rotation;
+		Vec2f translation;
+	};
+
+	Placement_ const kPlacements_[] = {
+		{ { 1.f, 0.f, 0.f, 1.f }, { 160.3f, 120.7f } },
+		{ { 0.f, -1.f, 1.f, 0.f }, { 100.5f, 100.5f } }, // 90 degrees
+		{ { -1.f, 0.f, 0.f, 1.f }, { 160.f, 120.f } },   // mirrored
+		{ { 1.f, 0.f, 0.f, 1.f }, { 10.f, 230.f } },     // partially outside
+	};
+}
+
+TEST_CASE( "Triangle wireframe matches three lines", "[wireframe]" )
+{
+	Surface expected( kWidth, kHeight );
+	expected.clear();
+
+	Surface actual( kWidth, kHeight );
+	actual.clear();
+
+	Vec2f p0, p1, p2;
+
+	SECTION( "clockwise" )
+	{
+		p0 = { 20.3f, 30.7f }; p1 = { 250.1f, 60.4f }; p2 = { 120.9f, 200.2f };
+	}
+	SECTION( "counter-clockwise" )
+	{
+		p0 = { 20.3f, 30.7f }; p1 = { 120.9f, 200.2f }; p2 = { 250.1f, 60.4f };
+	}
+	SECTION( "axis aligned" )
+	{
+		p0 = { 40.5f, 40.5f }; p1 = { 200.5f, 40.5f }; p2 = { 40.5f, 180.5f };
+	}
+	SECTION( "partially outside" )
+	{
+		p0 = { -50.f, 100.f }; p1 = { 160.f, -40.f }; p2 = { 400.f, 300.f };
+	}
+	SECTION( "degenerate" )
+	{
+		p0 = { 20.f, 20.f }; p1 = { 200.f, 110.f }; p2 = { 110.f, 65.f };
+	}
+
+	ColorU8_sRGB const color{ 255, 128, 64 };
+
+	draw_line_solid( expected, p0, p1, color );
+	draw_line_solid( expected, p1, p2, color );
+	draw_line_solid( expected, p2, p0, color );
+
+	draw_triangle_wireframe( actual, p0, p1, p2, color );
+
+	REQUIRE( 0 == std::memcmp( expected.get_surface_ptr(), actual.get_surface_ptr(), std::size_t(kWidth)*kHeight*4 ) );
+}
+
+TEST_CASE( "Fan wireframe matches triangle wireframes", "[wireframe][fan]" )
+{
+	auto const fan = make_fan_( 12, 80.f );
+	TriangleFan const shape( fan.verts.size(), fan.verts.data(), fan.colors.data() );
+
+	ColorF const color{ 1.f, 0.5f, 0.25f };
+
+	Surface expected( kWidth, kHeight );
+	Surface actual( kWidth, kHeight );
+
+	for( auto const& pl : kPlacements_ )
+	{
+		CAPTURE( pl.translation.x, pl.translation.y );
+
+		expected.clear();
+		actual.clear();
+
+		// Each triangle of the fan (see shape.hpp), including the closing one
+		auto const v = transform_( fan, pl.rotation, pl.translation );
+		auto const last = v.size()-1;
+		for( std::size_t i = 2; i < v.size(); ++i )
+			draw_triangle_wireframe( expected, v[0], v[i-1], v[i], linear_to_srgb( color ) );
+		draw_triangle_wireframe( expected, v[0], v[last], v[1], linear_to_srgb( color ) );
+
+		shape.draw_wireframe( actual, color, pl.rotation, pl.translation );
+
+		REQUIRE( 0 == std::memcmp( expected.get_surface_ptr(), actual.get_surface_ptr(), std::size_t(kWidth)*kHeight*4 ) );
+	}
+}
+
+TEST_CASE( "Fan wireframe draws each edge once", "[wireframe][fan][overdraw]" )
+{
+	if constexpr( !kOverdrawEnabled )
+		SKIP( "requires DRAW2D_CFG_OVERDRAW" );
+
+	auto const fan = make_fan_( 12, 80.f );
+	TriangleFan const shape( fan.verts.size(), fan.verts.data(), fan.colors.data() );
+
+	ColorF const color{ 1.f, 1.f, 1.f };
+
+	Surface surface( kWidth, kHeight );
+
+	for( auto const& pl : kPlacements_ )
+	{
+		CAPTURE( pl.translation.x, pl.translation.y );
+
+		// Writes of each spoke and each rim edge drawn on its own
+		auto const v = transform_( fan, pl.rotation, pl.translation );
+		auto const last = v.size()-1;
+
+		std::vector<std::pair<Vec2f, Vec2f>> edges;
+		for( std::size_t i = 1; i < v.size(); ++i )
+			edges.emplace_back( v[0], v[i] );
+		for( std::size_t i = 2; i < v.size(); ++i )
+			edges.emplace_back( v[i-1], v[i] );
+		edges.emplace_back( v[last], v[1] );
+
+		std::vector<std::uint64_t> expected( std::size_t(kWidth)*kHeight, 0 );
+		for( auto const& [a, b] : edges )
+		{
+			surface.clear();
+
+			OverdrawStats overdraw;
+			overdraw.begin_frame( surface );
+			draw_line_solid( surface, a, b, linear_to_srgb( color ) );
+			overdraw.end_frame();
+
+			add_writes_( expected, overdraw );
+		}
+
+		// The fan's wireframe
+		surface.clear();
+
+		OverdrawStats overdraw;
+		overdraw.begin_frame( surface );
+		shape.draw_wireframe( surface, color, pl.rotation, pl.translation );
+		overdraw.end_frame();
+
+		std::vector<std::uint64_t> actual( std::size_t(kWidth)*kHeight, 0 );
+		add_writes_( actual, overdraw );
+
+		REQUIRE( expected == actual );
+
+		// Sanity check: the edges were drawn at all
+		std::size_t covered = 0;
+		for( std::size_t i = 0; i < std::size_t(kWidth)*kHeight; ++i )
+			covered += written_( surface, i );
+		REQUIRE( covered > 0 );
+	}
+}
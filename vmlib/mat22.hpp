@@ -4,6 +4,7 @@
 #include <cmath>
 
 #include "vec2.hpp"
+#include "sincos.hpp"
 
 /** Mat22f : 2x2 matrix with floats
  *
@@ -44,13 +45,27 @@ constexpr Vec2f operator*(Mat22f const &aLeft, Vec2f const &aRight) noexcept
 
 // Functions:
 
-inline Mat22f make_rotation_2d(float aAngle) noexcept
+// Uses fast_sincos() (see sincos.hpp) rather than std::sin()/std::cos().
+constexpr Mat22f make_rotation_2d(float aAngle) noexcept
 {
-	float cosAngle = std::cos(aAngle);
-	float sinAngle = std::sin(aAngle);
+	auto const sc = fast_sincos(aAngle);
 	return Mat22f{
-		cosAngle, -sinAngle,
-		sinAngle, cosAngle};
+		sc.cos, -sc.sin,
+		sc.sin, sc.cos};
+}
+
+// Products of many rotation matrices slowly drift away from being a rotation
+// (rounding errors accumulate). This returns the rotation closest to aRot,
+// assuming that aRot is already close to one: the first column is normalized,
+// and the second column is rebuilt perpendicular to it.
+inline Mat22f orthonormalize_rotation_2d(Mat22f const &aRot) noexcept
+{
+	float const inv = 1.f / std::sqrt(aRot._00 * aRot._00 + aRot._10 * aRot._10);
+	float const c = aRot._00 * inv;
+	float const s = aRot._10 * inv;
+	return Mat22f{
+		c, -s,
+		s, c};
 }
 
 #endif // MAT22_HPP_1F974C02_D0D1_4FBD_B5EE_A69C88112088
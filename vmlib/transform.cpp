@@ -0,0 +1,147 @@
+#include "transform.hpp"
+
+#include <cassert>
+
+// The AVX version is compiled with a target attribute (GCC and clang on x86),
+// so the rest of vmlib only requires the baseline instruction set. It is used
+// only if the CPU supports AVX; otherwise, the SSE2 loop does all the work.
+#if (defined(__GNUC__) || defined(__clang__)) && (defined(__x86_64__) || defined(__i386__))
+#	define VMLIB_TRANSFORM_AVX_ 1
+#else
+#	define VMLIB_TRANSFORM_AVX_ 0
+#endif
+
+#if VMLIB_TRANSFORM_AVX_
+#	include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64)
+#	include <emmintrin.h>
+#elif defined(__ARM_NEON)
+#	include <arm_neon.h>
+#else
+#	include "vec2x.hpp"
+#endif
+
+// The points are stored interleaved (x0, y0, x1, y1, ...). A register holding
+// N points is transformed as
+//
+//   out = v * (m00, m11, ...) + swap(v) * (m01, m10, ...) + (tx, ty, ...)
+//
+// where swap() exchanges the x and y of each point. Per point, this computes
+// the same products and sums as operator*(Mat22f, Vec2f).
+
+#if VMLIB_TRANSFORM_AVX_
+namespace
+{
+	// Four points per iteration. Returns the number of points transformed.
+	__attribute__((target("avx")))
+	std::size_t transform_points_avx_( Mat22f const& aMatrix, Vec2f const& aTranslation, float const* aIn, float* aOut, std::size_t aCount ) noexcept
+	{
+		__m256 const diag = _mm256_setr_ps( aMatrix._00, aMatrix._11, aMatrix._00, aMatrix._11, aMatrix._00, aMatrix._11, aMatrix._00, aMatrix._11 );
+		__m256 const anti = _mm256_setr_ps( aMatrix._01, aMatrix._10, aMatrix._01, aMatrix._10, aMatrix._01, aMatrix._10, aMatrix._01, aMatrix._10 );
+		__m256 const trans = _mm256_setr_ps( aTranslation.x, aTranslation.y, aTranslation.x, aTranslation.y, aTranslation.x, aTranslation.y, aTranslation.x, aTranslation.y );
+
+		std::size_t i = 0;
+		for( ; i + 4 <= aCount; i += 4 )
+		{
+			__m256 const v = _mm256_loadu_ps( aIn + 2*i );
+			__m256 const s = _mm256_permute_ps( v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+
+			__m256 const r = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( v, diag ), _mm256_mul_ps( s, anti ) ), trans );
+			_mm256_storeu_ps( aOut + 2*i, r );
+		}
+
+		return i;
+	}
+
+	bool cpu_has_avx_() noexcept
+	{
+		__builtin_cpu_init();
+		return __builtin_cpu_supports( "avx" );
+	}
+}
+#endif // ~ VMLIB_TRANSFORM_AVX_
+
+void transform_points( Mat22f const& aMatrix, Vec2f const& aTranslation, std::span<Vec2f const> aIn, std::span<Vec2f> aOut ) noexcept
+{
+	assert( aOut.size() >= aIn.size() );
+
+	std::size_t const count = aIn.size();
+	float const* in = &aIn.data()->x;
+	float* out = &aOut.data()->x;
+
+	std::size_t i = 0;
+
+#	if VMLIB_TRANSFORM_AVX_
+	static bool const hasAvx = cpu_has_avx_();
+	if( hasAvx )
+		i = transform_points_avx_( aMatrix, aTranslation, in, out, count );
+#	endif // ~ VMLIB_TRANSFORM_AVX_
+
+#	if defined(__SSE2__) || defined(_M_X64)
+	__m128 const diag = _mm_setr_ps( aMatrix._00, aMatrix._11, aMatrix._00, aMatrix._11 );
+	__m128 const anti = _mm_setr_ps( aMatrix._01, aMatrix._10, aMatrix._01, aMatrix._10 );
+	__m128 const trans = _mm_setr_ps( aTranslation.x, aTranslation.y, aTranslation.x, aTranslation.y );
+
+	for( ; i + 2 <= count; i += 2 )
+	{
+		__m128 const v = _mm_loadu_ps( in + 2*i );
+		__m128 const s = _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 3, 0, 1 ) );
+
+		__m128 const r = _mm_add_ps( _mm_add_ps( _mm_mul_ps( v, diag ), _mm_mul_ps( s, anti ) ), trans );
+		_mm_storeu_ps( out + 2*i, r );
+	}
+#	elif defined(__ARM_NEON)
+	float const diagv[4] = { aMatrix._00, aMatrix._11, aMatrix._00, aMatrix._11 };
+	float const antiv[4] = { aMatrix._01, aMatrix._10, aMatrix._01, aMatrix._10 };
+	float const transv[4] = { aTranslation.x, aTranslation.y, aTranslation.x, aTranslation.y };
+
+	float32x4_t const diag = vld1q_f32( diagv );
+	float32x4_t const anti = vld1q_f32( antiv );
+	float32x4_t const trans = vld1q_f32( transv );
+
+	for( ; i + 2 <= count; i += 2 )
+	{
+		float32x4_t const v = vld1q_f32( in + 2*i );
+		float32x4_t const s = vrev64q_f32( v );
+
+		float32x4_t const r = vaddq_f32( vaddq_f32( vmulq_f32( v, diag ), vmulq_f32( s, anti ) ), trans );
+		vst1q_f32( out + 2*i, r );
+	}
+#	else
+	// Other targets: leave it to the compiler's auto-vectorizer
+	for( ; i + 4 <= count; i += 4 )
+		store( aMatrix * load<4>( aIn.data()+i ) + aTranslation, aOut.data()+i );
+#	endif
+
+	for( ; i < count; ++i )
+		aOut[i] = aMatrix * aIn[i] + aTranslation;
+}
+
+void make_rotations_2d( std::span<float const> aAngles, std::span<Mat22f> aOut ) noexcept
+{
+	assert( aOut.size() >= aAngles.size() );
+
+	std::size_t const count = aAngles.size();
+
+	// Blocks of kLanes angles with a fixed trip count vectorize; the tail is
+	// handled one angle at a time.
+	constexpr std::size_t kLanes = 8;
+
+	std::size_t i = 0;
+	for( ; i + kLanes <= count; i += kLanes )
+	{
+		float s[kLanes], c[kLanes];
+		for( std::size_t l = 0; l < kLanes; ++l )
+		{
+			auto const sc = fast_sincos( aAngles[i+l] );
+			s[l] = sc.sin;
+			c[l] = sc.cos;
+		}
+
+		for( std::size_t l = 0; l < kLanes; ++l )
+			aOut[i+l] = Mat22f{ c[l], -s[l], s[l], c[l] };
+	}
+
+	for( ; i < count; ++i )
+		aOut[i] = make_rotation_2d( aAngles[i] );
+}
@@ -0,0 +1,40 @@
+#ifndef TRANSFORM_HPP_40A903AB_608B_487A_A39F_B1728935DCC4
+#define TRANSFORM_HPP_40A903AB_608B_487A_A39F_B1728935DCC4
+
+#include <span>
+
+#include "vec2.hpp"
+#include "mat22.hpp"
+
+/* Transform an array of points:
+ *
+ *   aOut[i] = aMatrix * aIn[i] + aTranslation
+ *
+ * This is equivalent to transforming each point individually, but processes
+ * several points at once with SSE2 or NEON (whichever the target supports),
+ * or with AVX on x86 CPUs that support it. Results match the scalar operators
+ * exactly, unless the compiler contracts those into fused multiply-adds; then
+ * they differ in the last bit at most. aOut must have at least as many
+ * elements as aIn. The transform may be done in-place (aIn and aOut refer to
+ * the same array), but the arrays must not otherwise overlap.
+ */
+void transform_points(
+	Mat22f const& aMatrix,
+	Vec2f const& aTranslation,
+	std::span<Vec2f const> aIn,
+	std::span<Vec2f> aOut
+) noexcept;
+
+/* Build a rotation matrix for each angle (radians):
+ *
+ *   aOut[i] = make_rotation_2d( aAngles[i] )
+ *
+ * The loop over fast_sincos() is vectorized. aOut must have at least as many
+ * elements as aAngles.
+ */
+void make_rotations_2d(
+	std::span<float const> aAngles,
+	std::span<Mat22f> aOut
+) noexcept;
+
+#endif // TRANSFORM_HPP_40A903AB_608B_487A_A39F_B1728935DCC4
@@ -0,0 +1,269 @@
+#ifndef VEC2X_HPP_0D86DA24_4026_4C31_AA06_3A15E6F5E5C0
+#define VEC2X_HPP_0D86DA24_4026_4C31_AA06_3A15E6F5E5C0
+
+#include <array>
+
+#include <cmath>
+#include <cstdlib>
+
+#include "vec2.hpp"
+#include "mat22.hpp"
+
+/** Vec2fxN : tLanes 2D vectors with floats, stored as a structure of arrays
+ *
+ * Vec2fxN holds several Vec2fs, with all x components in one array and all y
+ * components in another. It supports the same operators as Vec2f; each
+ * operation applies to all lanes. Scalars, Vec2fs and Mat22fs are broadcast
+ * to all lanes.
+ *
+ * The operations are plain loops over the lanes. They are constexpr (and can
+ * thus be used and tested at compile time), and the loops have a fixed trip
+ * count that the compiler maps to vector instructions (SSE/AVX/NEON, with
+ * tLanes = 4 or 8) without any intrinsics. This keeps raw intrinsics out of
+ * the code that uses these types.
+ *
+ * Example: move eight particles stored as separate x and y arrays
+ *   Vec2fx8 p = load_soa<8>( xs+i, ys+i );
+ *   p += delta; // Vec2f delta
+ *   store_soa( p, xs+i, ys+i );
+ */
+template< std::size_t tLanes >
+struct Vec2fxN
+{
+	static constexpr std::size_t kLanes = tLanes;
+
+	alignas(sizeof(float)*tLanes) float x[tLanes];
+	alignas(sizeof(float)*tLanes) float y[tLanes];
+};
+
+using Vec2fx4 = Vec2fxN<4>;
+using Vec2fx8 = Vec2fxN<8>;
+
+
+// Construction, loads and stores:
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> broadcast( Vec2f aVec ) noexcept
+{
+	Vec2fxN<tLanes> ret;
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		ret.x[i] = aVec.x;
+		ret.y[i] = aVec.y;
+	}
+	return ret;
+}
+
+// Load tLanes consecutive Vec2fs (x0, y0, x1, y1, ...)
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> load( Vec2f const* aVecs ) noexcept
+{
+	Vec2fxN<tLanes> ret;
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		ret.x[i] = aVecs[i].x;
+		ret.y[i] = aVecs[i].y;
+	}
+	return ret;
+}
+
+// Load tLanes consecutive x and y components from separate arrays
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> load_soa( float const* aXs, float const* aYs ) noexcept
+{
+	Vec2fxN<tLanes> ret;
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		ret.x[i] = aXs[i];
+		ret.y[i] = aYs[i];
+	}
+	return ret;
+}
+
+template< std::size_t tLanes > constexpr
+void store( Vec2fxN<tLanes> const& aVec, Vec2f* aOut ) noexcept
+{
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		aOut[i].x = aVec.x[i];
+		aOut[i].y = aVec.y[i];
+	}
+}
+
+template< std::size_t tLanes > constexpr
+void store_soa( Vec2fxN<tLanes> const& aVec, float* aXs, float* aYs ) noexcept
+{
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		aXs[i] = aVec.x[i];
+		aYs[i] = aVec.y[i];
+	}
+}
+
+template< std::size_t tLanes > constexpr
+Vec2f lane( Vec2fxN<tLanes> const& aVec, std::size_t aLane ) noexcept
+{
+	return Vec2f{ aVec.x[aLane], aVec.y[aLane] };
+}
+
+
+// Operators, matching the ones for Vec2f:
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator+( Vec2fxN<tLanes> const& aVec ) noexcept
+{
+	return aVec;
+}
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator-( Vec2fxN<tLanes> const& aVec ) noexcept
+{
+	Vec2fxN<tLanes> ret;
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		ret.x[i] = -aVec.x[i];
+		ret.y[i] = -aVec.y[i];
+	}
+	return ret;
+}
+
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes>& operator+=( Vec2fxN<tLanes>& aLeft, Vec2fxN<tLanes> const& aRight ) noexcept
+{
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		aLeft.x[i] += aRight.x[i];
+		aLeft.y[i] += aRight.y[i];
+	}
+	return aLeft;
+}
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes>& operator-=( Vec2fxN<tLanes>& aLeft, Vec2fxN<tLanes> const& aRight ) noexcept
+{
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		aLeft.x[i] -= aRight.x[i];
+		aLeft.y[i] -= aRight.y[i];
+	}
+	return aLeft;
+}
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes>& operator+=( Vec2fxN<tLanes>& aLeft, Vec2f aRight ) noexcept
+{
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		aLeft.x[i] += aRight.x;
+		aLeft.y[i] += aRight.y;
+	}
+	return aLeft;
+}
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes>& operator-=( Vec2fxN<tLanes>& aLeft, Vec2f aRight ) noexcept
+{
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		aLeft.x[i] -= aRight.x;
+		aLeft.y[i] -= aRight.y;
+	}
+	return aLeft;
+}
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes>& operator*=( Vec2fxN<tLanes>& aLeft, float aRight ) noexcept
+{
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		aLeft.x[i] *= aRight;
+		aLeft.y[i] *= aRight;
+	}
+	return aLeft;
+}
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes>& operator/=( Vec2fxN<tLanes>& aLeft, float aRight ) noexcept
+{
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		aLeft.x[i] /= aRight;
+		aLeft.y[i] /= aRight;
+	}
+	return aLeft;
+}
+
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator+( Vec2fxN<tLanes> aLeft, Vec2fxN<tLanes> const& aRight ) noexcept
+{
+	return aLeft += aRight;
+}
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator-( Vec2fxN<tLanes> aLeft, Vec2fxN<tLanes> const& aRight ) noexcept
+{
+	return aLeft -= aRight;
+}
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator+( Vec2fxN<tLanes> aLeft, Vec2f aRight ) noexcept
+{
+	return aLeft += aRight;
+}
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator-( Vec2fxN<tLanes> aLeft, Vec2f aRight ) noexcept
+{
+	return aLeft -= aRight;
+}
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator*( float aScalar, Vec2fxN<tLanes> aVec ) noexcept
+{
+	return aVec *= aScalar;
+}
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator*( Vec2fxN<tLanes> aVec, float aScalar ) noexcept
+{
+	return aVec *= aScalar;
+}
+
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator/( Vec2fxN<tLanes> aVec, float aScalar ) noexcept
+{
+	return aVec /= aScalar;
+}
+
+
+// Mat22f, broadcast to all lanes. Per lane, this is the same computation as
+// operator*( Mat22f, Vec2f ).
+template< std::size_t tLanes > constexpr
+Vec2fxN<tLanes> operator*( Mat22f const& aLeft, Vec2fxN<tLanes> const& aRight ) noexcept
+{
+	Vec2fxN<tLanes> ret;
+	for( std::size_t i = 0; i < tLanes; ++i )
+	{
+		ret.x[i] = aLeft._00 * aRight.x[i] + aLeft._01 * aRight.y[i];
+		ret.y[i] = aLeft._10 * aRight.x[i] + aLeft._11 * aRight.y[i];
+	}
+	return ret;
+}
+
+
+// A few common functions. These return one result per lane.
+
+template< std::size_t tLanes > constexpr
+std::array<float,tLanes> dot( Vec2fxN<tLanes> const& aLeft, Vec2fxN<tLanes> const& aRight ) noexcept
+{
+	std::array<float,tLanes> ret{};
+	for( std::size_t i = 0; i < tLanes; ++i )
+		ret[i] = aLeft.x[i] * aRight.x[i] + aLeft.y[i] * aRight.y[i];
+	return ret;
+}
+
+template< std::size_t tLanes > inline
+std::array<float,tLanes> length( Vec2fxN<tLanes> const& aVec ) noexcept
+{
+	auto ret = dot( aVec, aVec );
+	for( auto& r : ret )
+		r = std::sqrt( r );
+	return ret;
+}
+
+#endif // VEC2X_HPP_0D86DA24_4026_4C31_AA06_3A15E6F5E5C0